@@ -0,0 +1,9 @@
+DELETE FROM `acore_string` WHERE `entry` BETWEEN 90136 AND 90142;
+INSERT INTO `acore_string` (`entry`, `content_default`) VALUES
+(90136, 'Your group already has a pending Trial of Finality confirmation.'),
+(90137, 'There is no pending trial confirmation for your group.'),
+(90138, 'The trial proposal timed out before enough group members accepted.'),
+(90139, 'The trial has started without your confirmation.'),
+(90140, 'You have already answered this trial proposal.'),
+(90141, 'Usage: /trialconfirm yes|no'),
+(90142, 'The trial proposal has been cancelled.');
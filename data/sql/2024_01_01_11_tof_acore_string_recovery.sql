@@ -0,0 +1,4 @@
+DELETE FROM `acore_string` WHERE `entry` IN (90144, 90145);
+INSERT INTO `acore_string` (`entry`, `content_default`) VALUES
+(90144, 'The Trial of Finality was interrupted. The current wave restarts once your group has returned.'),
+(90145, 'The Trial of Finality was interrupted before it could continue. You have been returned with nothing gained or lost.');
@@ -0,0 +1,10 @@
+DELETE FROM `acore_string` WHERE `entry` BETWEEN 90146 AND 90153;
+INSERT INTO `acore_string` (`entry`, `content_default`) VALUES
+(90146, 'You are now spectating the Trial of Finality. Nobody can see you. Type /trialspectate leave to return.'),
+(90147, 'You stop spectating the Trial of Finality.'),
+(90148, 'Usage: /trialspectate <participant name> or /trialspectate leave'),
+(90149, 'That player is not taking part in a running Trial of Finality.'),
+(90150, 'That Trial of Finality already has as many spectators as it allows.'),
+(90151, 'You cannot spectate while in combat, inside a dungeon, or taking part in a trial.'),
+(90152, 'You are not spectating a Trial of Finality.'),
+(90153, 'You are already spectating a Trial of Finality. Type /trialspectate leave first.');
@@ -0,0 +1,8 @@
+CREATE TABLE IF NOT EXISTS `character_trial_finality_status_log` (
+  `version` BIGINT UNSIGNED NOT NULL AUTO_INCREMENT COMMENT 'Monotonic change number; worldservers poll for versions above their cursor',
+  `guid` INT UNSIGNED NOT NULL COMMENT 'Character GUID',
+  `is_perma_failed` TINYINT(1) NOT NULL COMMENT 'Status after this change',
+  `changed_at` TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP,
+  PRIMARY KEY (`version`),
+  KEY `idx_changed_at` (`changed_at`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COMMENT='Change feed for character_trial_finality_status, written in the same transaction as the status row';
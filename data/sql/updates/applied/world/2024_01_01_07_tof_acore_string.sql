@@ -0,0 +1,37 @@
+DELETE FROM `acore_string` WHERE `entry` BETWEEN 90100 AND 90135;
+INSERT INTO `acore_string` (`entry`, `content_default`) VALUES
+(90100, 'The wave is over! You have survived... for now.'),
+(90101, 'The Trial of Finality has begun!'),
+(90102, 'You have been defeated! You must be resurrected before the wave ends to avoid permanent failure!'),
+(90103, 'You have been resurrected! Your fate is no longer sealed... for now.'),
+(90104, 'The trial has ended in failure. Your fate is sealed.'),
+(90105, 'The Trial of Finality has concluded. You are being teleported out.'),
+(90106, 'You have been granted a new title!'),
+(90107, 'WARNING: You have left the trial arena! Return immediately or you will forfeit the trial for your entire group!'),
+(90108, 'The vote to forfeit the trial has failed to pass in time and is now cancelled.'),
+(90109, 'You have already voted to forfeit.'),
+(90110, 'There are no active players to vote.'),
+(90111, 'You can only use this command inside the Trial of Finality.'),
+(90112, 'The Trial of Finality module is currently disabled.'),
+(90113, 'You must be in a group to start the trial.'),
+(90114, 'Only the group leader can initiate the trial.'),
+(90115, 'Could not start the trial. Unable to determine the group''s highest level.'),
+(90116, 'An error occurred while preparing the trial arena. Please try again later.'),
+(90120, 'Let the trial commence! Your first challenge awaits!'),
+(90121, 'The first wave approaches! Show them your might!'),
+(90122, 'Prove your worth, contenders! The trial begins!'),
+(90123, 'A commendable start! But can you withstand the second wave?'),
+(90124, 'Do not falter! The next wave is upon you!'),
+(90125, 'Impressive... but the trial has just begun.'),
+(90126, 'You show promise. Now, face a greater challenge!'),
+(90127, 'The third wave will test your resolve!'),
+(90128, 'Halfway there... or halfway to your doom?'),
+(90129, 'Only the strongest may proceed! The fourth wave descends!'),
+(90130, 'Your victory is within reach! Do not let it slip away!'),
+(90131, 'Feel the rising intensity? The end is near!'),
+(90132, 'The final wave! Your destiny is at hand!'),
+(90133, 'This is the ultimate test! Conquer them and achieve glory!'),
+(90134, 'Everything you have fought for comes to this! Annihilate them!'),
+(90135, 'Brave contenders, prepare yourselves! The next wave approaches!');
+-- Notes: entries 90100-90135 are reserved for the Trial of Finality (TrialStrings in the module source).
+-- Translations go into the content_loc1..content_loc8 columns; the module prebuilds a packet per locale at startup.
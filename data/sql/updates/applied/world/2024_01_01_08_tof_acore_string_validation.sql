@@ -0,0 +1,4 @@
+DELETE FROM `acore_string` WHERE `entry` IN (90117, 90118);
+INSERT INTO `acore_string` (`entry`, `content_default`) VALUES
+(90117, 'Your group is already being checked for the trial. Please wait a moment.'),
+(90118, 'Fateweaver Arithos is no longer nearby. Speak to him again to start the trial.');
@@ -0,0 +1,3 @@
+DELETE FROM `acore_string` WHERE `entry` = 90143;
+INSERT INTO `acore_string` (`entry`, `content_default`) VALUES
+(90143, 'Waiting for the rest of your group to arrive. The trial begins once everyone is here.');
@@ -0,0 +1,14 @@
+CREATE TABLE IF NOT EXISTS `trial_of_finality_leaderboard` (
+  `metric` TINYINT UNSIGNED NOT NULL COMMENT '0 = fastest clear, 1 = most waves',
+  `scope` TINYINT UNSIGNED NOT NULL COMMENT '0 = overall, 1 = class, 2 = level band',
+  `scope_key` SMALLINT UNSIGNED NOT NULL COMMENT 'Class ID, or the minimum level of the level band; 0 for overall',
+  `position` TINYINT UNSIGNED NOT NULL COMMENT '1 = best',
+  `player_guid` INT UNSIGNED NOT NULL COMMENT 'Character GUID',
+  `player_name` VARCHAR(12) NOT NULL,
+  `class` TINYINT UNSIGNED NOT NULL,
+  `level` TINYINT UNSIGNED NOT NULL,
+  `waves` TINYINT UNSIGNED NOT NULL COMMENT 'Waves cleared',
+  `duration_ms` INT UNSIGNED NOT NULL COMMENT 'Time from the first wave to the outcome',
+  `achieved_at` INT UNSIGNED NOT NULL COMMENT 'Unix time',
+  PRIMARY KEY (`metric`, `scope`, `scope_key`, `position`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COMMENT='Snapshot of the Trial of Finality leaderboards, rewritten periodically by the worldserver';
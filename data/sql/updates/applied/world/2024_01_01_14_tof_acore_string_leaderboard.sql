@@ -0,0 +1,5 @@
+DELETE FROM `acore_string` WHERE `entry` BETWEEN 90154 AND 90156;
+INSERT INTO `acore_string` (`entry`, `content_default`) VALUES
+(90154, 'Trial of Finality leaderboards are disabled.'),
+(90155, 'No one has earned a place on this leaderboard yet.'),
+(90156, 'Usage: .trial top [fastest|waves] [class name|level]');
@@ -0,0 +1,22 @@
+DELETE FROM `acore_string` WHERE `entry` BETWEEN 90157 AND 90175;
+INSERT INTO `acore_string` (`entry`, `content_default`) VALUES
+(90157, 'You have been awarded %u gold for your victory!'),
+(90158, '%s has initiated a vote to forfeit! Type `/trialforfeit` to agree. (1/%u votes)'),
+(90159, '%s has also voted to forfeit. (%u/%u votes)'),
+(90160, 'Your group member %s is too far away from Fateweaver Arithos.'),
+(90161, 'Playerbot %s is permitted in the trial due to GM debug settings.'),
+(90162, 'Playerbots like %s are not permitted in the Trial of Finality.'),
+(90163, 'Your group member %s already possesses a Trial Token and cannot start a new trial.'),
+(90164, 'Your group is too small. You need at least %u members to attempt the trial.'),
+(90165, 'Your group is too large. You can have at most %u members to attempt the trial.'),
+(90166, 'The level difference in your group is too high. The maximum allowed difference is %u levels.'),
+(90167, 'The Trial of Finality has no challengers prepared for a group of level %u.'),
+(90168, 'A member of your group, %s, has already had their fate sealed and cannot enter the trial again.'),
+(90169, 'You have proposed the Trial of Finality. Waiting for %u group members to respond (%u seconds).'),
+(90170, '%s proposes the Trial of Finality. Accept in the window that opened, or type /trialconfirm yes or /trialconfirm no within %u seconds.'),
+(90171, '%s has accepted the Trial of Finality. (%u/%u responded)'),
+(90172, '%s has declined the Trial of Finality. (%u/%u responded)'),
+(90173, 'Your Trial of Finality perma-death status (DB) has been reset by a GM.'),
+(90174, 'Your Trial Token has been removed by a GM.'),
+(90175, 'Your Trial of Finality perma-death aura (if present) has been removed by a GM.');
+-- Notes: these texts carry printf-style arguments; translations must keep the same %s/%u sequence.
@@ -0,0 +1,5 @@
+ALTER TABLE `trial_of_finality_leaderboard`
+  DROP PRIMARY KEY,
+  DROP COLUMN `position`,
+  ADD PRIMARY KEY (`metric`, `scope`, `scope_key`, `player_guid`),
+  COMMENT='Best result of each character on each Trial of Finality leaderboard, upserted by every worldserver';
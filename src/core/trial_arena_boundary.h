@@ -0,0 +1,289 @@
+/*
+ * Trial of Finality arena boundary: classification of positions against the configured arena shapes.
+ * Part of the core library; no AzerothCore dependency.
+ */
+
+#ifndef TRIAL_ARENA_BOUNDARY_H
+#define TRIAL_ARENA_BOUNDARY_H
+
+#include "trial_core_types.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace ModTrialOfFinality
+{
+
+// --- Arena Boundary ---
+// The arena is a union of circles and polygons with an optional Z range. Shapes are compiled at load
+// into a uniform grid: most cells resolve to a zone directly, and the rest only list the shapes near
+// them. Classify() never takes a square root; circles compare squared distances against precomputed
+// squared radii and polygons compare the squared distance to their nearest edge.
+enum TrialBoundaryZone : uint8
+{
+    BOUNDARY_ZONE_INSIDE = 0,   // Inside the arena by more than the hysteresis margin
+    BOUNDARY_ZONE_EDGE,         // Within the hysteresis margin of the boundary, on either side
+    BOUNDARY_ZONE_WARNING,      // Outside the arena, but within the fail distance
+    BOUNDARY_ZONE_FAIL          // Beyond the fail distance
+};
+
+class TrialArenaBoundary
+{
+public:
+    struct Point { float X, Y; };
+
+    void Clear()
+    {
+        _circles.clear();
+        _polygons.clear();
+        _cells.clear();
+        _cellShapes.clear();
+        _hasZRange = false;
+    }
+
+    void AddCircle(float x, float y, float radius)
+    {
+        CompiledCircle circle;
+        circle.X = x;
+        circle.Y = y;
+        circle.Radius = radius;
+        _circles.push_back(circle);
+    }
+
+    bool AddPolygon(const std::vector<Point>& points)
+    {
+        if (points.size() < 3)
+            return false;
+        CompiledPolygon polygon;
+        polygon.Points = points;
+        _polygons.push_back(std::move(polygon));
+        return true;
+    }
+
+    void SetZRange(float minZ, float maxZ)
+    {
+        _hasZRange = true;
+        _minZ = std::min(minZ, maxZ);
+        _maxZ = std::max(minZ, maxZ);
+    }
+
+    bool IsEmpty() const { return _circles.empty() && _polygons.empty(); }
+    size_t GetShapeCount() const { return _circles.size() + _polygons.size(); }
+    size_t GetCellCount() const { return _cells.size(); }
+
+    void Compile(float hysteresis, float failDistance, float cellSize)
+    {
+        _hysteresis = std::max(0.0f, hysteresis);
+        _failDistance = std::max(_hysteresis, failDistance);
+        _hysteresisSq = _hysteresis * _hysteresis;
+        _failDistanceSq = _failDistance * _failDistance;
+        _cells.clear();
+        _cellShapes.clear();
+        if (IsEmpty())
+            return;
+
+        float minX = std::numeric_limits<float>::max(), minY = minX;
+        float maxX = std::numeric_limits<float>::lowest(), maxY = maxX;
+        for (CompiledCircle& circle : _circles)
+        {
+            float inner = std::max(0.0f, circle.Radius - _hysteresis);
+            circle.InnerSq = inner * inner;
+            circle.EdgeSq = (circle.Radius + _hysteresis) * (circle.Radius + _hysteresis);
+            circle.FailSq = (circle.Radius + _failDistance) * (circle.Radius + _failDistance);
+            minX = std::min(minX, circle.X - circle.Radius);
+            maxX = std::max(maxX, circle.X + circle.Radius);
+            minY = std::min(minY, circle.Y - circle.Radius);
+            maxY = std::max(maxY, circle.Y + circle.Radius);
+        }
+        for (CompiledPolygon& polygon : _polygons)
+        {
+            polygon.MinX = polygon.MaxX = polygon.Points[0].X;
+            polygon.MinY = polygon.MaxY = polygon.Points[0].Y;
+            for (const Point& point : polygon.Points)
+            {
+                polygon.MinX = std::min(polygon.MinX, point.X);
+                polygon.MaxX = std::max(polygon.MaxX, point.X);
+                polygon.MinY = std::min(polygon.MinY, point.Y);
+                polygon.MaxY = std::max(polygon.MaxY, point.Y);
+            }
+            minX = std::min(minX, polygon.MinX);
+            maxX = std::max(maxX, polygon.MaxX);
+            minY = std::min(minY, polygon.MinY);
+            maxY = std::max(maxY, polygon.MaxY);
+        }
+
+        // Everything beyond the fail distance of the union's bounding box is FAIL without a lookup.
+        _originX = minX - _failDistance;
+        _originY = minY - _failDistance;
+        float width = (maxX - minX) + 2.0f * _failDistance;
+        float height = (maxY - minY) + 2.0f * _failDistance;
+        _cellSize = std::max(1.0f, cellSize);
+        while ((width / _cellSize) * (height / _cellSize) > MAX_CELLS)
+            _cellSize *= 2.0f;
+        _cellsX = uint32(width / _cellSize) + 1;
+        _cellsY = uint32(height / _cellSize) + 1;
+        _cells.resize(_cellsX * _cellsY);
+
+        // Signed distance is 1-Lipschitz, so a value at the cell centre bounds the whole cell within
+        // half a diagonal. Cells that are clearly inside one shape, or clearly beyond every shape's fail
+        // distance, store their zone directly; the others keep the shapes that can still matter.
+        float halfDiagonal = _cellSize * 0.70711f;
+        size_t shapeCount = GetShapeCount();
+        for (uint32 cy = 0; cy < _cellsY; ++cy)
+        {
+            for (uint32 cx = 0; cx < _cellsX; ++cx)
+            {
+                Cell& cell = _cells[cy * _cellsX + cx];
+                float centreX = _originX + (cx + 0.5f) * _cellSize;
+                float centreY = _originY + (cy + 0.5f) * _cellSize;
+                cell.FirstShape = _cellShapes.size();
+                for (size_t shape = 0; shape < shapeCount; ++shape)
+                {
+                    float distance = SignedDistance(shape, centreX, centreY);
+                    if (distance < -(_hysteresis + halfDiagonal))
+                    {
+                        cell.Uniform = BOUNDARY_ZONE_INSIDE;
+                        cell.ShapeCount = 0;
+                        _cellShapes.resize(cell.FirstShape);
+                        break;
+                    }
+                    if (distance <= _failDistance + halfDiagonal)
+                    {
+                        _cellShapes.push_back(uint16(shape));
+                        ++cell.ShapeCount;
+                    }
+                }
+            }
+        }
+    }
+
+    TrialBoundaryZone Classify(float x, float y, float z) const
+    {
+        TrialBoundaryZone zoneZ = ClassifyZ(z);
+        if (zoneZ == BOUNDARY_ZONE_FAIL || _cells.empty())
+            return BOUNDARY_ZONE_FAIL;
+
+        float fx = (x - _originX) / _cellSize;
+        float fy = (y - _originY) / _cellSize;
+        if (fx < 0.0f || fy < 0.0f || fx >= float(_cellsX) || fy >= float(_cellsY))
+            return BOUNDARY_ZONE_FAIL;
+
+        const Cell& cell = _cells[uint32(fy) * _cellsX + uint32(fx)];
+        TrialBoundaryZone zone = cell.Uniform;
+        for (uint32 i = 0; i < cell.ShapeCount && zone != BOUNDARY_ZONE_INSIDE; ++i)
+        {
+            uint16 shape = _cellShapes[cell.FirstShape + i];
+            TrialBoundaryZone shapeZone = shape < _circles.size() ? ClassifyCircle(_circles[shape], x, y)
+                : ClassifyPolygon(_polygons[shape - _circles.size()], x, y);
+            zone = std::min(zone, shapeZone);
+        }
+        return std::max(zone, zoneZ);
+    }
+
+private:
+    static constexpr float MAX_CELLS = 65536.0f;
+
+    struct CompiledCircle
+    {
+        float X = 0.0f, Y = 0.0f, Radius = 0.0f;
+        float InnerSq = 0.0f, EdgeSq = 0.0f, FailSq = 0.0f;
+    };
+
+    struct CompiledPolygon
+    {
+        std::vector<Point> Points;
+        float MinX = 0.0f, MinY = 0.0f, MaxX = 0.0f, MaxY = 0.0f;
+    };
+
+    struct Cell
+    {
+        TrialBoundaryZone Uniform = BOUNDARY_ZONE_FAIL; // Zone when no listed shape does better
+        uint32 FirstShape = 0;
+        uint32 ShapeCount = 0;
+    };
+
+    TrialBoundaryZone ClassifyCircle(const CompiledCircle& circle, float x, float y) const
+    {
+        float dx = x - circle.X;
+        float dy = y - circle.Y;
+        float distSq = dx * dx + dy * dy;
+        if (distSq < circle.InnerSq) return BOUNDARY_ZONE_INSIDE;
+        if (distSq <= circle.EdgeSq) return BOUNDARY_ZONE_EDGE;
+        if (distSq <= circle.FailSq) return BOUNDARY_ZONE_WARNING;
+        return BOUNDARY_ZONE_FAIL;
+    }
+
+    TrialBoundaryZone ClassifyPolygon(const CompiledPolygon& polygon, float x, float y) const
+    {
+        bool inside = false;
+        float edgeDistSq = PolygonEdgeDistanceSq(polygon, x, y, inside);
+        if (inside)
+            return edgeDistSq > _hysteresisSq ? BOUNDARY_ZONE_INSIDE : BOUNDARY_ZONE_EDGE;
+        if (edgeDistSq <= _hysteresisSq) return BOUNDARY_ZONE_EDGE;
+        if (edgeDistSq <= _failDistanceSq) return BOUNDARY_ZONE_WARNING;
+        return BOUNDARY_ZONE_FAIL;
+    }
+
+    TrialBoundaryZone ClassifyZ(float z) const
+    {
+        if (!_hasZRange)
+            return BOUNDARY_ZONE_INSIDE;
+        float outside = std::max(_minZ - z, z - _maxZ); // Negative while within the range
+        if (outside < -_hysteresis) return BOUNDARY_ZONE_INSIDE;
+        if (outside <= _hysteresis) return BOUNDARY_ZONE_EDGE;
+        if (outside <= _failDistance) return BOUNDARY_ZONE_WARNING;
+        return BOUNDARY_ZONE_FAIL;
+    }
+
+    // Squared distance to the nearest edge, with an even-odd inside test done in the same pass.
+    static float PolygonEdgeDistanceSq(const CompiledPolygon& polygon, float x, float y, bool& inside)
+    {
+        float best = std::numeric_limits<float>::max();
+        const std::vector<Point>& points = polygon.Points;
+        for (size_t i = 0, j = points.size() - 1; i < points.size(); j = i++)
+        {
+            const Point& a = points[j];
+            const Point& b = points[i];
+            if ((b.Y > y) != (a.Y > y) && x < (a.X - b.X) * (y - b.Y) / (a.Y - b.Y) + b.X)
+                inside = !inside;
+
+            float ex = b.X - a.X, ey = b.Y - a.Y;
+            float px = x - a.X, py = y - a.Y;
+            float lengthSq = ex * ex + ey * ey;
+            float t = lengthSq > 0.0f ? std::clamp((px * ex + py * ey) / lengthSq, 0.0f, 1.0f) : 0.0f;
+            float dx = px - t * ex, dy = py - t * ey;
+            best = std::min(best, dx * dx + dy * dy);
+        }
+        return best;
+    }
+
+    // Exact signed distance (negative inside); only used while compiling the grid.
+    float SignedDistance(size_t shape, float x, float y) const
+    {
+        if (shape < _circles.size())
+        {
+            const CompiledCircle& circle = _circles[shape];
+            return std::sqrt((x - circle.X) * (x - circle.X) + (y - circle.Y) * (y - circle.Y)) - circle.Radius;
+        }
+        bool inside = false;
+        float distance = std::sqrt(PolygonEdgeDistanceSq(_polygons[shape - _circles.size()], x, y, inside));
+        return inside ? -distance : distance;
+    }
+
+    std::vector<CompiledCircle> _circles;
+    std::vector<CompiledPolygon> _polygons;
+    std::vector<Cell> _cells;
+    std::vector<uint16> _cellShapes;
+    float _originX = 0.0f, _originY = 0.0f, _cellSize = 8.0f;
+    uint32 _cellsX = 0, _cellsY = 0;
+    float _hysteresis = 0.0f, _failDistance = 0.0f;
+    float _hysteresisSq = 0.0f, _failDistanceSq = 0.0f;
+    bool _hasZRange = false;
+    float _minZ = 0.0f, _maxZ = 0.0f;
+};
+
+} // namespace ModTrialOfFinality
+
+#endif // TRIAL_ARENA_BOUNDARY_H
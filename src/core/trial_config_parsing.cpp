@@ -0,0 +1,402 @@
+#include "trial_config_parsing.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+
+namespace ModTrialOfFinality
+{
+
+static bool IsSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+}
+
+static bool IsDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// " at column N" for a 0-based position; columns are 1-based as in an editor.
+static std::string At(size_t position)
+{
+    return " at column " + std::to_string(position + 1);
+}
+
+// The trimmed text between two positions of a tokenizer started at origin, for messages.
+static std::string Slice(std::string_view text, size_t origin, size_t from, size_t to)
+{
+    std::string_view slice = text.substr(from - origin, to - from);
+    while (!slice.empty() && IsSpace(slice.front()))
+        slice.remove_prefix(1);
+    while (!slice.empty() && IsSpace(slice.back()))
+        slice.remove_suffix(1);
+    return std::string(slice);
+}
+
+bool TrialParseReport::HasErrors() const
+{
+    for (const TrialParseMessage& message : Messages)
+        if (message.Error)
+            return true;
+    return false;
+}
+
+// --- TrialListTokenizer ---
+void TrialListTokenizer::SkipSpace()
+{
+    while (_pos < _text.size() && IsSpace(_text[_pos]))
+        ++_pos;
+}
+
+bool TrialListTokenizer::AtEnd()
+{
+    SkipSpace();
+    return _pos >= _text.size();
+}
+
+char TrialListTokenizer::Peek()
+{
+    SkipSpace();
+    return _pos < _text.size() ? _text[_pos] : '\0';
+}
+
+bool TrialListTokenizer::Consume(char c)
+{
+    SkipSpace();
+    if (_pos >= _text.size() || _text[_pos] != c)
+        return false;
+    ++_pos;
+    return true;
+}
+
+bool TrialListTokenizer::ReadUInt(uint32& value)
+{
+    SkipSpace();
+    _outOfRange = false;
+    const char* first = _text.data() + _pos;
+    const char* last = _text.data() + _text.size();
+    if (first == last || !IsDigit(*first))
+        return false;
+
+    std::from_chars_result result = std::from_chars(first, last, value);
+    if (result.ec == std::errc::result_out_of_range)
+    {
+        _outOfRange = true;
+        _pos += result.ptr - first;
+        return false;
+    }
+    if (result.ec != std::errc())
+        return false;
+    _pos += result.ptr - first;
+    return true;
+}
+
+bool TrialListTokenizer::ReadFloat(float& value)
+{
+    SkipSpace();
+    _outOfRange = false;
+    const char* first = _text.data() + _pos;
+    const char* last = _text.data() + _text.size();
+    const char* number = first;
+    if (number != last && *number == '+')
+        ++number;
+    // Only plain decimals: from_chars would also take "inf" and "nan", and a '+' must not precede a sign.
+    if (number == last || !(IsDigit(*number) || *number == '.' || (*number == '-' && number == first)))
+        return false;
+
+    std::from_chars_result result = std::from_chars(number, last, value, std::chars_format::general);
+    if (result.ec == std::errc::result_out_of_range)
+    {
+        _outOfRange = true;
+        _pos += result.ptr - first;
+        return false;
+    }
+    if (result.ec != std::errc() || !std::isfinite(value))
+        return false;
+    _pos += result.ptr - first;
+    return true;
+}
+
+void TrialListTokenizer::SkipTo(std::string_view stops)
+{
+    while (_pos < _text.size() && stops.find(_text[_pos]) == std::string_view::npos)
+        ++_pos;
+}
+
+// --- Parsers ---
+TrialNpcPool ParseNpcPoolString(std::string_view poolStr, const std::string& poolName,
+    const std::function<bool(uint32)>& creatureExists, TrialParseReport& report)
+{
+    TrialNpcPool pool;
+    TrialListTokenizer tokenizer(poolStr);
+    if (tokenizer.AtEnd()) {
+        report.Warning("NPC Pool '" + poolName + "' is empty or not found in configuration.");
+        return pool;
+    }
+
+    const std::string where = " in NPC Pool '" + poolName + "'";
+    std::vector<uint32> currentGroup;
+    bool inGroup = false;
+    size_t groupStart = 0;
+    bool expectEntry = true; // At the start of the list or of a group, or after a comma
+
+    while (!tokenizer.AtEnd()) {
+        size_t at = tokenizer.Position();
+        char c = tokenizer.Peek();
+
+        if (IsDigit(c)) {
+            if (!expectEntry) {
+                report.Error("Missing comma" + where + At(at) + ". Aborting parse.", at);
+                return {};
+            }
+            expectEntry = false;
+
+            uint32 id = 0;
+            if (!tokenizer.ReadUInt(id)) {
+                report.Error("Creature ID '" + Slice(poolStr, 0, at, tokenizer.Position()) + "'" + where + At(at) + " is out of range.", at);
+                report.InvalidCount++;
+                continue;
+            }
+            if (id == 0) {
+                report.Error("Creature ID 0 is invalid" + where + At(at) + ".", at);
+                report.InvalidCount++;
+                continue;
+            }
+            if (creatureExists && !creatureExists(id)) {
+                report.Error("Creature ID " + std::to_string(id) + where + At(at) + " does not exist. Skipping.", at);
+                report.InvalidCount++;
+                continue;
+            }
+
+            if (inGroup)
+                currentGroup.push_back(id);
+            else
+                pool.push_back({ id });
+            report.EntryCount++;
+            continue;
+        }
+
+        tokenizer.Consume(c);
+        if (c == ',') {
+            if (expectEntry && inGroup) { // e.g. (,1) or (1,,2)
+                report.Error("Malformed group" + where + At(at) + " (e.g., empty entry or trailing comma).", at);
+                report.InvalidCount++;
+            }
+            expectEntry = true;
+        } else if (c == '(') {
+            if (inGroup) {
+                report.Error("Nested parentheses are not allowed" + where + At(at) + ". Aborting parse.", at);
+                return {};
+            }
+            if (!expectEntry) {
+                report.Error("Missing comma" + where + At(at) + ". Aborting parse.", at);
+                return {};
+            }
+            inGroup = true;
+            groupStart = at;
+            currentGroup.clear();
+        } else if (c == ')') {
+            if (!inGroup) {
+                report.Error("Mismatched closing parenthesis" + where + At(at) + ". Aborting parse.", at);
+                return {};
+            }
+            if (expectEntry) { // e.g. () or (1,)
+                report.Error("Malformed group" + where + At(at) + " (e.g., empty entry or trailing comma).", at);
+                report.InvalidCount++;
+            }
+            if (!currentGroup.empty()) {
+                pool.push_back(currentGroup);
+            } else if (report.InvalidCount > 0) {
+                report.Warning("An encounter group" + where + " was invalid and has been skipped.", at);
+            }
+            inGroup = false;
+            expectEntry = false;
+        } else {
+            report.Error(std::string("Invalid character '") + c + "'" + where + At(at) + ". Aborting parse.", at);
+            return {};
+        }
+    }
+
+    if (inGroup) {
+        report.Error("Unclosed parenthesis" + where + At(groupStart) + ". Aborting parse.", groupStart);
+        return {};
+    }
+
+    if (pool.empty())
+        report.Warning("NPC Pool '" + poolName + "' was configured as '" + std::string(poolStr) + "' but resulted in an empty pool after parsing. Check formatting.");
+    return pool;
+}
+
+std::vector<uint32> ParseUIntList(std::string_view text, const std::string& setting, TrialParseReport& report)
+{
+    std::vector<uint32> values;
+    TrialListTokenizer tokenizer(text);
+    while (!tokenizer.AtEnd()) {
+        if (tokenizer.Consume(','))
+            continue;
+
+        size_t at = tokenizer.Position();
+        uint32 value = 0;
+        bool read = tokenizer.ReadUInt(value);
+        bool outOfRange = tokenizer.IsOutOfRange();
+        if (read && (tokenizer.AtEnd() || tokenizer.Peek() == ',')) {
+            if (value != 0) {
+                values.push_back(value);
+                report.EntryCount++;
+                continue;
+            }
+            report.Error("Invalid value '0' in " + setting + At(at) + ". Skipping.", at);
+            report.InvalidCount++;
+            continue;
+        }
+
+        size_t errorAt = read ? tokenizer.Position() : at;
+        tokenizer.SkipTo(",");
+        report.Error("Invalid value '" + Slice(text, 0, at, tokenizer.Position()) + "' in " + setting + At(errorAt) +
+            (outOfRange ? ": the number is out of range" : ": expected a positive whole number") + ". Skipping.", errorAt);
+        report.InvalidCount++;
+    }
+    return values;
+}
+
+std::vector<TrialLevelRange> ParseLevelBands(std::string_view text, uint32 maxLevel, TrialParseReport& report)
+{
+    std::vector<TrialLevelRange> bands;
+    TrialListTokenizer tokenizer(text);
+    while (!tokenizer.AtEnd()) {
+        if (tokenizer.Consume(','))
+            continue;
+
+        size_t at = tokenizer.Position();
+        uint32 minLevel = 0, maxBandLevel = 0;
+        bool read = tokenizer.ReadUInt(minLevel);
+        if (read) {
+            maxBandLevel = minLevel;
+            if (tokenizer.Consume('-'))
+                read = tokenizer.ReadUInt(maxBandLevel);
+        }
+        size_t errorAt = tokenizer.Position();
+        read = read && (tokenizer.AtEnd() || tokenizer.Peek() == ',');
+        tokenizer.SkipTo(",");
+        std::string band = Slice(text, 0, at, tokenizer.Position());
+
+        if (!read) {
+            report.Error("Failed to parse level band '" + band + "' in LevelBands" + At(errorAt) + ". Expected Min-Max or a single level. Skipping.", errorAt);
+            report.InvalidCount++;
+            continue;
+        }
+        if (minLevel == 0 || minLevel > maxBandLevel || maxBandLevel > maxLevel) {
+            report.Error("Invalid level band '" + band + "' in LevelBands" + At(at) + ". Levels must satisfy 1 <= min <= max <= " + std::to_string(maxLevel) + ". Skipping.", at);
+            report.InvalidCount++;
+            continue;
+        }
+
+        bool overlaps = false;
+        for (size_t i = 0; i < bands.size() && !overlaps; ++i) {
+            if (minLevel <= bands[i].MaxLevel && maxBandLevel >= bands[i].MinLevel) {
+                report.Error("Level band '" + band + "'" + At(at) + " overlaps band " + std::to_string(i + 1) + " at level " +
+                    std::to_string(std::max<uint32>(minLevel, bands[i].MinLevel)) + ". Skipping.", at);
+                report.InvalidCount++;
+                overlaps = true;
+            }
+        }
+        if (overlaps)
+            continue;
+
+        bands.push_back({ uint8(minLevel), uint8(maxBandLevel) });
+        report.EntryCount++;
+    }
+    return bands;
+}
+
+bool ParseFloatList(std::string_view text, char separator, std::vector<float>& out)
+{
+    out.clear();
+    TrialListTokenizer tokenizer(text);
+    if (tokenizer.AtEnd())
+        return true;
+    do {
+        float value = 0.0f;
+        if (!tokenizer.ReadFloat(value))
+            return false;
+        out.push_back(value);
+    } while (tokenizer.Consume(separator));
+    return tokenizer.AtEnd();
+}
+
+std::vector<std::string_view> SplitListItems(std::string_view text, char separator)
+{
+    std::vector<std::string_view> items;
+    size_t pos = 0;
+    while (pos <= text.size()) {
+        size_t end = text.find(separator, pos);
+        if (end == std::string_view::npos)
+            end = text.size();
+        if (end > pos)
+            items.push_back(text.substr(pos, end - pos));
+        pos = end + 1;
+    }
+    return items;
+}
+
+size_t ParseFloatRecords(std::string_view text, size_t arity, const std::string& setting, TrialParseReport& report,
+    std::vector<float>& out, size_t origin)
+{
+    size_t records = 0;
+    TrialListTokenizer tokenizer(text, origin);
+    while (!tokenizer.AtEnd()) {
+        if (tokenizer.Consume(';'))
+            continue;
+
+        size_t at = tokenizer.Position();
+        size_t mark = out.size();
+        size_t fields = 0;
+        bool read = true;
+        do {
+            float value = 0.0f;
+            if (!tokenizer.ReadFloat(value)) {
+                read = false;
+                break;
+            }
+            out.push_back(value);
+            ++fields;
+        } while (tokenizer.Consume(','));
+
+        bool ended = tokenizer.AtEnd() || tokenizer.Peek() == ';';
+        if (read && ended && fields == arity) {
+            ++records;
+            continue;
+        }
+
+        out.resize(mark);
+        size_t errorAt = tokenizer.Position();
+        bool outOfRange = tokenizer.IsOutOfRange();
+        tokenizer.SkipTo(";");
+        std::string problem;
+        if (!read)
+            problem = outOfRange ? "the number is out of range" : "expected a number";
+        else if (!ended)
+            problem = "expected ',' or ';'";
+        else {
+            problem = "found " + std::to_string(fields) + " values";
+            errorAt = at;
+        }
+        report.Error("Invalid entry '" + Slice(text, origin, at, tokenizer.Position()) + "' in " + setting + At(errorAt) + ": " + problem +
+            ". It must have exactly " + std::to_string(arity) + " comma-separated numbers.", errorAt);
+        report.InvalidCount++;
+    }
+    return records;
+}
+
+std::vector<TrialSpawnPoint> ParseSpawnPositions(std::string_view text, TrialParseReport& report, const std::string& setting)
+{
+    std::vector<float> values;
+    size_t count = ParseFloatRecords(text, 4, setting, report, values);
+    std::vector<TrialSpawnPoint> points(count);
+    for (size_t i = 0; i < count; ++i)
+        points[i] = { values[i * 4], values[i * 4 + 1], values[i * 4 + 2], values[i * 4 + 3] };
+    return points;
+}
+
+} // namespace ModTrialOfFinality
@@ -0,0 +1,126 @@
+/*
+ * Trial of Finality config parsing: the list settings (NPC pools, ID lists, level bands, float lists,
+ * spawn positions) turned into the structures the module compiles at load. Every parser runs on one
+ * TrialListTokenizer, a single pass over the value with std::from_chars and no copies; nothing here
+ * throws. Problems are collected in a TrialParseReport, with the column they were found at, for the
+ * caller to log. Part of the core library; no AzerothCore dependency.
+ */
+
+#ifndef TRIAL_CONFIG_PARSING_H
+#define TRIAL_CONFIG_PARSING_H
+
+#include "trial_core_types.h"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ModTrialOfFinality
+{
+
+// Encounter groups; a single entry is a group of one.
+typedef std::vector<std::vector<uint32>> TrialNpcPool;
+
+struct TrialSpawnPoint
+{
+    float X = 0.0f;
+    float Y = 0.0f;
+    float Z = 0.0f;
+    float O = 0.0f;
+};
+
+struct TrialLevelRange
+{
+    uint8 MinLevel = 0;
+    uint8 MaxLevel = 0;
+};
+
+static constexpr size_t TRIAL_PARSE_NO_POSITION = size_t(-1);
+
+struct TrialParseMessage
+{
+    bool Error = false;     // Otherwise a warning
+    std::string Text;
+    size_t Position = TRIAL_PARSE_NO_POSITION;  // 0-based offset into the value, if the problem has one
+};
+
+struct TrialParseReport
+{
+    std::vector<TrialParseMessage> Messages;
+    int EntryCount = 0;
+    int InvalidCount = 0;
+
+    void Error(std::string text, size_t position = TRIAL_PARSE_NO_POSITION) { Messages.push_back({ true, std::move(text), position }); }
+    void Warning(std::string text, size_t position = TRIAL_PARSE_NO_POSITION) { Messages.push_back({ false, std::move(text), position }); }
+    bool HasErrors() const;
+};
+
+// --- Tokenizer ---
+// Reads a list setting left to right. Whitespace between tokens is skipped; positions are offsets into
+// the full value, so a tokenizer over a slice (one polygon of Arena.Boundary.Polygons) still reports
+// columns of the whole setting.
+class TrialListTokenizer
+{
+public:
+    explicit TrialListTokenizer(std::string_view text, size_t origin = 0) : _text(text), _origin(origin) { }
+
+    bool AtEnd();                           // Skips whitespace first
+    char Peek();                            // '\0' at the end
+    bool Consume(char c);                   // Skips whitespace, then takes c if it is next
+    size_t Position() const { return _origin + _pos; }
+
+    // Reads one unsigned decimal number. On failure nothing is consumed, except a number too large for
+    // uint32, which is stepped over and flagged by IsOutOfRange.
+    bool ReadUInt(uint32& value);
+    // Reads one finite decimal float, with an optional leading '+'; the same failure rules apply.
+    bool ReadFloat(float& value);
+    bool IsOutOfRange() const { return _outOfRange; }
+
+    // Steps over a bad item: moves to the next of the stop characters, or the end.
+    void SkipTo(std::string_view stops);
+
+private:
+    void SkipSpace();
+
+    std::string_view _text;
+    size_t _origin;
+    size_t _pos = 0;
+    bool _outOfRange = false;
+};
+
+// --- Parsers ---
+// "70001,(70002,70003),70004": comma separated creature entries, with parenthesized encounter groups.
+// creatureExists, if set, rejects entries without a creature template. Structural errors (nesting,
+// mismatched parentheses, unexpected characters) reject the whole pool.
+TrialNpcPool ParseNpcPoolString(std::string_view poolStr, const std::string& poolName,
+    const std::function<bool(uint32)>& creatureExists, TrialParseReport& report);
+
+// "1519, 1537, 1637": comma separated non-zero IDs. Empty items are ignored; invalid items are reported
+// and skipped.
+std::vector<uint32> ParseUIntList(std::string_view text, const std::string& setting, TrialParseReport& report);
+
+// "1-19,20-39,80": comma separated level ranges. Ranges outside 1..maxLevel, reversed or overlapping an
+// earlier range are reported and skipped, so the result is in list order and disjoint.
+std::vector<TrialLevelRange> ParseLevelBands(std::string_view text, uint32 maxLevel, TrialParseReport& report);
+
+// Splits text on separator and converts every piece; false if any piece is not a number.
+bool ParseFloatList(std::string_view text, char separator, std::vector<float>& out);
+
+// "line one|line two": the non-empty pieces between separators, unchanged (whitespace is kept), as views
+// into text.
+std::vector<std::string_view> SplitListItems(std::string_view text, char separator);
+
+// "a,b,c;a,b,c;...": ';' separated records of exactly arity comma separated floats, appended to out
+// flattened. Invalid records are reported and skipped; returns the number of records read.
+size_t ParseFloatRecords(std::string_view text, size_t arity, const std::string& setting, TrialParseReport& report,
+    std::vector<float>& out, size_t origin = 0);
+
+// "X,Y,Z,O;X,Y,Z,O;...": invalid segments are reported and skipped.
+std::vector<TrialSpawnPoint> ParseSpawnPositions(std::string_view text, TrialParseReport& report,
+    const std::string& setting = "Arena.SpawnPositions");
+
+} // namespace ModTrialOfFinality
+
+#endif // TRIAL_CONFIG_PARSING_H
@@ -0,0 +1,22 @@
+/*
+ * Fixed-width integer names used throughout the Trial of Finality core library.
+ *
+ * They match AzerothCore's own typedefs (Define.h), so the module can include core headers next to
+ * AzerothCore headers, while the core still builds with nothing but the standard library.
+ */
+
+#ifndef TRIAL_CORE_TYPES_H
+#define TRIAL_CORE_TYPES_H
+
+#include <cstdint>
+
+typedef std::int64_t int64;
+typedef std::int32_t int32;
+typedef std::int16_t int16;
+typedef std::int8_t int8;
+typedef std::uint64_t uint64;
+typedef std::uint32_t uint32;
+typedef std::uint16_t uint16;
+typedef std::uint8_t uint8;
+
+#endif // TRIAL_CORE_TYPES_H
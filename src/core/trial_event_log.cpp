@@ -0,0 +1,126 @@
+#include "trial_event_log.h"
+
+namespace ModTrialOfFinality
+{
+
+static const char* const TrialEventTypeNames[TRIAL_EVENT_TYPE_COUNT] =
+{
+    "TRIAL_START",
+    "WAVE_START",
+    "PLAYER_DEATH_TOKEN",
+    "TRIAL_SUCCESS",
+    "TRIAL_FAILURE",
+    "GM_COMMAND_RESET",
+    "GM_COMMAND_TEST_START",
+    "PLAYER_RESURRECTED",
+    "PERMADEATH_APPLIED",
+    "PLAYER_DISCONNECT",
+    "PLAYER_RECONNECT",
+    "STRAY_TOKEN_REMOVED",
+    "PLAYER_WARNED_ARENA_LEAVE",
+    "PLAYER_FORFEIT_ARENA",
+    "WORLD_ANNOUNCEMENT_SUCCESS",
+    "NPC_CHEER_TRIGGERED",
+    "FORFEIT_VOTE_START",
+    "FORFEIT_VOTE_CANCEL",
+    "FORFEIT_VOTE_SUCCESS"
+};
+
+const char* TrialEventTypeName(TrialEventType eventType)
+{
+    return uint32(eventType) < TRIAL_EVENT_TYPE_COUNT ? TrialEventTypeNames[eventType] : "UNKNOWN";
+}
+
+// std::to_string allocates a string per number; these append straight into the output instead.
+static void AppendUInt(std::string& out, uint64 value)
+{
+    char buffer[20];
+    char* end = buffer + sizeof(buffer);
+    char* begin = end;
+    do
+    {
+        *--begin = char('0' + value % 10);
+        value /= 10;
+    } while (value);
+    out.append(begin, end);
+}
+
+static void AppendInt(std::string& out, int64 value)
+{
+    if (value < 0)
+    {
+        out += '-';
+        AppendUInt(out, uint64(0) - uint64(value));
+    }
+    else
+        AppendUInt(out, uint64(value));
+}
+
+static void AppendNullableId(std::string& out, uint64 value)
+{
+    if (value)
+        AppendUInt(out, value);
+    else
+        out += "NULL";
+}
+
+static void AppendNullableText(std::string& out, std::string_view value)
+{
+    if (value.empty())
+    {
+        out += "NULL";
+        return;
+    }
+    out += '\'';
+    out += value;
+    out += '\'';
+}
+
+void FormatTrialEventSlog(const TrialEventRecord& record, std::string& out)
+{
+    out.reserve(out.size() + 160 + record.PlayerName.size() + record.Details.size());
+    out += "[TrialEventSLOG] Type: ";
+    out += TrialEventTypeName(record.Type);
+    out += ", GroupID: ";
+    AppendUInt(out, record.GroupId);
+    out += ", PlayerGUID: ";
+    AppendUInt(out, record.PlayerGuid);
+    out += ", PlayerName: ";
+    if (record.PlayerName.empty())
+        out += "N/A";
+    else
+        out += record.PlayerName;
+    out += ", AccountID: ";
+    AppendUInt(out, record.AccountId);
+    out += ", HighestLvl: ";
+    AppendUInt(out, record.HighestLevel);
+    out += ", Wave: ";
+    AppendInt(out, record.Wave);
+    out += ", Details: '";
+    out += record.Details;
+    out += '\'';
+}
+
+void FormatTrialEventInsert(const TrialEventRecord& record, std::string& out)
+{
+    out.reserve(out.size() + 240 + record.PlayerName.size() + record.Details.size());
+    out += "INSERT INTO trial_of_finality_log (event_type, group_id, player_guid, player_name, player_account_id, highest_level_in_group, wave_number, details) VALUES ('";
+    out += TrialEventTypeName(record.Type);
+    out += "', ";
+    AppendNullableId(out, record.GroupId);
+    out += ", ";
+    AppendNullableId(out, record.PlayerGuid);
+    out += ", ";
+    AppendNullableText(out, record.PlayerName);
+    out += ", ";
+    AppendNullableId(out, record.AccountId);
+    out += ", ";
+    AppendNullableId(out, record.HighestLevel);
+    out += ", ";
+    AppendInt(out, record.Wave);
+    out += ", ";
+    AppendNullableText(out, record.Details);
+    out += ')';
+}
+
+} // namespace ModTrialOfFinality
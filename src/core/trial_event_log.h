@@ -0,0 +1,64 @@
+/*
+ * Trial of Finality event log: event types and the text written for each event, both the server log
+ * line and the `trial_of_finality_log` insert. Part of the core library; no AzerothCore dependency.
+ */
+
+#ifndef TRIAL_EVENT_LOG_H
+#define TRIAL_EVENT_LOG_H
+
+#include "trial_core_types.h"
+
+#include <string>
+#include <string_view>
+
+namespace ModTrialOfFinality
+{
+
+enum TrialEventType {
+    TRIAL_EVENT_START,
+    TRIAL_EVENT_WAVE_START,
+    TRIAL_EVENT_PLAYER_DEATH_TOKEN,
+    TRIAL_EVENT_TRIAL_SUCCESS,
+    TRIAL_EVENT_TRIAL_FAILURE,
+    TRIAL_EVENT_GM_COMMAND_RESET,
+    TRIAL_EVENT_GM_COMMAND_TEST_START,
+    TRIAL_EVENT_PLAYER_RESURRECTED,
+    TRIAL_EVENT_PERMADEATH_APPLIED,
+    TRIAL_EVENT_PLAYER_DISCONNECT,
+    TRIAL_EVENT_PLAYER_RECONNECT,
+    TRIAL_EVENT_STRAY_TOKEN_REMOVED,
+    TRIAL_EVENT_PLAYER_WARNED_ARENA_LEAVE,
+    TRIAL_EVENT_PLAYER_FORFEIT_ARENA,
+    TRIAL_EVENT_WORLD_ANNOUNCEMENT_SUCCESS,
+    TRIAL_EVENT_NPC_CHEER_TRIGGERED,
+    TRIAL_EVENT_FORFEIT_VOTE_START,
+    TRIAL_EVENT_FORFEIT_VOTE_CANCEL,
+    TRIAL_EVENT_FORFEIT_VOTE_SUCCESS,
+    TRIAL_EVENT_TYPE_COUNT
+};
+
+// The `event_type` column value, e.g. "TRIAL_START"; "UNKNOWN" for anything out of range.
+const char* TrialEventTypeName(TrialEventType eventType);
+
+// One event as it is logged. Zero ids and empty strings are written as NULL (the wave is always written).
+struct TrialEventRecord
+{
+    TrialEventType Type = TRIAL_EVENT_START;
+    uint32 GroupId = 0;
+    uint32 PlayerGuid = 0;
+    uint32 AccountId = 0;
+    uint8 HighestLevel = 0;
+    int32 Wave = 0;
+    std::string_view PlayerName;
+    std::string_view Details;
+};
+
+// Appends the "[TrialEventSLOG] ..." server log line to out.
+void FormatTrialEventSlog(const TrialEventRecord& record, std::string& out);
+
+// Appends the INSERT statement to out. PlayerName and Details must already be escaped for SQL.
+void FormatTrialEventInsert(const TrialEventRecord& record, std::string& out);
+
+} // namespace ModTrialOfFinality
+
+#endif // TRIAL_EVENT_LOG_H
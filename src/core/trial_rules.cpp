@@ -0,0 +1,287 @@
+#include "trial_rules.h"
+
+#include <algorithm>
+
+namespace ModTrialOfFinality
+{
+
+const char* const TrialEndReasonNames[TRIAL_END_REASON_COUNT] =
+{
+    "none", "all_waves_cleared", "wipe", "boundary", "forfeit"
+};
+
+void SelectEncounterGroups(const std::vector<std::vector<uint32>>& pool, uint32 count, size_t spawnPositions,
+    std::mt19937& rng, std::vector<uint32>& entries)
+{
+    count = std::min<uint32>(count, uint32(pool.size()));
+    if (!count)
+        return;
+
+    // Partial Fisher-Yates over indices: the first count slots end up a uniform random draw.
+    std::vector<uint32> order(pool.size());
+    for (uint32 i = 0; i < order.size(); ++i)
+        order[i] = i;
+
+    size_t used = 0;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        std::uniform_int_distribution<uint32> pick(i, uint32(order.size() - 1));
+        std::swap(order[i], order[pick(rng)]);
+        const std::vector<uint32>& group = pool[order[i]];
+        if (used + group.size() > spawnPositions)
+            continue;
+        entries.insert(entries.end(), group.begin(), group.end());
+        used += group.size();
+    }
+}
+
+TrialBoundaryAction DecideBoundaryAction(TrialBoundaryState& state, TrialBoundaryZone zone, bool warnedBefore,
+    uint32 clockMs, uint32 graceMs)
+{
+    if (!state.Outside)
+    {
+        if (zone < BOUNDARY_ZONE_WARNING)
+            return BOUNDARY_ACTION_NONE;
+        state.Outside = true;
+        state.OutsideSinceMs = clockMs;
+        return (zone == BOUNDARY_ZONE_FAIL || warnedBefore) ? BOUNDARY_ACTION_FAIL : BOUNDARY_ACTION_WARN;
+    }
+
+    if (zone == BOUNDARY_ZONE_INSIDE)
+    {
+        state.Outside = false;
+        return BOUNDARY_ACTION_NONE;
+    }
+
+    if (zone == BOUNDARY_ZONE_FAIL || (zone == BOUNDARY_ZONE_WARNING && clockMs - state.OutsideSinceMs >= graceMs))
+        return BOUNDARY_ACTION_FAIL;
+    return BOUNDARY_ACTION_NONE;
+}
+
+TrialOutcome ComputeTrialOutcome(bool success, const std::vector<uint32>& participants,
+    const std::vector<uint32>& downed, const std::vector<uint32>& alreadyFailed)
+{
+    TrialOutcome outcome;
+    outcome.Success = success;
+    outcome.PermaFailed = alreadyFailed;
+    if (!success)
+        outcome.PermaFailed.insert(outcome.PermaFailed.end(), downed.begin(), downed.end());
+    std::sort(outcome.PermaFailed.begin(), outcome.PermaFailed.end());
+    outcome.PermaFailed.erase(std::unique(outcome.PermaFailed.begin(), outcome.PermaFailed.end()), outcome.PermaFailed.end());
+
+    if (success)
+    {
+        for (uint32 id : participants)
+            if (!std::binary_search(outcome.PermaFailed.begin(), outcome.PermaFailed.end(), id))
+                outcome.Winners.push_back(id);
+    }
+    return outcome;
+}
+
+// --- TrialRunState ---
+void TrialRunState::AddParticipant(uint32 id)
+{
+    if (_phase != TRIAL_RUN_LOBBY || FindMember(id))
+        return;
+    Member member;
+    member.Id = id;
+    _members.push_back(member);
+}
+
+bool TrialRunState::Start()
+{
+    if (_phase != TRIAL_RUN_LOBBY || _members.empty() || _waveCount == 0)
+        return false;
+    _phase = TRIAL_RUN_IN_WAVE;
+    _currentWave = 1;
+    return true;
+}
+
+TrialRunState::Member* TrialRunState::FindMember(uint32 id)
+{
+    for (Member& member : _members)
+        if (member.Id == id)
+            return &member;
+    return nullptr;
+}
+
+const TrialMemberStatus* TrialRunState::GetMember(uint32 id) const
+{
+    for (const Member& member : _members)
+        if (member.Id == id)
+            return &member.Status;
+    return nullptr;
+}
+
+uint32 TrialRunState::GetStandingCount() const
+{
+    uint32 standing = 0;
+    for (const Member& member : _members)
+        if (IsMemberStanding(member.Status))
+            ++standing;
+    return standing;
+}
+
+bool TrialRunState::CheckForWipe()
+{
+    if (GetStandingCount() != 0)
+        return false;
+    End(TRIAL_RUN_FAILED, TRIAL_END_WIPE);
+    return true;
+}
+
+void TrialRunState::End(TrialRunPhase phase, TrialEndReason reason)
+{
+    _phase = phase;
+    _endReason = reason;
+    _voteInProgress = false;
+
+    std::vector<uint32> participants, downed, alreadyFailed;
+    participants.reserve(_members.size());
+    for (const Member& member : _members)
+    {
+        participants.push_back(member.Id);
+        if (member.Status.Downed)
+            downed.push_back(member.Id);
+        if (member.Status.PermaFailed)
+            alreadyFailed.push_back(member.Id);
+    }
+
+    // A forfeit ends the trial without sealing anyone's fate, like the module's CleanupTrial(false).
+    if (phase == TRIAL_RUN_FORFEITED)
+    {
+        _outcome = TrialOutcome();
+        return;
+    }
+
+    _outcome = ComputeTrialOutcome(phase == TRIAL_RUN_SUCCEEDED, participants, downed, alreadyFailed);
+    for (Member& member : _members)
+    {
+        member.Status.Downed = false;
+        member.Status.PermaFailed = std::binary_search(_outcome.PermaFailed.begin(), _outcome.PermaFailed.end(), member.Id);
+    }
+}
+
+bool TrialRunState::OnWaveCleared()
+{
+    if (_phase != TRIAL_RUN_IN_WAVE)
+        return false;
+
+    // Downed members survived the wave; they still have to be resurrected to fight again.
+    for (Member& member : _members)
+        member.Status.Downed = false;
+
+    if (NextWaveStep(_currentWave, _waveCount) == TRIAL_WAVE_STEP_NEXT)
+    {
+        ++_currentWave;
+        return false;
+    }
+    End(TRIAL_RUN_SUCCEEDED, TRIAL_END_ALL_WAVES_CLEARED);
+    return true;
+}
+
+bool TrialRunState::OnDowned(uint32 id)
+{
+    Member* member = FindMember(id);
+    if (_phase != TRIAL_RUN_IN_WAVE || !member || member->Status.Downed)
+        return false;
+    member->Status.Alive = false;
+    member->Status.Downed = true;
+    return CheckForWipe();
+}
+
+bool TrialRunState::OnResurrected(uint32 id)
+{
+    Member* member = FindMember(id);
+    if (IsOver() || !member || member->Status.Alive)
+        return false;
+    member->Status.Alive = true;
+    member->Status.Downed = false;
+    return false;
+}
+
+bool TrialRunState::OnDisconnected(uint32 id)
+{
+    Member* member = FindMember(id);
+    if (_phase != TRIAL_RUN_IN_WAVE || !member || member->Status.Disconnected)
+        return false;
+    // Absent players neither vote nor block a vote, and their boundary state starts over on return.
+    member->Status.Disconnected = true;
+    member->Voted = false;
+    member->Boundary = TrialBoundaryState();
+    return false;
+}
+
+bool TrialRunState::OnReconnected(uint32 id)
+{
+    Member* member = FindMember(id);
+    if (!member || !member->Status.Disconnected)
+        return false;
+    member->Status.Disconnected = false;
+    return false;
+}
+
+bool TrialRunState::OnResumeExpired(uint32 id)
+{
+    Member* member = FindMember(id);
+    if (_phase != TRIAL_RUN_IN_WAVE || !member || !member->Status.Disconnected)
+        return false;
+    member->Status.Disconnected = false;
+    member->Status.Alive = false;
+    member->Status.Downed = true;
+    return CheckForWipe();
+}
+
+TrialBoundaryAction TrialRunState::OnBoundary(uint32 id, TrialBoundaryZone zone, uint32 clockMs)
+{
+    Member* member = FindMember(id);
+    if (_phase != TRIAL_RUN_IN_WAVE || !member || !member->Status.Alive || member->Status.Disconnected)
+        return BOUNDARY_ACTION_NONE;
+
+    TrialBoundaryAction action = DecideBoundaryAction(member->Boundary, zone, member->Warned, clockMs, _boundaryGraceMs);
+    if (action == BOUNDARY_ACTION_WARN)
+        member->Warned = true;
+    else if (action == BOUNDARY_ACTION_FAIL)
+        End(TRIAL_RUN_FAILED, TRIAL_END_BOUNDARY);
+    return action;
+}
+
+bool TrialRunState::OnForfeitVote(uint32 id, int64 now)
+{
+    Member* member = FindMember(id);
+    if (_phase != TRIAL_RUN_IN_WAVE || !member || member->Voted || !IsForfeitVoter(member->Status))
+        return false;
+
+    if (!_voteInProgress)
+    {
+        _voteInProgress = true;
+        _voteStartedAt = now;
+    }
+    member->Voted = true;
+
+    size_t votes = 0;
+    uint32 voters = 0;
+    for (const Member& other : _members)
+    {
+        if (other.Voted)
+            ++votes;
+        if (IsForfeitVoter(other.Status))
+            ++voters;
+    }
+    if (!IsForfeitVotePassed(votes, voters))
+        return false;
+
+    End(TRIAL_RUN_FORFEITED, TRIAL_END_FORFEIT);
+    return true;
+}
+
+void TrialRunState::Update(int64 now)
+{
+    if (!_voteInProgress || !IsForfeitVoteExpired(_voteStartedAt, now))
+        return;
+    _voteInProgress = false;
+    for (Member& member : _members)
+        member.Voted = false;
+}
+
+} // namespace ModTrialOfFinality
@@ -0,0 +1,200 @@
+/*
+ * Trial of Finality rules: the decisions the trial makes, separated from the AzerothCore objects they are
+ * made about.
+ *
+ * The instance script keeps its own AzerothCore-typed state (players, creatures, timers) and asks these
+ * functions what to do; TrialRunState composes the same functions into a complete trial that runs
+ * without a worldserver, which is what tools/trial_simulator drives. Part of the core library; no
+ * AzerothCore dependency.
+ */
+
+#ifndef TRIAL_RULES_H
+#define TRIAL_RULES_H
+
+#include "trial_core_types.h"
+#include "trial_arena_boundary.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+namespace ModTrialOfFinality
+{
+
+// --- Roster ---
+struct TrialMemberStatus
+{
+    bool Alive = true;
+    bool Downed = false;            // Died this wave; shares the group's fate unless resurrected or the wave is cleared
+    bool Disconnected = false;      // Inside the reconnect grace period
+    bool PermaFailed = false;
+};
+
+// A member keeps the trial going if they are not downed and are either alive or holding their place
+// through a disconnect. The trial is wiped once no member is standing.
+inline bool IsMemberStanding(const TrialMemberStatus& status)
+{
+    return !status.Downed && (status.Alive || status.Disconnected);
+}
+
+// Only members in the arena, alive and not already failed, take part in a forfeit vote.
+inline bool IsForfeitVoter(const TrialMemberStatus& status)
+{
+    return !status.Disconnected && status.Alive && !status.PermaFailed;
+}
+
+// --- Forfeit Vote ---
+static constexpr int64 FORFEIT_VOTE_TIMEOUT_SECONDS = 30;
+
+// Forfeiting is unanimous among the current voters.
+inline bool IsForfeitVotePassed(size_t votes, uint32 voters)
+{
+    return voters > 0 && votes >= voters;
+}
+
+inline bool IsForfeitVoteExpired(int64 startedAt, int64 now)
+{
+    return now - startedAt > FORFEIT_VOTE_TIMEOUT_SECONDS;
+}
+
+// --- Waves ---
+enum TrialWaveStep : uint8
+{
+    TRIAL_WAVE_STEP_NEXT = 0,       // Announce and spawn the next wave
+    TRIAL_WAVE_STEP_ALL_CLEARED     // That was the last wave; the trial succeeded
+};
+
+// Called when currentWave (1-based) has been cleared. Clearing a wave also lifts every downed mark.
+inline TrialWaveStep NextWaveStep(uint32 currentWave, size_t waveCount)
+{
+    return currentWave < waveCount ? TRIAL_WAVE_STEP_NEXT : TRIAL_WAVE_STEP_ALL_CLEARED;
+}
+
+// One more encounter group than there are active players, at most one per spawn position.
+inline uint32 EncounterGroupCount(size_t spawnPositions, uint32 activePlayers)
+{
+    return std::max<uint32>(std::min<uint32>(uint32(spawnPositions), activePlayers + 1), 1);
+}
+
+// Draws count encounter groups from pool in random order and lays their creatures out on consecutive
+// spawn positions; a group that no longer fits the remaining positions is skipped. The creature entries
+// are appended to entries in spawn position order. Only the drawn groups are shuffled, and nothing in
+// the pool is copied.
+void SelectEncounterGroups(const std::vector<std::vector<uint32>>& pool, uint32 count, size_t spawnPositions,
+    std::mt19937& rng, std::vector<uint32>& entries);
+
+// --- Arena Boundary ---
+enum TrialBoundaryAction : uint8
+{
+    BOUNDARY_ACTION_NONE = 0,
+    BOUNDARY_ACTION_WARN,           // First time outside: warn the player, the trial goes on
+    BOUNDARY_ACTION_FAIL            // Fled the arena: the trial fails for the group
+};
+
+struct TrialBoundaryState
+{
+    bool Outside = false;           // Left the arena and has not come back past the hysteresis margin
+    uint32 OutsideSinceMs = 0;
+};
+
+// Crossing out requires clearing the hysteresis band, so jitter on the line does not count. A player who
+// was already warned fails on the next crossing; anyone beyond the fail distance, or lingering in the
+// warning band past the grace period, fails at once.
+TrialBoundaryAction DecideBoundaryAction(TrialBoundaryState& state, TrialBoundaryZone zone, bool warnedBefore,
+    uint32 clockMs, uint32 graceMs);
+
+// --- Outcome ---
+struct TrialOutcome
+{
+    bool Success = false;
+    std::vector<uint32> Winners;        // Participants who receive the reward
+    std::vector<uint32> PermaFailed;    // Participants whose fate is sealed, sorted
+};
+
+// On failure every downed participant is permanently failed; exemptions (GMs) only skip the database
+// write and are the caller's concern. On success the winners are the participants not already failed.
+TrialOutcome ComputeTrialOutcome(bool success, const std::vector<uint32>& participants,
+    const std::vector<uint32>& downed, const std::vector<uint32>& alreadyFailed);
+
+// --- Headless Trial ---
+enum TrialRunPhase : uint8
+{
+    TRIAL_RUN_LOBBY = 0,
+    TRIAL_RUN_IN_WAVE,
+    TRIAL_RUN_SUCCEEDED,
+    TRIAL_RUN_FAILED,
+    TRIAL_RUN_FORFEITED
+};
+
+enum TrialEndReason : uint8
+{
+    TRIAL_END_NONE = 0,
+    TRIAL_END_ALL_WAVES_CLEARED,
+    TRIAL_END_WIPE,
+    TRIAL_END_BOUNDARY,
+    TRIAL_END_FORFEIT,
+    TRIAL_END_REASON_COUNT
+};
+
+extern const char* const TrialEndReasonNames[TRIAL_END_REASON_COUNT];
+
+// One trial from start to outcome, driven by events instead of packets and map updates. Members are
+// identified by the caller's ids (character guid counters in the module). Event methods return true if
+// the event ended the trial; events for unknown members or after the end are ignored.
+class TrialRunState
+{
+public:
+    TrialRunState(uint32 waveCount, uint32 boundaryGraceMs)
+        : _waveCount(waveCount), _boundaryGraceMs(boundaryGraceMs) { }
+
+    void AddParticipant(uint32 id);
+    bool Start();
+
+    bool OnWaveCleared();
+    bool OnDowned(uint32 id);
+    bool OnResurrected(uint32 id);
+    bool OnDisconnected(uint32 id);
+    bool OnReconnected(uint32 id);
+    bool OnResumeExpired(uint32 id);    // Did not return within the grace period; counts as downed
+    TrialBoundaryAction OnBoundary(uint32 id, TrialBoundaryZone zone, uint32 clockMs);
+    bool OnForfeitVote(uint32 id, int64 now);
+    void Update(int64 now);             // Expires a stale forfeit vote
+
+    TrialRunPhase GetPhase() const { return _phase; }
+    TrialEndReason GetEndReason() const { return _endReason; }
+    bool IsOver() const { return _phase >= TRIAL_RUN_SUCCEEDED; }
+    uint32 GetCurrentWave() const { return _currentWave; }
+    uint32 GetStandingCount() const;
+    const TrialOutcome& GetOutcome() const { return _outcome; }
+    const TrialMemberStatus* GetMember(uint32 id) const;
+    size_t GetParticipantCount() const { return _members.size(); }
+
+private:
+    struct Member
+    {
+        uint32 Id = 0;
+        TrialMemberStatus Status;
+        TrialBoundaryState Boundary;
+        bool Warned = false;
+        bool Voted = false;
+    };
+
+    Member* FindMember(uint32 id);
+    bool CheckForWipe();
+    void End(TrialRunPhase phase, TrialEndReason reason);
+
+    uint32 _waveCount;
+    uint32 _boundaryGraceMs;
+    uint32 _currentWave = 0;
+    TrialRunPhase _phase = TRIAL_RUN_LOBBY;
+    TrialEndReason _endReason = TRIAL_END_NONE;
+    bool _voteInProgress = false;
+    int64 _voteStartedAt = 0;
+    std::vector<Member> _members;       // Groups are small; a linear scan beats any map here
+    TrialOutcome _outcome;
+};
+
+} // namespace ModTrialOfFinality
+
+#endif // TRIAL_RULES_H
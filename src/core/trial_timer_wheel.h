@@ -0,0 +1,119 @@
+/*
+ * Trial of Finality timer wheel, shared by the module's world-level schedulers.
+ * Part of the core library; no AzerothCore dependency.
+ */
+
+#ifndef TRIAL_TIMER_WHEEL_H
+#define TRIAL_TIMER_WHEEL_H
+
+#include "trial_core_types.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace ModTrialOfFinality
+{
+
+// --- Hierarchical Timer Wheel ---
+// Two-level hashed timer wheel shared by the module's world-level schedulers. Scheduling and expiring
+// an entry are O(1). Each tick only looks at the slot whose time has come (plus one cascade of a
+// level 1 slot every LEVEL0_SLOTS ticks), so the per-tick cost does not depend on how many entries are pending.
+template<typename T>
+class TrialTimerWheel
+{
+public:
+    static constexpr uint32 LEVEL0_SLOTS = 256;
+    static constexpr uint32 LEVEL1_SLOTS = 64;
+
+    explicit TrialTimerWheel(uint32 tickMs) : _tickMs(std::max(tickMs, 1u)) { }
+
+    // Schedules payload to expire after delayMs, rounded up to the tick resolution.
+    void Schedule(uint32 delayMs, T payload)
+    {
+        uint64 ticks = std::max<uint64>(1, (uint64(delayMs) + _tickMs - 1) / _tickMs);
+        Insert({ _currentTick + ticks, std::move(payload) });
+        ++_size;
+    }
+
+    // Advances the wheel by diff milliseconds and invokes callback(T&) for each expired entry.
+    template<typename Callback>
+    void Update(uint32 diff, Callback&& callback)
+    {
+        _accumulatedMs += diff;
+        while (_accumulatedMs >= _tickMs)
+        {
+            _accumulatedMs -= _tickMs;
+            ++_currentTick;
+            if (_currentTick % LEVEL0_SLOTS == 0)
+                Cascade();
+
+            std::vector<Entry>& slot = _level0[_currentTick % LEVEL0_SLOTS];
+            if (slot.empty())
+                continue;
+
+            _expiring.clear();
+            _expiring.swap(slot);
+            for (Entry& entry : _expiring)
+            {
+                --_size;
+                callback(entry.Payload);
+            }
+        }
+    }
+
+    size_t Size() const { return _size; }
+    uint32 GetTickMs() const { return _tickMs; }
+
+private:
+    struct Entry
+    {
+        uint64 ExpireTick;
+        T Payload;
+    };
+
+    void Insert(Entry&& entry)
+    {
+        uint64 delta = entry.ExpireTick > _currentTick ? entry.ExpireTick - _currentTick : 0;
+        if (delta < LEVEL0_SLOTS)
+            _level0[entry.ExpireTick % LEVEL0_SLOTS].push_back(std::move(entry));
+        else if (delta < uint64(LEVEL0_SLOTS) * LEVEL1_SLOTS)
+            _level1[(entry.ExpireTick / LEVEL0_SLOTS) % LEVEL1_SLOTS].push_back(std::move(entry));
+        else
+            _overflow.push_back(std::move(entry));
+    }
+
+    // Called when level 0 wraps: the level 1 slot for the block now starting moves down into level 0.
+    void Cascade()
+    {
+        uint64 block = _currentTick / LEVEL0_SLOTS;
+        std::vector<Entry> moving;
+        moving.swap(_level1[block % LEVEL1_SLOTS]);
+        for (Entry& entry : moving)
+            Insert(std::move(entry));
+
+        // Once per full level 1 revolution, bring far-future entries closer.
+        if (block % LEVEL1_SLOTS == 0 && !_overflow.empty())
+        {
+            moving.clear();
+            moving.swap(_overflow);
+            for (Entry& entry : moving)
+                Insert(std::move(entry));
+        }
+    }
+
+    uint32 _tickMs;
+    uint32 _accumulatedMs = 0;
+    uint64 _currentTick = 0;
+    size_t _size = 0;
+    std::array<std::vector<Entry>, LEVEL0_SLOTS> _level0;
+    std::array<std::vector<Entry>, LEVEL1_SLOTS> _level1;
+    std::vector<Entry> _overflow;
+    std::vector<Entry> _expiring;
+};
+
+} // namespace ModTrialOfFinality
+
+#endif // TRIAL_TIMER_WHEEL_H
@@ -4,6 +4,7 @@
 #include "Config.h"
 #include "Creature.h"
 #include "CreatureAI.h"
+#include "PassiveAI.h"
 #include "GossipDef.h"
 #include "Maps/MapMgr.h"
 #include "Group.h"
@@ -12,41 +13,865 @@
 #include "ObjectMgr.h"
 #include "Player.h"
 #include "CreatureScript.h"
+#include "MovementHandlerScript.h"
 #include "ScriptMgr.h"
 #include "WorldSession.h"
 #include "Log.h"
 #include "ChatCommand.h"
 #include "World.h"
+#include "WorldPacket.h"
+#include "Opcodes.h"
+#include "Timer.h"
+#include "ByteBuffer.h"
+#include "Base64.h"
 
 #include <time.h>
 #include <set>
 #include <sstream>
 #include <map>
+#include <limits>
 #include <cmath>
 #include <vector>
 #include <algorithm>
+#include <array>
 #include <random>
 #include <chrono>
 #include <string>
+#include <string_view>
+#include <mutex>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <cstdio>
+#ifdef __linux__
+#include <unistd.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 #include "ObjectAccessor.h"
 #include "Player.h"
 #include "DBCStores.h"
 #include "DatabaseEnv.h"
+#include "AsyncCallbackProcessor.h"
 #include "ObjectGuid.h"
 #include "CharacterCache.h"
 #include "InstanceScript.h"
+#include "UnitScript.h"
+#include "SpellAuras.h"
+#include "trial_blackbox_format.h"
+#include "core/trial_arena_boundary.h"
+#include "core/trial_config_parsing.h"
+#include "core/trial_event_log.h"
+#include "core/trial_rules.h"
+#include "core/trial_timer_wheel.h"
+#include <zlib.h>
 
 // Module specific namespace
 namespace ModTrialOfFinality
 {
 
+// --- Instance State Snapshots ---
+// The instance's progress is written to the `instance` table (through InstanceScript::SaveToDB) as a
+// small versioned binary record, base64 encoded. Layout, version 1:
+//   uint16 magic 'TF' | uint8 version | uint8 phase | uint8 currentWave | uint8 highestLevelAtStart
+//   uint8 flags (bit 0 test trial, bit 1 forfeit vote running) | uint32 groupId
+//   participants, permanently failed, forfeit votes, arena warnings: uint8 count + uint32 guid low parts
+//   downed: uint8 count + (uint32 guid low part, uint32 downed-at unix time)
+// A new field means a new version; Load() keeps reading every older version it knows.
+enum TrialSnapshotPhase : uint8
+{
+    SNAPSHOT_PHASE_NONE = 0,    // Nothing written yet
+    SNAPSHOT_PHASE_LOBBY,       // Waiting for arrivals; no tokens granted yet
+    SNAPSHOT_PHASE_WAVE,        // A wave program is running
+    SNAPSHOT_PHASE_CONCLUDED    // Outcome applied; only the exit remained
+};
+
+static constexpr uint16 SNAPSHOT_MAGIC = 0x4654;
+static constexpr uint8 SNAPSHOT_VERSION = 1;
+
+// Realm-wide snapshot write statistics, shown by `.trial snapshots`.
+struct TrialSnapshotStats
+{
+    std::atomic<uint64> Writes{ 0 };
+    std::atomic<uint64> Bytes{ 0 };
+    std::atomic<uint32> MaxBytes{ 0 };
+    std::atomic<uint32> Recovered{ 0 };
+    std::atomic<uint32> Resolved{ 0 };
+    std::atomic<uint32> Corrupt{ 0 };
+    uint32 StartedAtMs = getMSTime();
+
+    void RecordWrite(uint32 size)
+    {
+        ++Writes;
+        Bytes += size;
+        uint32 previous = MaxBytes.load();
+        while (size > previous && !MaxBytes.compare_exchange_weak(previous, size)) { }
+    }
+};
+
+TrialSnapshotStats SnapshotStats;
+
+// --- Tick Profiler ---
+// Scoped timers around the instance's hot paths feed log-linear histograms (HDR style: 8 linear
+// sub-buckets per power of two, so every recorded value is within 12.5% of its bucket). Each instance
+// records into its own histograms from its map thread and into the realm-wide ones shared by all map
+// threads; both use relaxed atomic adds and never lock. Build with TRIAL_OF_FINALITY_PROFILER=0 to
+// remove the timers entirely.
+#ifndef TRIAL_OF_FINALITY_PROFILER
+#define TRIAL_OF_FINALITY_PROFILER 1
+#endif
+
+enum TrialPerfSection : uint8
+{
+    TRIAL_PERF_UPDATE = 0,      // instance_trial_of_finality::Update, everything below included
+    TRIAL_PERF_SCHEDULER,       // scheduler.Update
+    TRIAL_PERF_SPAWN_WAVE,      // SpawnActualWave
+    TRIAL_PERF_MONSTER_KILLED,  // HandleMonsterKilled
+    TRIAL_PERF_FINALIZE,        // FinalizeTrialOutcome
+    TRIAL_PERF_CLEANUP,         // CleanupTrial
+    TRIAL_PERF_BOUNDARY,        // CheckPlayerLocationsAndEnforceBoundaries
+    TRIAL_PERF_SECTION_COUNT
+};
+
+static const char* const TrialPerfSectionNames[TRIAL_PERF_SECTION_COUNT] =
+{
+    "Update", "Scheduler", "SpawnWave", "MonsterKilled", "Finalize", "Cleanup", "Boundary"
+};
+
+// Index of the highest set bit of a non-zero value. MSVC has no __builtin_clzll.
+inline uint32 TrialHighestBit(uint64 value)
+{
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return uint32(index);
+#else
+    return 63 - uint32(__builtin_clzll(value));
+#endif
+}
+
+class TrialPerfHistogram
+{
+public:
+    static constexpr uint32 SUB_BUCKET_BITS = 3;
+    static constexpr uint32 SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr uint32 MAX_MAGNITUDE = 40;     // 2^40 ns, about 18 minutes
+    static constexpr uint32 BUCKETS = (MAX_MAGNITUDE - SUB_BUCKET_BITS + 2) * SUB_BUCKETS;
+
+    void Record(uint64 ns)
+    {
+        _buckets[BucketOf(ns)].fetch_add(1, std::memory_order_relaxed);
+        _count.fetch_add(1, std::memory_order_relaxed);
+        _sum.fetch_add(ns, std::memory_order_relaxed);
+        uint64 previous = _max.load(std::memory_order_relaxed);
+        while (ns > previous && !_max.compare_exchange_weak(previous, ns, std::memory_order_relaxed)) { }
+    }
+
+    uint64 Count() const { return _count.load(std::memory_order_relaxed); }
+    uint64 Sum() const { return _sum.load(std::memory_order_relaxed); }
+    uint64 Max() const { return _max.load(std::memory_order_relaxed); }
+
+    // Highest value of the bucket holding the given percentile, capped at the recorded maximum.
+    uint64 Percentile(double percentile) const
+    {
+        uint64 total = Count();
+        if (!total)
+            return 0;
+        uint64 rank = std::max<uint64>(1, uint64(std::ceil(total * percentile / 100.0)));
+        uint64 seen = 0;
+        for (uint32 i = 0; i < BUCKETS; ++i)
+        {
+            seen += _buckets[i].load(std::memory_order_relaxed);
+            if (seen >= rank)
+                return std::min(BucketHighest(i), Max());
+        }
+        return Max();
+    }
+
+    void Reset()
+    {
+        for (std::atomic<uint64>& bucket : _buckets)
+            bucket.store(0, std::memory_order_relaxed);
+        _count.store(0, std::memory_order_relaxed);
+        _sum.store(0, std::memory_order_relaxed);
+        _max.store(0, std::memory_order_relaxed);
+    }
+
+    static uint32 BucketOf(uint64 ns)
+    {
+        if (ns < SUB_BUCKETS)
+            return uint32(ns);
+        uint32 magnitude = std::min<uint32>(TrialHighestBit(ns), MAX_MAGNITUDE);
+        uint32 shift = magnitude - SUB_BUCKET_BITS;
+        return (magnitude - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + uint32((ns >> shift) & (SUB_BUCKETS - 1));
+    }
+
+    static uint64 BucketHighest(uint32 bucket)
+    {
+        if (bucket < SUB_BUCKETS)
+            return bucket;
+        uint32 shift = bucket / SUB_BUCKETS - 1;
+        uint64 lowest = uint64(SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+        return lowest + (uint64(1) << shift) - 1;
+    }
+
+private:
+    std::array<std::atomic<uint64>, BUCKETS> _buckets{};
+    std::atomic<uint64> _count{ 0 };
+    std::atomic<uint64> _sum{ 0 };
+    std::atomic<uint64> _max{ 0 };
+};
+
+struct TrialPerfProfile
+{
+    uint32 InstanceId = 0;
+    std::atomic<uint64> StartedAtNs{ 0 };
+    std::array<TrialPerfHistogram, TRIAL_PERF_SECTION_COUNT> Sections;
+};
+
+inline uint64 TrialPerfNowNs()
+{
+    return uint64(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Live instance profiles for `.trial perf <instanceId>`, plus the realm-wide aggregate. The registry lock
+// is only taken when an instance is created or destroyed and by the command, never per sample.
+class TrialProfiler
+{
+public:
+    static TrialProfiler* instance() { static TrialProfiler instance; return &instance; }
+
+    std::shared_ptr<TrialPerfProfile> Register(uint32 instanceId)
+    {
+        std::shared_ptr<TrialPerfProfile> profile = std::make_shared<TrialPerfProfile>();
+        profile->InstanceId = instanceId;
+        profile->StartedAtNs.store(TrialPerfNowNs(), std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(_lock);
+        _profiles[instanceId] = profile;
+        return profile;
+    }
+
+    void Unregister(uint32 instanceId)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _profiles.erase(instanceId);
+    }
+
+    std::shared_ptr<TrialPerfProfile> Find(uint32 instanceId)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        auto it = _profiles.find(instanceId);
+        return it != _profiles.end() ? it->second : nullptr;
+    }
+
+    std::vector<uint32> GetInstanceIds()
+    {
+        std::vector<uint32> ids;
+        std::lock_guard<std::mutex> lock(_lock);
+        for (auto const& pair : _profiles)
+            ids.push_back(pair.first);
+        return ids;
+    }
+
+    TrialPerfProfile& Aggregate() { return _aggregate; }
+
+    void ResetAll()
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        for (auto const& pair : _profiles)
+        {
+            for (TrialPerfHistogram& histogram : pair.second->Sections)
+                histogram.Reset();
+            pair.second->StartedAtNs.store(TrialPerfNowNs(), std::memory_order_relaxed);
+        }
+        for (TrialPerfHistogram& histogram : _aggregate.Sections)
+            histogram.Reset();
+        _aggregate.StartedAtNs.store(TrialPerfNowNs(), std::memory_order_relaxed);
+    }
+
+private:
+    TrialProfiler() { _aggregate.StartedAtNs.store(TrialPerfNowNs(), std::memory_order_relaxed); }
+    ~TrialProfiler() { }
+    TrialProfiler(const TrialProfiler&) = delete;
+    TrialProfiler& operator=(const TrialProfiler&) = delete;
+
+    std::mutex _lock;
+    std::map<uint32, std::shared_ptr<TrialPerfProfile>> _profiles;
+    TrialPerfProfile _aggregate;
+};
+
+class TrialPerfScope
+{
+public:
+    TrialPerfScope(TrialPerfProfile* profile, TrialPerfSection section) : _profile(profile), _section(section), _startNs(TrialPerfNowNs()) { }
+    ~TrialPerfScope()
+    {
+        uint64 elapsed = TrialPerfNowNs() - _startNs;
+        if (_profile)
+            _profile->Sections[_section].Record(elapsed);
+        TrialProfiler::instance()->Aggregate().Sections[_section].Record(elapsed);
+    }
+
+private:
+    TrialPerfProfile* _profile;
+    TrialPerfSection _section;
+    uint64 _startNs;
+};
+
+#if TRIAL_OF_FINALITY_PROFILER
+#define TRIAL_PERF_SCOPE(section) TrialPerfScope trialPerfScope##section(perfProfile.get(), section)
+#else
+#define TRIAL_PERF_SCOPE(section) ((void)0)
+#endif
+
+// --- Metrics ---
+// Operational counters for the Prometheus exporter. Every thread that records gets its own shard, so a
+// map thread only ever adds to memory no other thread writes; the exporter sums the shards when it
+// writes the file. Gauges such as creatures alive are kept as +/- deltas and summed the same way.
+enum TrialMetric : uint8
+{
+    TRIAL_METRIC_TRIALS_STARTED = 0,
+    TRIAL_METRIC_TRIALS_COMPLETED,
+    TRIAL_METRIC_TRIALS_FAILED,
+    TRIAL_METRIC_TRIALS_FORFEITED,
+    TRIAL_METRIC_TRIALS_ACTIVE,         // Gauge
+    TRIAL_METRIC_WAVES_SPAWNED,
+    TRIAL_METRIC_CREATURES_ALIVE,       // Gauge
+    TRIAL_METRIC_PERMADEATHS,
+    TRIAL_METRIC_DB_QUERIES,
+    TRIAL_METRIC_DB_QUERY_MICROS,
+    TRIAL_METRIC_COUNT
+};
+
+class TrialMetrics
+{
+public:
+    static void Add(TrialMetric metric, int64 value = 1)
+    {
+        std::atomic<int64>& slot = LocalShard().Values[metric];
+        slot.store(slot.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    // Time from issuing a module query to having its result.
+    static void RecordDbLatency(uint64 startNs)
+    {
+        Add(TRIAL_METRIC_DB_QUERIES);
+        Add(TRIAL_METRIC_DB_QUERY_MICROS, int64((TrialPerfNowNs() - startNs) / 1000));
+    }
+
+    static std::array<int64, TRIAL_METRIC_COUNT> Collect()
+    {
+        std::array<int64, TRIAL_METRIC_COUNT> totals{};
+        std::lock_guard<std::mutex> lock(ShardLock());
+        for (std::unique_ptr<Shard> const& shard : Shards())
+            for (uint8 i = 0; i < TRIAL_METRIC_COUNT; ++i)
+                totals[i] += shard->Values[i].load(std::memory_order_relaxed);
+        return totals;
+    }
+
+private:
+    struct alignas(64) Shard
+    {
+        std::array<std::atomic<int64>, TRIAL_METRIC_COUNT> Values{};
+    };
+
+    // Shards outlive their threads; the map and world threads are fixed, so there are only a few.
+    static Shard& LocalShard()
+    {
+        thread_local Shard* shard = nullptr;
+        if (!shard)
+        {
+            std::lock_guard<std::mutex> lock(ShardLock());
+            Shards().push_back(std::make_unique<Shard>());
+            shard = Shards().back().get();
+        }
+        return *shard;
+    }
+
+    static std::mutex& ShardLock() { static std::mutex lock; return lock; }
+    static std::vector<std::unique_ptr<Shard>>& Shards() { static std::vector<std::unique_ptr<Shard>> shards; return shards; }
+};
+
+// --- Run Tracer ---
+// Opt-in timeline of one trial run in the Chrome Trace Event format, for Perfetto or chrome://tracing.
+// Events are fixed-size records in a per-instance ring buffer allocated once when the instance is
+// created; names are string literals, so recording never allocates. Only the newest events are kept.
+enum TrialTraceTrack : uint8
+{
+    TRIAL_TRACE_TRACK_TRIAL = 1,        // Waves, announcements, spawns, outcome
+    TRIAL_TRACE_TRACK_CREATURES,        // Summons and kills; Id is the creature entry
+    TRIAL_TRACE_TRACK_PLAYERS,          // Downs, resurrections, boundary, votes; Id is the character guid
+    TRIAL_TRACE_TRACK_BOTS              // Stress test bots; Id is the bot's index, not a character
+};
+
+struct TrialTraceEvent
+{
+    uint64 StartUs;
+    uint32 DurationUs;                  // Spans only
+    uint32 Id;
+    const char* Name;
+    uint8 Track;
+    char Phase;                         // 'X' span, 'i' instant
+    uint16 Wave;
+};
+
+class TrialTraceBuffer
+{
+public:
+    explicit TrialTraceBuffer(uint32 capacity) : _events(std::max<uint32>(capacity, 16)), _originNs(TrialPerfNowNs()), _originUnix(time(nullptr)) { }
+
+    uint64 NowUs() const { return (TrialPerfNowNs() - _originNs) / 1000; }
+
+    void Instant(TrialTraceTrack track, const char* name, uint32 wave, uint32 id = 0)
+    {
+        Push({ NowUs(), 0, id, name, uint8(track), 'i', uint16(wave) });
+    }
+
+    void Span(TrialTraceTrack track, const char* name, uint64 startUs, uint32 wave, uint32 id = 0)
+    {
+        Push({ startUs, uint32(NowUs() - startUs), id, name, uint8(track), 'X', uint16(wave) });
+    }
+
+    bool Empty() const { return _recorded == 0; }
+    uint64 Recorded() const { return _recorded; }
+    time_t OriginUnix() const { return _originUnix; }
+
+    // Writes the buffer oldest first. Player names are looked up at write time.
+    bool WriteJson(const std::string& path, uint32 instanceId) const
+    {
+        std::ostringstream out;
+        out << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"instance\":" << instanceId << ",\"started\":" << uint64(_originUnix)
+            << ",\"dropped\":" << (_recorded > _events.size() ? _recorded - _events.size() : 0) << "},\"traceEvents\":[\n";
+        out << "{\"ph\":\"M\",\"pid\":" << instanceId << ",\"name\":\"process_name\",\"args\":{\"name\":\"Trial instance " << instanceId << "\"}},\n";
+        static const char* const trackNames[] = { "", "Trial", "Creatures", "Players", "Stress bots" };
+        for (uint8 track = TRIAL_TRACE_TRACK_TRIAL; track <= TRIAL_TRACE_TRACK_BOTS; ++track)
+            out << "{\"ph\":\"M\",\"pid\":" << instanceId << ",\"tid\":" << uint32(track) << ",\"name\":\"thread_name\",\"args\":{\"name\":\"" << trackNames[track] << "\"}},\n";
+
+        uint64 count = std::min<uint64>(_recorded, _events.size());
+        uint64 first = _recorded - count;
+        for (uint64 i = 0; i < count; ++i)
+        {
+            TrialTraceEvent const& event = _events[(first + i) % _events.size()];
+            out << "{\"name\":\"" << event.Name << "\",\"ph\":\"" << event.Phase << "\",\"ts\":" << event.StartUs
+                << ",\"pid\":" << instanceId << ",\"tid\":" << uint32(event.Track);
+            if (event.Phase == 'X')
+                out << ",\"dur\":" << event.DurationUs;
+            else
+                out << ",\"s\":\"t\"";
+            out << ",\"args\":{\"wave\":" << event.Wave;
+            if (event.Track == TRIAL_TRACE_TRACK_CREATURES && event.Id)
+                out << ",\"entry\":" << event.Id;
+            else if (event.Track == TRIAL_TRACE_TRACK_PLAYERS && event.Id)
+            {
+                std::string name;
+                sCharacterCache->GetCharacterNameByGuid(ObjectGuid::Create<HighGuid::Player>(event.Id), name);
+                out << ",\"guid\":" << event.Id << ",\"player\":\"" << name << "\"";
+            }
+            else if (event.Track == TRIAL_TRACE_TRACK_BOTS)
+                out << ",\"player\":\"bot " << event.Id << "\"";
+            out << "}}" << (i + 1 < count ? ",\n" : "\n");
+        }
+        out << "]}\n";
+
+        FILE* file = fopen(path.c_str(), "w");
+        if (!file)
+            return false;
+        std::string text = out.str();
+        bool written = fwrite(text.data(), 1, text.size(), file) == text.size();
+        return (fclose(file) == 0) && written;
+    }
+
+private:
+    void Push(TrialTraceEvent const& event)
+    {
+        _events[_recorded % _events.size()] = event;
+        ++_recorded;
+    }
+
+    std::vector<TrialTraceEvent> _events;
+    uint64 _recorded = 0;
+    uint64 _originNs;
+    time_t _originUnix;
+};
+
+// Records a span from construction to destruction when the instance is traced.
+class TrialTraceScope
+{
+public:
+    TrialTraceScope(TrialTraceBuffer* buffer, TrialTraceTrack track, const char* name, uint32 wave)
+        : _buffer(buffer), _track(track), _name(name), _wave(wave), _startUs(buffer ? buffer->NowUs() : 0) { }
+    ~TrialTraceScope()
+    {
+        if (_buffer)
+            _buffer->Span(_track, _name, _startUs, _wave);
+    }
+
+private:
+    TrialTraceBuffer* _buffer;
+    TrialTraceTrack _track;
+    const char* _name;
+    uint32 _wave;
+    uint64 _startUs;
+};
+
+// Traced instances and pending `.trial trace dump` requests. A dump is written by the instance's own
+// map thread on its next update, never by the command's thread.
+class TrialTraceRegistry
+{
+public:
+    static TrialTraceRegistry* instance() { static TrialTraceRegistry instance; return &instance; }
+
+    void Register(uint32 instanceId) { std::lock_guard<std::mutex> lock(_lock); _traced.insert(instanceId); }
+    void Unregister(uint32 instanceId) { std::lock_guard<std::mutex> lock(_lock); _traced.erase(instanceId); _requests.erase(instanceId); }
+
+    bool RequestDump(uint32 instanceId)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        if (!_traced.count(instanceId))
+            return false;
+        _requests.insert(instanceId);
+        _hasRequests.store(true, std::memory_order_release);
+        return true;
+    }
+
+    bool TakeRequest(uint32 instanceId)
+    {
+        if (!_hasRequests.load(std::memory_order_acquire))
+            return false;
+        std::lock_guard<std::mutex> lock(_lock);
+        bool requested = _requests.erase(instanceId) > 0;
+        _hasRequests.store(!_requests.empty(), std::memory_order_release);
+        return requested;
+    }
+
+    std::vector<uint32> GetTracedInstances()
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        return std::vector<uint32>(_traced.begin(), _traced.end());
+    }
+
+private:
+    TrialTraceRegistry() { }
+    ~TrialTraceRegistry() { }
+    TrialTraceRegistry(const TrialTraceRegistry&) = delete;
+    TrialTraceRegistry& operator=(const TrialTraceRegistry&) = delete;
+
+    std::mutex _lock;
+    std::atomic<bool> _hasRequests{ false };
+    std::set<uint32> _traced;
+    std::set<uint32> _requests;
+};
+
+// --- Combat Black Box ---
+// A ring of fixed-size records per participant (damage taken, heals received, auras, positions),
+// allocated when the participant is set up so recording in combat never allocates. Nothing is written
+// unless the participant is perma-deathed; then the last BlackBox.Seconds are compressed into a file
+// that tools/trial_blackbox_decode turns into a timeline. The format is in trial_blackbox_format.h.
+class TrialBlackBox
+{
+public:
+    void Init(uint32 capacity)
+    {
+        _records.assign(std::max<uint32>(capacity, 64), BlackBox::Record());
+        _count = 0;
+        _originNs = TrialPerfNowNs();
+        _originUnix = time(nullptr);
+    }
+
+    void Push(BlackBox::Record record)
+    {
+        record.TimeMs = uint32((TrialPerfNowNs() - _originNs) / 1000000);
+        _records[_count % _records.size()] = record;
+        ++_count;
+    }
+
+    // Compresses the records of the last windowMs, oldest first, and writes them to path.
+    bool Flush(const std::string& path, BlackBox::Header header, uint32 windowMs) const
+    {
+        uint64 available = std::min<uint64>(_count, _records.size());
+        uint32 nowMs = uint32((TrialPerfNowNs() - _originNs) / 1000000);
+        uint32 cutoffMs = nowMs > windowMs ? nowMs - windowMs : 0;
+
+        std::vector<uint8> raw;
+        raw.reserve(available * BlackBox::RECORD_SIZE);
+        for (uint64 i = _count - available; i < _count; ++i)
+        {
+            BlackBox::Record const& record = _records[i % _records.size()];
+            if (record.TimeMs < cutoffMs)
+                continue;
+            raw.resize(raw.size() + BlackBox::RECORD_SIZE);
+            BlackBox::EncodeRecord(record, raw.data() + raw.size() - BlackBox::RECORD_SIZE);
+        }
+
+        uLongf compressedSize = compressBound(uLong(raw.size()));
+        std::vector<uint8> compressed(BlackBox::HEADER_SIZE + compressedSize);
+        if (compress2(compressed.data() + BlackBox::HEADER_SIZE, &compressedSize, raw.data(), uLong(raw.size()), Z_BEST_COMPRESSION) != Z_OK)
+            return false;
+
+        header.StartedUnix = uint64(_originUnix);
+        header.FlushedUnix = uint64(time(nullptr));
+        header.RecordCount = uint32(raw.size() / BlackBox::RECORD_SIZE);
+        header.CompressedSize = uint32(compressedSize);
+        BlackBox::EncodeHeader(header, compressed.data());
+        compressed.resize(BlackBox::HEADER_SIZE + compressedSize);
+
+        FILE* file = fopen(path.c_str(), "wb");
+        if (!file)
+            return false;
+        bool written = fwrite(compressed.data(), 1, compressed.size(), file) == compressed.size();
+        return (fclose(file) == 0) && written;
+    }
+
+private:
+    std::vector<BlackBox::Record> _records;
+    uint64 _count = 0;
+    uint64 _originNs = 0;
+    time_t _originUnix = 0;
+};
+
+// --- Stress Test ---
+// `.trial stress` starts many trials at once to measure what the realm can carry before a release event.
+// Each bot group gets its own instance map. The wave program, creature summons, scheduler, event log
+// rows and snapshots are all real; only the players are replaced by bots kept inside the instance
+// script. Bots wear the creatures down at a configured pace and are downed and resurrected at random.
+// They never touch character data, so there is no perma-death, leaderboard entry, announcement or reward.
+enum TrialStressOutcome : uint8
+{
+    STRESS_OUTCOME_RUNNING = 0,
+    STRESS_OUTCOME_CLEARED,
+    STRESS_OUTCOME_WIPED,
+    STRESS_OUTCOME_STOPPED,
+    STRESS_OUTCOME_COUNT
+};
+
+// Written by the instance on its map thread, read by the world thread.
+struct TrialStressInstanceStats
+{
+    uint32 InstanceId = 0;
+    bool Released = false;                          // World thread only: the map was asked to unload
+    std::atomic<uint8> Outcome{ STRESS_OUTCOME_RUNNING };
+    std::atomic<uint32> WavesCleared{ 0 };
+    std::atomic<uint32> Downs{ 0 };
+    std::atomic<uint64> DbWrites{ 0 };
+    TrialPerfHistogram TickIntervalNs;              // Time between two updates of the instance
+    TrialPerfHistogram UpdateNs;                    // Cost of the instance script's update, bots included
+    TrialPerfHistogram SpawnLatencyNs;              // From a wave's due time until its creatures are summoned
+
+    void Reset()
+    {
+        Outcome.store(STRESS_OUTCOME_RUNNING);
+        WavesCleared.store(0);
+        Downs.store(0);
+        DbWrites.store(0);
+        TickIntervalNs.Reset();
+        UpdateNs.Reset();
+        SpawnLatencyNs.Reset();
+    }
+};
+
+// Set while a stress instance runs its own code, so the database writes it causes are counted for it.
+thread_local TrialStressInstanceStats* CurrentStressInstance = nullptr;
+
+class TrialStressScope
+{
+public:
+    explicit TrialStressScope(TrialStressInstanceStats* stats) : _previous(CurrentStressInstance) { CurrentStressInstance = stats; }
+    ~TrialStressScope() { CurrentStressInstance = _previous; }
+
+private:
+    TrialStressInstanceStats* _previous;
+};
+
+inline void CountTrialDbWrite()
+{
+    if (CurrentStressInstance)
+        CurrentStressInstance->DbWrites.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Resident set size of the worldserver, 0 where it cannot be read.
+static uint64 GetResidentBytes()
+{
+#ifdef __linux__
+    unsigned long long pages = 0, resident = 0;
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (!statm)
+        return 0;
+    bool read = fscanf(statm, "%llu %llu", &pages, &resident) == 2;
+    fclose(statm);
+    return read ? uint64(resident) * uint64(sysconf(_SC_PAGESIZE)) : 0;
+#else
+    return 0;
+#endif
+}
+
+// The running (or last) stress test. The instance list is only touched on the world thread; instances
+// record into their own stats and into the aggregate, both lock-free.
+class TrialStressRegistry
+{
+public:
+    static TrialStressRegistry* instance() { static TrialStressRegistry instance; return &instance; }
+
+    bool IsRunning() const { return _running; }
+    bool HasRun() const { return _startedAtMs != 0; }
+
+    void Begin(uint32 groupSize, uint8 level)
+    {
+        _instances.clear();
+        _aggregate.Reset();
+        _groupSize = groupSize;
+        _level = level;
+        _startedAtMs = getMSTime();
+        _endedAtMs = 0;
+        _residentAtStart = GetResidentBytes();
+        _peakResident = _residentAtStart;
+        _checkTimer = 1000;
+        _running = true;
+    }
+
+    std::shared_ptr<TrialStressInstanceStats> Add(uint32 instanceId)
+    {
+        std::shared_ptr<TrialStressInstanceStats> stats = std::make_shared<TrialStressInstanceStats>();
+        stats->InstanceId = instanceId;
+        _instances.push_back(stats);
+        return stats;
+    }
+
+    const std::vector<std::shared_ptr<TrialStressInstanceStats>>& GetInstances() const { return _instances; }
+    TrialStressInstanceStats& Aggregate() { return _aggregate; }
+
+    // Unloads the maps of finished trials and reports once the last one is gone.
+    void Update(uint32 diff)
+    {
+        if (!_running)
+            return;
+        if (_checkTimer > diff)
+        {
+            _checkTimer -= diff;
+            return;
+        }
+        _checkTimer = 1000;
+        _peakResident = std::max(_peakResident, GetResidentBytes());
+
+        bool allReleased = true;
+        for (std::shared_ptr<TrialStressInstanceStats> const& stats : _instances)
+        {
+            if (stats->Released)
+                continue;
+            if (stats->Outcome.load() == STRESS_OUTCOME_RUNNING)
+            {
+                allReleased = false;
+                continue;
+            }
+            // Nobody is bound to the map; a global reset unloads it on the next map update and drops its save.
+            if (Map* map = sMapMgr->FindMap(ArenaMapID, stats->InstanceId))
+                if (InstanceMap* instanceMap = map->ToInstanceMap())
+                    instanceMap->Reset(INSTANCE_RESET_GLOBAL);
+            stats->Released = true;
+        }
+
+        if (allReleased)
+        {
+            _running = false;
+            _endedAtMs = getMSTime();
+            for (std::string const& line : BuildReport())
+                sLog->outInfo("sys", "[TrialOfFinality] %s", line.c_str());
+        }
+    }
+
+    std::vector<std::string> BuildReport()
+    {
+        std::vector<std::string> lines;
+        char line[256];
+        uint32 outcomes[STRESS_OUTCOME_COUNT] = {};
+        for (std::shared_ptr<TrialStressInstanceStats> const& stats : _instances)
+            ++outcomes[stats->Outcome.load()];
+        uint32 count = std::max<uint32>(1, uint32(_instances.size()));
+        uint32 seconds = std::max<uint32>(1, getMSTimeDiff(_startedAtMs, _running ? getMSTime() : _endedAtMs) / IN_MILLISECONDS);
+
+        snprintf(line, sizeof(line), "Stress test: %u instances of %u bots at level %u, %u s%s: %u running, %u cleared, %u wiped, %u stopped.",
+            uint32(_instances.size()), _groupSize, uint32(_level), seconds, _running ? " so far" : "",
+            outcomes[STRESS_OUTCOME_RUNNING], outcomes[STRESS_OUTCOME_CLEARED], outcomes[STRESS_OUTCOME_WIPED], outcomes[STRESS_OUTCOME_STOPPED]);
+        lines.push_back(line);
+        snprintf(line, sizeof(line), "Tick interval p50 %.0f ms, p99 %.0f ms, max %.0f ms; instance update p50 %.1f us, p99 %.1f us.",
+            _aggregate.TickIntervalNs.Percentile(50) / 1e6, _aggregate.TickIntervalNs.Percentile(99) / 1e6, _aggregate.TickIntervalNs.Max() / 1e6,
+            _aggregate.UpdateNs.Percentile(50) / 1e3, _aggregate.UpdateNs.Percentile(99) / 1e3);
+        lines.push_back(line);
+        snprintf(line, sizeof(line), "Wave spawn latency p50 %.1f ms, p99 %.1f ms, max %.1f ms over %llu waves; %u downs.",
+            _aggregate.SpawnLatencyNs.Percentile(50) / 1e6, _aggregate.SpawnLatencyNs.Percentile(99) / 1e6, _aggregate.SpawnLatencyNs.Max() / 1e6,
+            (unsigned long long)_aggregate.SpawnLatencyNs.Count(), _aggregate.Downs.load());
+        lines.push_back(line);
+        uint64 dbWrites = _aggregate.DbWrites.load();
+        snprintf(line, sizeof(line), "Database writes: %llu (%.1f per instance, %.1f per second).",
+            (unsigned long long)dbWrites, double(dbWrites) / count, double(dbWrites) / seconds);
+        lines.push_back(line);
+        if (_residentAtStart)
+        {
+            uint64 resident = _running ? std::max(_peakResident, GetResidentBytes()) : _peakResident;
+            double growth = (double(resident) - double(_residentAtStart)) / 1024.0;
+            snprintf(line, sizeof(line), "Resident memory peaked %.1f MB above its size at launch, %.0f KB per instance.", growth / 1024.0, growth / count);
+        }
+        else
+            snprintf(line, sizeof(line), "Resident memory is not available on this platform.");
+        lines.push_back(line);
+
+        // The instances with the longest tick intervals, where a map thread struggled most.
+        std::vector<std::shared_ptr<TrialStressInstanceStats>> slowest = _instances;
+        size_t shown = std::min<size_t>(3, slowest.size());
+        std::partial_sort(slowest.begin(), slowest.begin() + shown, slowest.end(), [](auto const& a, auto const& b)
+        {
+            return a->TickIntervalNs.Percentile(99) > b->TickIntervalNs.Percentile(99);
+        });
+        for (size_t i = 0; i < shown; ++i)
+        {
+            snprintf(line, sizeof(line), "  Instance %u: tick p99 %.0f ms, spawn latency max %.1f ms, %u waves cleared, %u downs, %llu database writes.",
+                slowest[i]->InstanceId, slowest[i]->TickIntervalNs.Percentile(99) / 1e6, slowest[i]->SpawnLatencyNs.Max() / 1e6,
+                slowest[i]->WavesCleared.load(), slowest[i]->Downs.load(), (unsigned long long)slowest[i]->DbWrites.load());
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+private:
+    TrialStressRegistry() { }
+    ~TrialStressRegistry() { }
+    TrialStressRegistry(const TrialStressRegistry&) = delete;
+    TrialStressRegistry& operator=(const TrialStressRegistry&) = delete;
+
+    std::vector<std::shared_ptr<TrialStressInstanceStats>> _instances;
+    TrialStressInstanceStats _aggregate;
+    uint32 _groupSize = 0;
+    uint8 _level = 0;
+    uint32 _startedAtMs = 0;
+    uint32 _endedAtMs = 0;
+    uint64 _residentAtStart = 0;
+    uint64 _peakResident = 0;
+    uint32 _checkTimer = 0;
+    bool _running = false;
+};
+
 // --- Instance Script for the Trial ---
 // This class will manage the state and events for a single Trial of Finality instance.
 struct instance_trial_of_finality : public InstanceScript
 {
     instance_trial_of_finality(Map* map) : InstanceScript(map) { }
 
+    ~instance_trial_of_finality()
+    {
+        if (metricsTrialActive)
+            TrialMetrics::Add(TRIAL_METRIC_TRIALS_ACTIVE, -1);
+        if (perfProfile)
+            TrialProfiler::instance()->Unregister(perfProfile->InstanceId);
+        if (trace)
+            TrialTraceRegistry::instance()->Unregister(instance->GetInstanceId());
+        if (stressStats && stressStats->Outcome.load() == STRESS_OUTCOME_RUNNING)
+            stressStats->Outcome.store(STRESS_OUTCOME_STOPPED); // Unloaded mid-run, e.g. on shutdown
+    }
+
     // --- State Tracking ---
     uint32 currentWave;
     uint8 highestLevelAtStart;
@@ -57,912 +882,4048 @@ struct instance_trial_of_finality : public InstanceScript
     std::set<ObjectGuid> playersWarnedForLeavingArena;
     bool isTestTrial;
 
-    // Forfeit Vote
+    // Arrival Barrier: the instance stays in the lobby until every expected member has loaded in
+    bool inLobby;
+    uint32 lobbyTimer;
+    uint32 lobbyGroupId;
+    std::set<ObjectGuid> expectedPlayers;
+    std::set<ObjectGuid> arrivedPlayers;
+
+    // Session Resume: participants who disconnected and may still return (guid -> disconnect time)
+    std::map<ObjectGuid, uint32> disconnectedPlayers;
+    uint32 resumeCheckTimer;
+
+    // Spectators: invisible observers in the map who take no part in the trial
+    std::set<ObjectGuid> spectators;
+
+    // Leaderboards
+    uint32 trialStartMs;
+    bool runRecovered;          // Restarted from a snapshot; its duration is not comparable
+
+    // Ambient Crowd: passive stand fillers, all driven by one batched emote timer
+    static constexpr uint32 CROWD_REACTION_TICK_MS = 250;
+    std::vector<ObjectGuid> crowd;
+    bool crowdSpawned;
+    bool spawningCrowd;
+    uint32 crowdEmoteTimer;
+    uint32 crowdCheerCursor;    // Next member to cheer after a wave clear; crowd.size() when no reaction is playing
+    uint32 crowdMapDiffMs;      // Smoothed map update time, for the load cut-off
+
+    // Tick Profiler
+    std::shared_ptr<TrialPerfProfile> perfProfile;
+
+    // Metrics: counted in the trials-active gauge between ReleaseLobby and CleanupTrial
+    bool metricsTrialActive;
+
+    // Combat Black Box: one recorder per participant, flushed only on perma-death
+    std::unordered_map<ObjectGuid, TrialBlackBox> blackBoxes;
+    uint32 blackBoxPositionTimer;
+
+    // Run Tracer: null unless Trace.Enable was set when the instance was created
+    std::unique_ptr<TrialTraceBuffer> trace;
+    uint32 traceDumps;
+
+    // Snapshots: written at phase transitions only, coalesced to one write per update
+    TrialSnapshotPhase snapshotPhase;
+    bool snapshotDirty;
+    bool recoveringFromSnapshot;
+
+    // Arena Boundary
+    struct BoundaryState : TrialBoundaryState
+    {
+        bool Dirty = false;         // Moved since the last coalesced check
+    };
+    std::unordered_map<ObjectGuid, BoundaryState> boundaryStates;
+    std::vector<ObjectGuid> boundaryDirtyPlayers;
+    uint32 boundaryClockMs;
+
+    // Forfeit Vote
     bool forfeitVoteInProgress;
     time_t forfeitVoteStartTime;
     std::set<ObjectGuid> playersWhoVotedForfeit;
 
-    // --- Overridden Hooks ---
-    uint32 boundaryCheckTimer;
-    uint32 forfeitCheckTimer;
+    // Stress Test: set only for `.trial stress` instances, whose participants are bots 1..stressGroupSize
+    static constexpr uint32 STRESS_COMBAT_TICK_MS = 1000;
+    std::unique_ptr<TrialRunState> stressRun;
+    std::shared_ptr<TrialStressInstanceStats> stressStats;
+    uint32 stressGroupSize;
+    uint32 stressCombatTimer;
+    uint64 stressSpawnDueNs;
+
+    // --- Overridden Hooks ---
+    // Movement marks players dirty; dirty players are checked together every BOUNDARY_COALESCE_MS.
+    // The slow sweep catches position changes that do not come with a movement packet.
+    static constexpr uint32 BOUNDARY_COALESCE_MS = 250;
+    static constexpr uint32 BOUNDARY_SWEEP_MS = 5000;
+    uint32 boundaryCheckTimer;
+    uint32 boundarySweepTimer;
+    uint32 forfeitCheckTimer;
+
+    void Initialize() override
+    {
+        // Set up the instance for the configured wave program (each wave is a boss encounter)
+        SetBossNumber(WaveProgram.size());
+        currentWave = 0;
+        forfeitVoteInProgress = false;
+        boundaryCheckTimer = BOUNDARY_COALESCE_MS;
+        boundarySweepTimer = BOUNDARY_SWEEP_MS;
+        boundaryClockMs = 0;
+        forfeitCheckTimer = 1000;
+        inLobby = false;
+        lobbyTimer = 0;
+        lobbyGroupId = 0;
+        resumeCheckTimer = 1000;
+        trialStartMs = 0;
+        runRecovered = false;
+        crowdSpawned = false;
+        spawningCrowd = false;
+        crowdEmoteTimer = 0;
+        crowdCheerCursor = 0;
+        crowdMapDiffMs = 0;
+        snapshotPhase = SNAPSHOT_PHASE_NONE;
+        snapshotDirty = false;
+        recoveringFromSnapshot = false;
+        highestLevelAtStart = 0;
+        isTestTrial = false;
+        metricsTrialActive = false;
+        traceDumps = 0;
+        blackBoxPositionTimer = 0;
+        stressGroupSize = 0;
+        stressCombatTimer = 0;
+        stressSpawnDueNs = 0;
+        if (TraceEnable)
+        {
+            trace = std::make_unique<TrialTraceBuffer>(TraceCapacity);
+            TrialTraceRegistry::instance()->Register(instance->GetInstanceId());
+        }
+#if TRIAL_OF_FINALITY_PROFILER
+        perfProfile = TrialProfiler::instance()->Register(instance->GetInstanceId());
+#endif
+    }
+
+    void Update(uint32 diff) override
+    {
+        TRIAL_PERF_SCOPE(TRIAL_PERF_UPDATE);
+        TrialStressScope stressScope(stressStats.get());
+        uint64 stressUpdateStartNs = stressStats ? TrialPerfNowNs() : 0;
+        {
+            TRIAL_PERF_SCOPE(TRIAL_PERF_SCHEDULER);
+            scheduler.Update(diff);
+        }
+
+        // --- Stress Test Bots ---
+        if (stressRun && !stressRun->IsOver())
+        {
+            if (stressCombatTimer <= diff)
+            {
+                stressCombatTimer = STRESS_COMBAT_TICK_MS;
+                UpdateStressBots();
+            }
+            else
+                stressCombatTimer -= diff;
+        }
+
+        // --- Run Tracer ---
+        if (trace && TrialTraceRegistry::instance()->TakeRequest(instance->GetInstanceId()))
+            DumpTrace();
+
+        // --- Combat Black Box ---
+        if (!blackBoxes.empty())
+        {
+            if (blackBoxPositionTimer <= diff)
+            {
+                blackBoxPositionTimer = BlackBoxPositionIntervalMs;
+                RecordBlackBoxPositions();
+            }
+            else
+                blackBoxPositionTimer -= diff;
+        }
+
+        // --- Arrival Barrier ---
+        if (inLobby)
+        {
+            if (lobbyTimer <= diff)
+                ReleaseLobby();
+            else
+                lobbyTimer -= diff;
+        }
+
+        // --- Ambient Crowd ---
+        if (CrowdEnable)
+        {
+            crowdMapDiffMs = (crowdMapDiffMs * 7 + diff) / 8;
+            if (!crowd.empty())
+                UpdateCrowd(diff);
+        }
+
+        // --- Session Resume Grace ---
+        if (resumeCheckTimer <= diff)
+        {
+            resumeCheckTimer = 1000;
+            if (!disconnectedPlayers.empty())
+                ExpireDisconnectedPlayers();
+        }
+        else
+        {
+            resumeCheckTimer -= diff;
+        }
+
+        // --- Boundary Check ---
+        boundaryClockMs += diff;
+        if (boundarySweepTimer <= diff)
+        {
+            boundarySweepTimer = BOUNDARY_SWEEP_MS;
+            boundaryCheckTimer = BOUNDARY_COALESCE_MS; // The sweep covers the dirty players too
+            if (GetBossState(currentWave -1) == IN_PROGRESS)
+                CheckPlayerLocationsAndEnforceBoundaries(true);
+        }
+        else if (boundaryCheckTimer <= diff)
+        {
+            boundarySweepTimer -= diff;
+            boundaryCheckTimer = BOUNDARY_COALESCE_MS;
+            if (GetBossState(currentWave -1) == IN_PROGRESS)
+                CheckPlayerLocationsAndEnforceBoundaries(false);
+        }
+        else
+        {
+            boundarySweepTimer -= diff;
+            boundaryCheckTimer -= diff;
+        }
+
+        // --- Forfeit Vote Check ---
+        if (forfeitCheckTimer <= diff)
+        {
+            forfeitCheckTimer = 1000; // Reset timer
+            if (forfeitVoteInProgress)
+            {
+                // Timeout Check
+                if (IsForfeitVoteExpired(forfeitVoteStartTime, time(nullptr)))
+                {
+                    forfeitVoteInProgress = false;
+                    playersWhoVotedForfeit.clear();
+                    LogTrialDbEvent(TRIAL_EVENT_FORFEIT_VOTE_CANCEL, lobbyGroupId, nullptr, currentWave, highestLevelAtStart, "Vote timed out.");
+                    TraceInstant(TRIAL_TRACE_TRACK_TRIAL, "ForfeitVoteCancel");
+                    DoForAllParticipants([](Player* player)
+                    {
+                        TrialTextCache::instance()->SendNotification(player, TRIAL_STRING_FORFEIT_VOTE_TIMED_OUT);
+                    });
+                }
+            }
+        }
+        else
+        {
+            forfeitCheckTimer -= diff;
+        }
+
+        if (snapshotDirty)
+            WriteSnapshot();
+
+        if (stressStats)
+        {
+            uint64 updateNs = TrialPerfNowNs() - stressUpdateStartNs;
+            TrialStressInstanceStats& aggregate = TrialStressRegistry::instance()->Aggregate();
+            stressStats->TickIntervalNs.Record(uint64(diff) * 1000000);
+            stressStats->UpdateNs.Record(updateNs);
+            aggregate.TickIntervalNs.Record(uint64(diff) * 1000000);
+            aggregate.UpdateNs.Record(updateNs);
+        }
+    }
+
+    // --- Participants and Spectators ---
+    bool IsSpectator(Player* player) const { return spectators.count(player->GetGUID()) > 0; }
+
+    template<typename Callback>
+    void DoForAllParticipants(Callback&& callback)
+    {
+        instance->DoForAllPlayers([this, &callback](Player* player)
+        {
+            if (!IsSpectator(player))
+                callback(player);
+        });
+    }
+
+    Player* GetAnyParticipant()
+    {
+        Player* found = nullptr;
+        DoForAllParticipants([&found](Player* player) { if (!found) found = player; });
+        return found;
+    }
+
+    void OnSpectatorEnter(Player* player)
+    {
+        spectators.insert(player->GetGUID());
+        SetTrialSpectatorState(player, true);
+        TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_SPECTATE_JOINED);
+        sLog->outInfo("sys", "[TrialOfFinality] %s is spectating instance %u (%u spectators).", player->GetName().c_str(), instance->GetInstanceId(), uint32(spectators.size()));
+    }
+
+    void OnPlayerLeave(Player* player) override
+    {
+        if (spectators.erase(player->GetGUID()))
+        {
+            WorldLocation returnPoint;
+            TrialSpectatorRegistry::instance()->Remove(player->GetSession(), returnPoint); // Left by other means than StopSpectating
+            SetTrialSpectatorState(player, false);
+        }
+    }
+
+    // Sends every observer back to where they started watching from.
+    void ReleaseSpectators()
+    {
+        std::vector<Player*> watching;
+        instance->DoForAllPlayers([this, &watching](Player* player)
+        {
+            if (IsSpectator(player))
+                watching.push_back(player);
+        });
+        for (Player* player : watching)
+        {
+            spectators.erase(player->GetGUID());
+            StopSpectating(player);
+        }
+    }
+
+    // --- Ambient Crowd ---
+    bool IsMapUnderLoad() const { return CrowdDisableAboveDiffMs && crowdMapDiffMs > CrowdDisableAboveDiffMs; }
+
+    // Places the configured crowd once per instance. Members get a null AI, cannot be targeted and never
+    // join a fight; the only thing they do is play the emotes UpdateCrowd picks for them.
+    void SpawnCrowd()
+    {
+        crowdSpawned = true;
+        if (!CrowdEnable || CrowdLayout.empty() || CrowdEntries.empty())
+            return;
+        if (IsMapUnderLoad())
+        {
+            sLog->outDetail("[TrialOfFinality] Instance %u is updating in %u ms; the crowd is not placed.", instance->GetInstanceId(), crowdMapDiffMs);
+            return;
+        }
+
+        spawningCrowd = true;
+        crowd.reserve(CrowdLayout.size());
+        for (size_t i = 0; i < CrowdLayout.size(); ++i)
+        {
+            if (Creature* member = instance->SummonCreature(CrowdEntries[i % CrowdEntries.size()], CrowdLayout[i], TEMPSUMMON_MANUAL_DESPAWN))
+            {
+                member->SetAI(new NullCreatureAI(member));
+                member->SetReactState(REACT_PASSIVE);
+                member->SetFlag(UNIT_FIELD_FLAGS, UNIT_FLAG_NON_ATTACKABLE | UNIT_FLAG_NOT_SELECTABLE);
+                crowd.push_back(member->GetGUID());
+            }
+        }
+        spawningCrowd = false;
+        crowdCheerCursor = crowd.size();
+        crowdEmoteTimer = CrowdEmoteIntervalMs;
+        sLog->outDetail("[TrialOfFinality] Instance %u placed %u crowd members.", instance->GetInstanceId(), uint32(crowd.size()));
+    }
+
+    // At most CrowdEmotesPerTick emotes per tick: a few random ambient emotes every CrowdEmoteIntervalMs,
+    // or, after a wave clear, a cheer rolling through the stands in layout order every CROWD_REACTION_TICK_MS.
+    void UpdateCrowd(uint32 diff)
+    {
+        if (crowdEmoteTimer > diff)
+        {
+            crowdEmoteTimer -= diff;
+            return;
+        }
+
+        bool reacting = crowdCheerCursor < crowd.size();
+        crowdEmoteTimer = reacting ? CROWD_REACTION_TICK_MS : CrowdEmoteIntervalMs;
+        if (IsMapUnderLoad())
+        {
+            crowdCheerCursor = crowd.size(); // A reaction that cannot play now is dropped, not delayed
+            return;
+        }
+
+        static const uint32 ambientEmotes[] = { EMOTE_ONESHOT_APPLAUD, EMOTE_ONESHOT_SHOUT, EMOTE_ONESHOT_TALK, EMOTE_ONESHOT_POINT, EMOTE_ONESHOT_LAUGH };
+        for (uint32 i = 0; i < CrowdEmotesPerTick; ++i)
+        {
+            ObjectGuid guid;
+            uint32 emote = EMOTE_ONESHOT_CHEER;
+            if (reacting)
+            {
+                if (crowdCheerCursor >= crowd.size())
+                    break;
+                guid = crowd[crowdCheerCursor++];
+            }
+            else
+            {
+                guid = crowd[urand(0, crowd.size() - 1)];
+                emote = ambientEmotes[urand(0, std::size(ambientEmotes) - 1)];
+            }
+            if (Creature* member = instance->GetCreature(guid))
+                member->HandleEmoteCommand(emote);
+        }
+    }
+
+    void CrowdReactToWaveClear()
+    {
+        if (crowd.empty())
+            return;
+        crowdCheerCursor = 0;
+        crowdEmoteTimer = 0;
+    }
+
+    void DespawnCrowd()
+    {
+        for (ObjectGuid const& guid : crowd)
+            if (Creature* member = instance->GetCreature(guid))
+                member->DespawnOrUnsummon();
+        crowd.clear();
+        crowdCheerCursor = 0;
+    }
+
+    // --- Snapshots ---
+    void MarkSnapshotDirty(TrialSnapshotPhase phase)
+    {
+        snapshotPhase = phase;
+        snapshotDirty = true;
+    }
+
+    void WriteSnapshot()
+    {
+        snapshotDirty = false;
+        SaveToDB();
+    }
+
+    static void WriteGuidList(ByteBuffer& data, const std::set<ObjectGuid>& guids)
+    {
+        uint8 count = uint8(std::min<size_t>(guids.size(), 255));
+        data << count;
+        for (ObjectGuid const& guid : guids)
+        {
+            if (!count--)
+                break;
+            data << uint32(guid.GetCounter());
+        }
+    }
+
+    static void ReadGuidList(ByteBuffer& data, std::set<ObjectGuid>& guids)
+    {
+        uint8 count = data.read<uint8>();
+        for (uint8 i = 0; i < count; ++i)
+            guids.insert(ObjectGuid::Create<HighGuid::Player>(data.read<uint32>()));
+    }
+
+    std::string GetSaveData() override
+    {
+        ByteBuffer data;
+        data << SNAPSHOT_MAGIC << SNAPSHOT_VERSION << uint8(snapshotPhase) << uint8(currentWave) << highestLevelAtStart;
+        data << uint8((isTestTrial ? 0x01 : 0) | (forfeitVoteInProgress ? 0x02 : 0));
+        data << lobbyGroupId;
+        WriteGuidList(data, expectedPlayers);
+        WriteGuidList(data, permanentlyFailedPlayerGuids);
+        WriteGuidList(data, playersWhoVotedForfeit);
+        WriteGuidList(data, playersWarnedForLeavingArena);
+        data << uint8(std::min<size_t>(downedPlayerGuids.size(), 255));
+        uint8 written = 0;
+        for (auto const& [guid, downedAt] : downedPlayerGuids)
+        {
+            if (written++ == 255)
+                break;
+            data << uint32(guid.GetCounter()) << uint32(downedAt);
+        }
+
+        std::string encoded = Acore::Encoding::Base64::Encode(std::vector<uint8>(data.contents(), data.contents() + data.size()));
+        SnapshotStats.RecordWrite(encoded.size());
+        CountTrialDbWrite();
+        return encoded;
+    }
+
+    void Load(char const* in) override
+    {
+        if (!in || !*in)
+            return;
+
+        Optional<std::vector<uint8>> decoded = Acore::Encoding::Base64::Decode(in);
+        if (!decoded || decoded->empty())
+        {
+            ++SnapshotStats.Corrupt;
+            sLog->outError("sys", "[TrialOfFinality] Instance %u has unreadable save data; the trial cannot be recovered.", instance->GetInstanceId());
+            return;
+        }
+
+        ByteBuffer data;
+        data.append(decoded->data(), decoded->size());
+        try
+        {
+            uint16 magic = data.read<uint16>();
+            uint8 version = data.read<uint8>();
+            if (magic != SNAPSHOT_MAGIC || version == 0 || version > SNAPSHOT_VERSION)
+            {
+                ++SnapshotStats.Corrupt;
+                sLog->outError("sys", "[TrialOfFinality] Instance %u save data has magic %u version %u, which this build cannot read.", instance->GetInstanceId(), magic, version);
+                return;
+            }
+
+            snapshotPhase = TrialSnapshotPhase(data.read<uint8>());
+            currentWave = data.read<uint8>();
+            highestLevelAtStart = data.read<uint8>();
+            uint8 flags = data.read<uint8>();
+            isTestTrial = flags & 0x01;
+            lobbyGroupId = data.read<uint32>();
+            ReadGuidList(data, expectedPlayers);
+            ReadGuidList(data, permanentlyFailedPlayerGuids);
+            ReadGuidList(data, playersWhoVotedForfeit);
+            ReadGuidList(data, playersWarnedForLeavingArena);
+            uint8 downedCount = data.read<uint8>();
+            for (uint8 i = 0; i < downedCount; ++i)
+            {
+                ObjectGuid guid = ObjectGuid::Create<HighGuid::Player>(data.read<uint32>());
+                downedPlayerGuids[guid] = time_t(data.read<uint32>());
+            }
+        }
+        catch (ByteBufferException const&)
+        {
+            ++SnapshotStats.Corrupt;
+            sLog->outError("sys", "[TrialOfFinality] Instance %u save data is truncated; the trial cannot be recovered.", instance->GetInstanceId());
+            return;
+        }
+
+        // A vote that was running when the server stopped has lost its timer; it is dropped.
+        playersWhoVotedForfeit.clear();
+        recoveringFromSnapshot = snapshotPhase != SNAPSHOT_PHASE_NONE;
+        sLog->outInfo("sys", "[TrialOfFinality] Instance %u loaded a phase %u snapshot at wave %u with %u participants and %u downed.",
+            instance->GetInstanceId(), snapshotPhase, currentWave, uint32(expectedPlayers.size()), uint32(downedPlayerGuids.size()));
+    }
+
+    // Entry point after a restart. A run that was in a wave is recovered by restarting that wave once
+    // the group is back; a run that had not granted tokens yet, or had already applied its outcome, is
+    // resolved by sending everyone out with nothing gained or lost.
+    void HandleRecoveredPlayer(Player* player)
+    {
+        if (snapshotPhase == SNAPSHOT_PHASE_WAVE)
+        {
+            if (!inLobby)
+            {
+                ++SnapshotStats.Recovered;
+                for (uint32 wave = 1; wave < currentWave; ++wave)
+                    SetBossState(wave - 1, DONE);
+                inLobby = true;
+                lobbyTimer = ArrivalTimeoutMs;
+                sLog->outInfo("sys", "[TrialOfFinality] Instance %u recovering interrupted trial of group %u at wave %u.", instance->GetInstanceId(), lobbyGroupId, currentWave);
+            }
+            TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_RECOVERY_RESUMING);
+            arrivedPlayers.insert(player->GetGUID());
+            if (std::includes(arrivedPlayers.begin(), arrivedPlayers.end(), expectedPlayers.begin(), expectedPlayers.end()))
+                ReleaseLobby();
+            return;
+        }
+
+        if (arrivedPlayers.empty())
+        {
+            ++SnapshotStats.Resolved;
+            sLog->outInfo("sys", "[TrialOfFinality] Instance %u resolving interrupted trial of group %u (phase %u) without an outcome.", instance->GetInstanceId(), lobbyGroupId, snapshotPhase);
+        }
+        arrivedPlayers.insert(player->GetGUID());
+        player->DestroyItemCount(TrialTokenEntry, 1, true, false);
+        player->SetDisableXpGain(false, true);
+        TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_RECOVERY_RESOLVED);
+        if (ExitOverrideHearthstone)
+            player->TeleportTo(ExitMapID, ExitTeleportX, ExitTeleportY, ExitTeleportZ, ExitTeleportO);
+        else
+            player->TeleportTo(player->GetBindPoint());
+    }
+
+    void HandleMonsterKilled(Creature* creature)
+    {
+        TRIAL_PERF_SCOPE(TRIAL_PERF_MONSTER_KILLED);
+        if (activeMonsters.erase(creature->GetGUID()))
+        {
+            TrialMetrics::Add(TRIAL_METRIC_CREATURES_ALIVE, -1);
+            TraceInstant(TRIAL_TRACE_TRACK_CREATURES, "Kill", creature->GetEntry());
+            sLog->outDetail("[TrialOfFinality] Instance %u killed a trial monster. %lu remaining in wave %d.",
+                instance->GetInstanceId(), activeMonsters.size(), currentWave);
+
+            if (activeMonsters.empty())
+            {
+                sLog->outInfo("sys", "[TrialOfFinality] Instance %u has cleared wave %d.", instance->GetInstanceId(), currentWave);
+                SetBossState(currentWave - 1, DONE); // Mark current wave as done (wave 1 is boss 0)
+                TraceInstant(TRIAL_TRACE_TRACK_TRIAL, "WaveCleared");
+                CrowdReactToWaveClear();
+
+                // Clear any downed players from the previous wave - they are now safe
+                if (!downedPlayerGuids.empty())
+                {
+                    instance->DoForAllPlayers([this](Player* player)
+                    {
+                        if (downedPlayerGuids.count(player->GetGUID()))
+                        {
+                            TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_WAVE_SURVIVED);
+                        }
+                    });
+                    downedPlayerGuids.clear();
+                }
+
+                if (stressRun)
+                    AdvanceStressBots();
+
+                if (NextWaveStep(currentWave, WaveProgram.size()) == TRIAL_WAVE_STEP_NEXT)
+                {
+                    PrepareAndAnnounceWave(currentWave + 1);
+                    SetBossState(currentWave - 1, IN_PROGRESS);
+                }
+                else
+                {
+                    FinalizeTrialOutcome(true, "All " + std::to_string(WaveProgram.size()) + " waves successfully cleared.");
+                }
+            }
+        }
+    }
+
+    void OnCreatureCreate(Creature* creature) override
+    {
+        if (spawningCrowd)
+            return;
+
+        if (creature->GetEntry() == AnnouncerEntry)
+        {
+            announcerGuid = creature->GetGUID();
+        }
+        else if (creature->IsHostileToPlayers()) // A simple way to identify trial monsters
+        {
+            if (activeMonsters.insert(creature->GetGUID()).second)
+                TrialMetrics::Add(TRIAL_METRIC_CREATURES_ALIVE);
+        }
+    }
+
+    void OnPlayerEnter(Player* player) override
+    {
+        if (!player)
+        {
+            return;
+        }
+
+        if (TrialSpectatorRegistry::instance()->GetSpectatedInstance(player->GetGUID()) == instance->GetInstanceId())
+        {
+            OnSpectatorEnter(player);
+            return;
+        }
+
+        // A spectator who logged out in here; the login hook sends them back out.
+        if (TrialSpectatorRegistry::instance()->HasPendingReturn(player->GetGUID()))
+            return;
+
+        // A GM looking in on a stress test takes no part in it.
+        if (stressRun)
+            return;
+
+        if (recoveringFromSnapshot && (inLobby || GetBossState(0) == NOT_STARTED))
+        {
+            HandleRecoveredPlayer(player);
+            return;
+        }
+
+        // A participant returning within the grace period keeps their token and trial state.
+        if (disconnectedPlayers.count(player->GetGUID()))
+        {
+            HandlePlayerReconnect(player);
+            return;
+        }
+
+        // The first player to enter initializes the instance's difficulty and opens the lobby.
+        if (GetBossState(0) == NOT_STARTED && !inLobby)
+        {
+            if (PreTrialData* data = TrialManager::instance()->GetPreTrialData(player->GetGroup()->GetId()))
+            {
+                highestLevelAtStart = data->highestLevel;
+                isTestTrial = data->isTestTrial;
+                expectedPlayers.insert(data->expectedMembers.begin(), data->expectedMembers.end());
+                lobbyGroupId = player->GetGroup()->GetId();
+                TrialManager::instance()->CleanupPreTrialData(lobbyGroupId); // Clean up the cached data
+                sLog->outInfo("sys", "[TrialOfFinality] Instance %u initialized for group %u with highest level %u. Waiting for %u members to arrive.",
+                    instance->GetInstanceId(), lobbyGroupId, highestLevelAtStart, uint32(expectedPlayers.size()));
+
+                inLobby = true;
+                lobbyTimer = ArrivalTimeoutMs;
+                MarkSnapshotDirty(SNAPSHOT_PHASE_LOBBY);
+            }
+            else
+            {
+                sLog->outError("sys", "[TrialOfFinality] Could not find pre-trial data for group %u when entering instance %u. Aborting.", player->GetGroup()->GetId(), instance->GetInstanceId());
+                player->TeleportTo(player->GetBindPoint());
+                return;
+            }
+        }
+
+        if (inLobby)
+        {
+            // Nothing is granted while waiting; the barrier release sets everyone up in one pass.
+            arrivedPlayers.insert(player->GetGUID());
+            if (std::includes(arrivedPlayers.begin(), arrivedPlayers.end(), expectedPlayers.begin(), expectedPlayers.end()))
+                ReleaseLobby();
+            else
+                TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_LOBBY_WAITING);
+            return;
+        }
+
+        // Late arrival after the barrier was released
+        SetupTrialParticipant(player);
+    }
+
+    // Ends the lobby: grants tokens and disables XP for everyone present in one batch, then starts the wave timer.
+    void ReleaseLobby()
+    {
+        inLobby = false;
+
+        std::vector<Player*> participants;
+        DoForAllParticipants([&participants](Player* player) { participants.push_back(player); });
+        if (participants.empty())
+        {
+            sLog->outError("sys", "[TrialOfFinality] Instance %u lobby released with no players present.", instance->GetInstanceId());
+            return;
+        }
+
+        uint32 missing = 0;
+        for (ObjectGuid const& guid : expectedPlayers)
+            if (!arrivedPlayers.count(guid))
+                ++missing;
+        if (missing)
+            sLog->outInfo("sys", "[TrialOfFinality] Instance %u arrival timeout: %u of %u expected members did not arrive.", instance->GetInstanceId(), missing, uint32(expectedPlayers.size()));
+
+        for (Player* player : participants)
+            SetupTrialParticipant(player);
+
+        if (!crowdSpawned)
+            SpawnCrowd();
+
+        // Start Wave 1, or restart the wave a recovered trial was interrupted in
+        uint32 startWave = recoveringFromSnapshot ? std::max<uint32>(currentWave, 1) : 1;
+        runRecovered = recoveringFromSnapshot;
+        recoveringFromSnapshot = false;
+        trialStartMs = getMSTime();
+        if (!runRecovered)
+            TrialMetrics::Add(TRIAL_METRIC_TRIALS_STARTED);
+        if (!metricsTrialActive)
+        {
+            metricsTrialActive = true;
+            TrialMetrics::Add(TRIAL_METRIC_TRIALS_ACTIVE);
+        }
+        TraceInstant(TRIAL_TRACE_TRACK_TRIAL, runRecovered ? "TrialRecovered" : "TrialStart");
+        PrepareAndAnnounceWave(startWave);
+        SetBossState(startWave - 1, IN_PROGRESS);
+        MarkSnapshotDirty(SNAPSHOT_PHASE_WAVE);
+        std::string detail = "Trial started in instance with " + std::to_string(participants.size()) + "/" + std::to_string(expectedPlayers.size()) + " members.";
+        if (startWave > 1)
+            detail = "Trial recovered after a restart at wave " + std::to_string(startWave) + " with " + std::to_string(participants.size()) + "/" + std::to_string(expectedPlayers.size()) + " members.";
+        LogTrialDbEvent(TRIAL_EVENT_START, lobbyGroupId, participants.front(), startWave - 1, highestLevelAtStart, detail);
+    }
+
+    void SetupTrialParticipant(Player* player)
+    {
+        player->SetDisableXpGain(true, true);
+        if (!player->HasItemCount(TrialTokenEntry, 1, true)) // Recovered participants still hold theirs
+            player->AddItem(TrialTokenEntry, 1);
+        TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_TRIAL_BEGUN);
+        if (BlackBoxEnable && !blackBoxes.count(player->GetGUID()))
+            blackBoxes[player->GetGUID()].Init(BlackBoxMaxRecords);
+    }
+
+    // --- Wave Management ---
+    void PrepareAndAnnounceWave(uint32 waveNumber)
+    {
+        if (waveNumber == 0 || waveNumber > WaveProgram.size())
+        {
+            sLog->outError("sys", "[TrialOfFinality] Instance %u: Wave %u is not part of the configured wave program (%lu waves).", instance->GetInstanceId(), waveNumber, WaveProgram.size());
+            return;
+        }
+
+        const TrialWaveDescriptor& wave = WaveProgram[waveNumber - 1];
+        currentWave = waveNumber;
+        MarkSnapshotDirty(SNAPSHOT_PHASE_WAVE);
+        sLog->outInfo("sys", "[TrialOfFinality] Instance %u preparing for wave %d.", instance->GetInstanceId(), waveNumber);
+        LogTrialDbEvent(TRIAL_EVENT_WAVE_START, lobbyGroupId, nullptr, waveNumber, highestLevelAtStart, "Announcing wave.");
+        TraceInstant(TRIAL_TRACE_TRACK_TRIAL, "Announce");
+
+        Creature* announcer = nullptr;
+        if (announcerGuid.IsEmpty())
+        {
+            Position announcerPos = { ArenaTeleportX + 5.0f, ArenaTeleportY, ArenaTeleportZ, ArenaTeleportO };
+            announcer = instance->SummonCreature(AnnouncerEntry, announcerPos, TEMPSUMMON_MANUAL_DESPAWN);
+        }
+        else
+        {
+            announcer = instance->GetCreature(announcerGuid);
+        }
+
+        if (announcer)
+        {
+            if (auto* ai = dynamic_cast<npc_trial_announcer_ai*>(announcer->AI()))
+                ai->AnnounceWave(wave, waveNumber);
+            else
+            {
+                std::unordered_map<uint32, WorldPacket> packets;
+                npc_trial_announcer_ai::YellWaveLine(announcer, wave, waveNumber, packets);
+            }
+        }
+
+        if (stressStats)
+            stressSpawnDueNs = TrialPerfNowNs() + uint64(wave.DelayMs) * 1000000;
+        scheduler.Schedule(std::chrono::milliseconds(wave.DelayMs), [this]()
+        {
+            SpawnActualWave();
+        });
+    }
+
+    void SpawnActualWave()
+    {
+        TRIAL_PERF_SCOPE(TRIAL_PERF_SPAWN_WAVE);
+        TrialTraceScope traceSpawn(trace.get(), TRIAL_TRACE_TRACK_TRIAL, "SpawnWave", currentWave);
+        uint32 activePlayers = stressRun ? stressRun->GetStandingCount() : 0;
+        if (!stressRun)
+        {
+            DoForAllParticipants([&](Player* player)
+            {
+                if (player->IsAlive() && !downedPlayerGuids.count(player->GetGUID()))
+                    activePlayers++;
+            });
+        }
+
+        if (activePlayers == 0)
+        {
+            sLog->outError("sys", "[TrialOfFinality] Instance %u, Wave %d: No active players left to spawn wave for. Finalizing trial.", instance->GetInstanceId(), currentWave);
+            // FinalizeTrialOutcome(false, "All players defeated or disconnected before wave " + std::to_string(currentWave) + " could spawn."); // to be implemented
+            return;
+        }
+
+        if (currentWave == 0 || currentWave > WaveProgram.size() || currentWave > WaveSelectionTable.size()) {
+            sLog->outError("sys", "[TrialOfFinality] Instance %u, Wave %d: Cannot spawn wave. It is not part of the compiled wave program.", instance->GetInstanceId(), currentWave);
+            return;
+        }
+        const TrialWaveDescriptor& wave = WaveProgram[currentWave - 1];
+
+        // Pool and scaling rules are precompiled per wave and level band; this is a single lookup.
+        const TrialWaveSelection& selection = WaveSelectionTable[currentWave - 1][ClampTrialLevel(highestLevelAtStart)];
+        const std::vector<std::vector<uint32>>* currentWaveNpcPool = selection.Pool;
+        float healthMultiplier = 1.0f;
+        const std::vector<uint32>* aurasToAdd = nullptr;
+
+        if (NpcScalingMode == "custom_scaling_rules" && selection.Scaling) {
+            healthMultiplier = selection.Scaling->HealthMultiplier;
+            aurasToAdd = &selection.Scaling->AurasToAdd;
+        }
+
+        if (!currentWaveNpcPool || currentWaveNpcPool->empty()) {
+            sLog->outError("sys", "[TrialOfFinality] Instance %u, Wave %d: Cannot spawn wave. NPC pool for this difficulty and level %u is empty or not covered by a level band.", instance->GetInstanceId(), currentWave, highestLevelAtStart);
+            // FinalizeTrialOutcome(false, "Internal error: NPC pool empty for wave " + std::to_string(currentWave));
+            return;
+        }
+
+        if (wave.SpawnLayout.empty()) {
+            sLog->outError("sys", "[TrialOfFinality] Instance %u, Wave %d: Cannot spawn wave. No spawn positions are configured or loaded.", instance->GetInstanceId(), currentWave);
+            // FinalizeTrialOutcome(false, "Internal error: No spawn positions configured.");
+            return;
+        }
+        uint32 numSpawnsPerWave = wave.SpawnLayout.size();
+
+        uint32 numGroupsToSpawn = EncounterGroupCount(numSpawnsPerWave, activePlayers);
+
+        if (numGroupsToSpawn > currentWaveNpcPool->size()) {
+            sLog->outWarn("sys", "[TrialOfFinality] Instance %u, Wave %d: Requested %u encounter groups, but pool only has %lu. Spawning %lu instead.",
+                instance->GetInstanceId(), currentWave, numGroupsToSpawn, currentWaveNpcPool->size(), currentWaveNpcPool->size());
+            numGroupsToSpawn = currentWaveNpcPool->size();
+        }
+
+        // Seeded once per map thread; seeding from random_device on every wave costs more than the draw.
+        static thread_local std::mt19937 rng(std::random_device{}());
+        std::vector<uint32> spawnEntries;
+        SelectEncounterGroups(*currentWaveNpcPool, numGroupsToSpawn, numSpawnsPerWave, rng, spawnEntries);
+
+        sLog->outInfo("sys", "[TrialOfFinality] Instance %u, Wave %d: Spawning %u encounter groups. Highest Lvl: %u. Health Multi: %.2f",
+            instance->GetInstanceId(), currentWave, numGroupsToSpawn, highestLevelAtStart, healthMultiplier);
+        TrialMetrics::Add(TRIAL_METRIC_CREATURES_ALIVE, -int64(activeMonsters.size()));
+        activeMonsters.clear();
+        TrialMetrics::Add(TRIAL_METRIC_WAVES_SPAWNED);
+
+        for (size_t spawnPosIndex = 0; spawnPosIndex < spawnEntries.size(); ++spawnPosIndex)
+        {
+            uint32 creatureEntry = spawnEntries[spawnPosIndex];
+            const Position& spawnPos = wave.SpawnLayout[spawnPosIndex];
+            if (Creature* creature = instance->SummonCreature(creatureEntry, spawnPos, TEMPSUMMON_TIMED_DESPAWN_OUT_OF_COMBAT, 3600 * 1000))
+            {
+                TraceInstant(TRIAL_TRACE_TRACK_CREATURES, "Summon", creatureEntry);
+                creature->SetAI(new npc_trial_monster_ai(creature));
+                creature->SetLevel(highestLevelAtStart);
+                if (healthMultiplier != 1.0f)
+                {
+                    creature->SetMaxHealth(uint32(creature->GetMaxHealth() * healthMultiplier));
+                    creature->SetHealth(creature->GetMaxHealth());
+                }
+                if (aurasToAdd)
+                {
+                    for (uint32 auraId : *aurasToAdd)
+                        creature->AddAura(auraId, creature);
+                }
+                // No player is near a stress test's creatures; as active objects they update as if one were.
+                if (stressRun)
+                    creature->setActive(true);
+                // OnCreatureCreate will add to activeMonsters
+            }
+        }
+
+        if (stressStats && stressSpawnDueNs)
+        {
+            uint64 nowNs = TrialPerfNowNs();
+            uint64 latencyNs = nowNs > stressSpawnDueNs ? nowNs - stressSpawnDueNs : 0;
+            stressStats->SpawnLatencyNs.Record(latencyNs);
+            TrialStressRegistry::instance()->Aggregate().SpawnLatencyNs.Record(latencyNs);
+            stressSpawnDueNs = 0;
+        }
+    }
+
+    // --- Combat Black Box ---
+    static uint16 BlackBoxHealthPct(Unit* unit, int64 health)
+    {
+        uint32 maxHealth = std::max<uint32>(unit->GetMaxHealth(), 1);
+        return uint16(std::clamp<int64>(health, 0, maxHealth) * 10000 / maxHealth);
+    }
+
+    // Called from the unit hooks on this map's thread for every player in the map.
+    void RecordBlackBox(Unit* participant, BlackBox::RecordType type, Unit* source, uint32 value, uint32 aux = 0)
+    {
+        auto it = blackBoxes.find(participant->GetGUID());
+        if (it == blackBoxes.end())
+            return;
+
+        BlackBox::Record record;
+        record.Type = type;
+        record.Value = value;
+        record.Aux = aux;
+        if (source == participant)
+            record.Flags = BlackBox::FLAG_SOURCE_SELF;
+        else if (source && source->GetTypeId() == TYPEID_UNIT)
+        {
+            record.Flags = BlackBox::FLAG_SOURCE_CREATURE;
+            record.Source = source->GetEntry();
+        }
+        else if (source)
+            record.Source = source->GetGUID().GetCounter();
+
+        int64 health = participant->GetHealth();
+        if (type == BlackBox::RECORD_DAMAGE_TAKEN)
+            health -= value;
+        else if (type == BlackBox::RECORD_HEAL_RECEIVED)
+            health += value;
+        record.HealthPct = BlackBoxHealthPct(participant, health);
+        if (type == BlackBox::RECORD_DAMAGE_TAKEN || type == BlackBox::RECORD_HEAL_RECEIVED)
+            record.Aux = uint32(std::clamp<int64>(health, 0, participant->GetMaxHealth()));
+        it->second.Push(record);
+    }
+
+    void RecordBlackBoxPositions()
+    {
+        DoForAllParticipants([this](Player* player)
+        {
+            auto it = blackBoxes.find(player->GetGUID());
+            if (it == blackBoxes.end())
+                return;
+            BlackBox::Record record;
+            record.Type = BlackBox::RECORD_POSITION;
+            record.HealthPct = BlackBoxHealthPct(player, player->GetHealth());
+            record.Value = BlackBox::FloatBits(player->GetPositionX());
+            record.Aux = BlackBox::FloatBits(player->GetPositionY());
+            record.Aux2 = BlackBox::FloatBits(player->GetPositionZ());
+            it->second.Push(record);
+        });
+    }
+
+    void FlushBlackBox(ObjectGuid playerGuid, uint32 groupId)
+    {
+        auto it = blackBoxes.find(playerGuid);
+        if (it == blackBoxes.end())
+            return;
+
+        BlackBox::Header header;
+        header.CharacterGuid = playerGuid.GetCounter();
+        header.InstanceId = instance->GetInstanceId();
+        header.GroupId = groupId;
+        header.Wave = currentWave;
+        std::string path = BlackBoxDirectory + "/blackbox_" + std::to_string(playerGuid.GetCounter()) + "_" + std::to_string(uint64(time(nullptr))) + ".tfbb";
+        if (it->second.Flush(path, header, BlackBoxSeconds * IN_MILLISECONDS))
+            sLog->outInfo("sys", "[TrialOfFinality] Black box of GUID %u written to %s.", playerGuid.GetCounter(), path.c_str());
+        else
+            sLog->outError("sys", "[TrialOfFinality] Could not write the black box of GUID %u to %s.", playerGuid.GetCounter(), path.c_str());
+    }
+
+    // --- Run Tracer ---
+    void TraceInstant(TrialTraceTrack track, const char* name, uint32 id = 0)
+    {
+        if (trace)
+            trace->Instant(track, name, currentWave, id);
+    }
+
+    void DumpTrace()
+    {
+        if (!trace || trace->Empty())
+            return;
+        std::string path = TraceDirectory + "/trial_" + std::to_string(instance->GetInstanceId()) + "_" +
+            std::to_string(uint64(trace->OriginUnix())) + "_" + std::to_string(++traceDumps) + ".json";
+        if (trace->WriteJson(path, instance->GetInstanceId()))
+            sLog->outInfo("sys", "[TrialOfFinality] Instance %u trace written to %s (%llu events recorded).",
+                instance->GetInstanceId(), path.c_str(), (unsigned long long)trace->Recorded());
+        else
+            sLog->outError("sys", "[TrialOfFinality] Instance %u could not write its trace to %s.", instance->GetInstanceId(), path.c_str());
+    }
+
+    // --- Player State and Trial Outcome ---
+    void HandlePlayerDowned(Player* downedPlayer)
+    {
+        if (!downedPlayer) return;
+
+        ObjectGuid playerGuid = downedPlayer->GetGUID();
+        downedPlayerGuids[playerGuid] = time(nullptr);
+        MarkSnapshotDirty(SNAPSHOT_PHASE_WAVE);
+        uint32 groupId = downedPlayer->GetGroup() ? downedPlayer->GetGroup()->GetId() : 0;
+
+        sLog->outInfo("sys", "[TrialOfFinality] Player %s (GUID %s, Instance %u) has been downed in wave %d.",
+            downedPlayer->GetName().c_str(), playerGuid.ToString().c_str(), instance->GetInstanceId(), currentWave);
+
+        TrialTextCache::instance()->SendSysMessage(downedPlayer, TRIAL_STRING_PLAYER_DOWNED);
+        LogTrialDbEvent(TRIAL_EVENT_PLAYER_DEATH_TOKEN, groupId, downedPlayer, currentWave, highestLevelAtStart, "Player downed, awaiting resurrection or wave end.");
+        TraceInstant(TRIAL_TRACE_TRACK_PLAYERS, "Downed", playerGuid.GetCounter());
+        RecordBlackBox(downedPlayer, BlackBox::RECORD_DOWNED, nullptr, 0, currentWave);
+
+        CheckForWipe();
+    }
+
+    // Fails the trial once nobody is left standing. Members inside their reconnect grace period still
+    // count if they were not downed, so a dropped connection does not end the run for the group.
+    void CheckForWipe()
+    {
+        uint32 activePlayers = 0;
+        DoForAllParticipants([&](Player* player)
+        {
+            TrialMemberStatus status;
+            status.Alive = player->IsAlive();
+            status.Downed = downedPlayerGuids.count(player->GetGUID()) > 0;
+            if (IsMemberStanding(status))
+                activePlayers++;
+        });
+        for (auto const& [guid, disconnectedAt] : disconnectedPlayers)
+        {
+            TrialMemberStatus status;
+            status.Disconnected = true;
+            status.Downed = downedPlayerGuids.count(guid) > 0;
+            if (IsMemberStanding(status))
+                activePlayers++;
+        }
+
+        if (activePlayers == 0)
+        {
+            sLog->outInfo("sys", "[TrialOfFinality] All players in instance %u are downed. Finalizing trial as a failure.", instance->GetInstanceId());
+            FinalizeTrialOutcome(false, "All players were defeated.");
+        }
+    }
+
+    // --- Session Resume ---
+    void HandlePlayerDisconnect(Player* player)
+    {
+        if (IsSpectator(player) || inLobby || GetBossState(currentWave - 1) != IN_PROGRESS)
+            return;
+
+        ObjectGuid guid = player->GetGUID();
+        TrialResumeRecord record;
+        record.InstanceId = instance->GetInstanceId();
+        record.GroupId = player->GetGroup() ? player->GetGroup()->GetId() : 0;
+        auto downedItr = downedPlayerGuids.find(guid);
+        record.Downed = downedItr != downedPlayerGuids.end();
+        record.DownedAt = record.Downed ? downedItr->second : 0;
+        record.VotedForfeit = playersWhoVotedForfeit.count(guid) > 0;
+        record.WarnedForLeavingArena = playersWarnedForLeavingArena.count(guid) > 0;
+        record.DisconnectedAtMs = getMSTime();
+        TrialResumeRegistry::instance()->Store(guid, record);
+
+        disconnectedPlayers[guid] = record.DisconnectedAtMs;
+        playersWhoVotedForfeit.erase(guid); // Absent players neither vote nor block a vote
+        boundaryStates.erase(guid);
+
+        sLog->outInfo("sys", "[TrialOfFinality] Player %s (Instance %u) disconnected during wave %u; holding their place for %u seconds.",
+            player->GetName().c_str(), instance->GetInstanceId(), currentWave, ResumeGraceMs / IN_MILLISECONDS);
+        LogTrialDbEvent(TRIAL_EVENT_PLAYER_DISCONNECT, record.GroupId, player, currentWave, highestLevelAtStart, record.Downed ? "Disconnected while downed." : "Disconnected.");
+        TraceInstant(TRIAL_TRACE_TRACK_PLAYERS, "Disconnect", player->GetGUID().GetCounter());
+    }
+
+    void HandlePlayerReconnect(Player* player)
+    {
+        ObjectGuid guid = player->GetGUID();
+        disconnectedPlayers.erase(guid);
+
+        TrialResumeRecord record;
+        if (TrialResumeRegistry::instance()->Find(guid, record))
+        {
+            if (record.Downed && !downedPlayerGuids.count(guid))
+                downedPlayerGuids[guid] = record.DownedAt;
+            if (record.VotedForfeit && forfeitVoteInProgress)
+                playersWhoVotedForfeit.insert(guid);
+            if (record.WarnedForLeavingArena)
+                playersWarnedForLeavingArena.insert(guid);
+            TrialResumeRegistry::instance()->Remove(guid);
+        }
+
+        player->SetDisableXpGain(true, true);
+        sLog->outInfo("sys", "[TrialOfFinality] Player %s (Instance %u) reconnected during wave %u.", player->GetName().c_str(), instance->GetInstanceId(), currentWave);
+        LogTrialDbEvent(TRIAL_EVENT_PLAYER_RECONNECT, record.GroupId, player, currentWave, highestLevelAtStart, record.Downed ? "Reconnected while downed." : "Reconnected.");
+        TraceInstant(TRIAL_TRACE_TRACK_PLAYERS, "Reconnect", player->GetGUID().GetCounter());
+    }
+
+    void ExpireDisconnectedPlayers()
+    {
+        uint32 now = getMSTime();
+        bool expired = false;
+        for (auto it = disconnectedPlayers.begin(); it != disconnectedPlayers.end();)
+        {
+            if (getMSTimeDiff(it->second, now) > ResumeGraceMs)
+            {
+                // Abandoning the trial counts as being downed: the player shares the fate of any downed member.
+                sLog->outInfo("sys", "[TrialOfFinality] Player GUID %s did not return to instance %u within the grace period and is treated as downed.", it->first.ToString().c_str(), instance->GetInstanceId());
+                TrialResumeRegistry::instance()->Remove(it->first);
+                if (!downedPlayerGuids.count(it->first))
+                    downedPlayerGuids[it->first] = time(nullptr);
+                MarkSnapshotDirty(SNAPSHOT_PHASE_WAVE);
+                it = disconnectedPlayers.erase(it);
+                expired = true;
+            }
+            else
+                ++it;
+        }
+        if (expired && GetBossState(currentWave - 1) == IN_PROGRESS)
+            CheckForWipe();
+    }
+
+    void HandlePlayerResurrect(Player* player)
+    {
+        if (downedPlayerGuids.erase(player->GetGUID()))
+        {
+            MarkSnapshotDirty(SNAPSHOT_PHASE_WAVE);
+            uint32 groupId = player->GetGroup() ? player->GetGroup()->GetId() : 0;
+            sLog->outInfo("sys", "[TrialOfFinality] Player %s (GUID %s, Instance %u) was resurrected during the trial.",
+                player->GetName().c_str(), player->GetGUID().ToString().c_str(), instance->GetInstanceId());
+            TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_PLAYER_RESURRECTED);
+            LogTrialDbEvent(TRIAL_EVENT_PLAYER_RESURRECTED, groupId, player, currentWave, highestLevelAtStart, "Player resurrected mid-wave.");
+            TraceInstant(TRIAL_TRACE_TRACK_PLAYERS, "Resurrected", player->GetGUID().GetCounter());
+        }
+    }
+
+    void FinalizeTrialOutcome(bool overallSuccess, const std::string& reason)
+    {
+        TRIAL_PERF_SCOPE(TRIAL_PERF_FINALIZE);
+        uint64 traceStartUs = trace ? trace->NowUs() : 0;
+        uint32 groupId = lobbyGroupId;
+        Player* leader = GetAnyParticipant();
+
+        sLog->outInfo("sys", "[TrialOfFinality] Finalizing trial for instance %u. Overall Success: %s. Reason: %s.",
+            instance->GetInstanceId(), (overallSuccess ? "Yes" : "No"), reason.c_str());
+
+        // The core rules decide who is sealed and who wins; the GM exemption and every side effect stay here.
+        std::vector<uint32> participantIds, downedIds, alreadyFailedIds;
+        std::unordered_map<uint32, Player*> participantsById;
+        DoForAllParticipants([&participantIds, &participantsById](Player* player)
+        {
+            participantIds.push_back(player->GetGUID().GetCounter());
+            participantsById[player->GetGUID().GetCounter()] = player;
+        });
+        for (const auto& pair : downedPlayerGuids)
+            downedIds.push_back(pair.first.GetCounter());
+        for (ObjectGuid const& guid : permanentlyFailedPlayerGuids)
+            alreadyFailedIds.push_back(guid.GetCounter());
+        TrialOutcome outcome = ComputeTrialOutcome(overallSuccess, participantIds, downedIds, alreadyFailedIds);
+
+        if (!overallSuccess)
+        {
+            SetBossState(currentWave - 1, FAIL);
+            for (uint32 id : outcome.PermaFailed)
+            {
+                ObjectGuid playerGuid(HighGuid::Player, id);
+                if (!permanentlyFailedPlayerGuids.insert(playerGuid).second)
+                    continue; // Sealed earlier in the trial, when its side effects were applied
+                Player* downedPlayer = ObjectAccessor::FindPlayer(playerGuid);
+                if (downedPlayer && downedPlayer->GetSession())
+                {
+                    if (PermaDeathExemptGMs && downedPlayer->GetSession()->GetSecurity() >= SEC_GAMEMASTER)
+                    {
+                        sLog->outInfo("sys", "[TrialOfFinality] GM Player %s (GUID %s) is EXEMPT from perma-death.", downedPlayer->GetName().c_str(), playerGuid.ToString().c_str());
+                    }
+                    else
+                    {
+                        WriteTrialPermaDeathStatus(id, true);
+                        FlushBlackBox(playerGuid, groupId);
+                        sLog->outFatal("[TrialOfFinality] Player %s (GUID %s) PERMANENTLY FAILED due to trial failure: %s.", downedPlayer->GetName().c_str(), playerGuid.ToString().c_str(), reason.c_str());
+                        LogTrialDbEvent(TRIAL_EVENT_PERMADEATH_APPLIED, groupId, downedPlayer, currentWave, highestLevelAtStart, "Perma-death DB flag set: " + reason);
+                        TrialTextCache::instance()->SendSysMessage(downedPlayer, TRIAL_STRING_FATE_SEALED);
+                    }
+                }
+                else
+                {
+                    WriteTrialPermaDeathStatus(id, true);
+                    FlushBlackBox(playerGuid, groupId);
+                    sLog->outFatal("[TrialOfFinality] Offline Player (GUID %s) PERMANENTLY FAILED due to trial failure: %s.", playerGuid.ToString().c_str(), reason.c_str());
+                    LogTrialDbEvent(TRIAL_EVENT_PERMADEATH_APPLIED, groupId, nullptr, currentWave, highestLevelAtStart, "Offline Player - Perma-death DB flag set: " + reason);
+                }
+            }
+            downedPlayerGuids.clear();
+            LogTrialDbEvent(TRIAL_EVENT_TRIAL_FAILURE, groupId, leader, currentWave, highestLevelAtStart, reason);
+        }
+        else
+        {
+            LogTrialDbEvent(TRIAL_EVENT_TRIAL_SUCCESS, groupId, leader, currentWave, highestLevelAtStart, reason);
+
+            std::vector<ObjectGuid> winners;
+            std::vector<std::string> winnerNames;
+            for (uint32 id : outcome.Winners)
+            {
+                Player* player = participantsById[id];
+                winners.push_back(player->GetGUID());
+                winnerNames.push_back(player->GetName());
+            }
+
+            std::string leaderName = leader ? leader->GetName() : "";
+            if (leader && leader->GetGroup())
+                leaderName = leader->GetGroup()->GetLeaderName();
+            if (!stressRun)
+            {
+                TrialWorldAnnouncer::instance()->QueueVictory(groupId, std::move(leaderName), std::move(winnerNames));
+                TrialCheerManager::instance()->QueueVictory(groupId, std::move(winners));
+            }
+        }
+        RecordLeaderboards(overallSuccess);
+        TrialMetrics::Add(overallSuccess ? TRIAL_METRIC_TRIALS_COMPLETED : TRIAL_METRIC_TRIALS_FAILED);
+
+        // The outcome is applied; record that before anyone leaves so a crash now cannot apply it twice.
+        MarkSnapshotDirty(SNAPSHOT_PHASE_CONCLUDED);
+        WriteSnapshot();
+        if (trace)
+            trace->Span(TRIAL_TRACE_TRACK_TRIAL, overallSuccess ? "FinalizeSuccess" : "FinalizeFailure", traceStartUs, currentWave);
+        CleanupTrial(overallSuccess);
+        DumpTrace();
+        if (stressStats && stressStats->Outcome.load() == STRESS_OUTCOME_RUNNING)
+            stressStats->Outcome.store(overallSuccess ? STRESS_OUTCOME_CLEARED : stressRun->IsOver() ? STRESS_OUTCOME_WIPED : STRESS_OUTCOME_STOPPED);
+    }
+
+    // Offers every participant's result to the realm leaderboards. Test trials do not count.
+    void RecordLeaderboards(bool cleared)
+    {
+        if (!LeaderboardEnable || isTestTrial)
+            return;
+
+        TrialLeaderboardEntry entry;
+        entry.Waves = uint8(cleared ? WaveProgram.size() : (currentWave ? currentWave - 1 : 0));
+        if (!entry.Waves)
+            return;
+        entry.DurationMs = getMSTimeDiff(trialStartMs, getMSTime());
+        entry.AchievedAt = uint32(time(nullptr));
+        uint8 bandKey = GetTrialBandKey(highestLevelAtStart);
+        bool fastestEligible = cleared && !runRecovered;
+
+        DoForAllParticipants([&](Player* player)
+        {
+            entry.PlayerGuid = player->GetGUID().GetCounter();
+            entry.PlayerName = player->GetName();
+            entry.Class = player->getClass();
+            entry.Level = player->getLevel();
+            TrialLeaderboards::instance()->RecordRun(entry, bandKey, fastestEligible);
+        });
+    }
+
+    void CleanupTrial(bool success)
+    {
+        TRIAL_PERF_SCOPE(TRIAL_PERF_CLEANUP);
+        // Disconnected participants can no longer resume; their next login takes the normal path
+        TrialResumeRegistry::instance()->RemoveInstance(instance->GetInstanceId());
+        disconnectedPlayers.clear();
+        blackBoxes.clear();
+
+        // Despawn any remaining monsters
+        for (const auto& monsterGuid : activeMonsters)
+            if (Creature* monster = instance->GetCreature(monsterGuid))
+                monster->DespawnOrUnsummon();
+        TrialMetrics::Add(TRIAL_METRIC_CREATURES_ALIVE, -int64(activeMonsters.size()));
+        activeMonsters.clear();
+        if (metricsTrialActive)
+        {
+            metricsTrialActive = false;
+            TrialMetrics::Add(TRIAL_METRIC_TRIALS_ACTIVE, -1);
+        }
+
+        // Despawn announcer
+        if (!announcerGuid.IsEmpty())
+            if (Creature* announcer = instance->GetCreature(announcerGuid))
+                announcer->DespawnOrUnsummon();
+
+        DespawnCrowd();
+
+        ReleaseSpectators();
+
+        // Process all players in the instance
+        DoForAllParticipants([this, success](Player* player)
+        {
+            player->DestroyItemCount(TrialTokenEntry, 1, true, false);
+            player->SetDisableXpGain(false, true);
+
+            if (!permanentlyFailedPlayerGuids.count(player->GetGUID()))
+            {
+                 TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_TRIAL_CONCLUDED);
+                 if (ExitOverrideHearthstone)
+                     player->TeleportTo(ExitMapID, ExitTeleportX, ExitTeleportY, ExitTeleportZ, ExitTeleportO);
+                 else
+                     player->TeleportTo(player->GetBindPoint());
+            }
+        });
+
+        // Give rewards on success
+        if (success)
+        {
+            DoForAllParticipants([this](Player* player)
+            {
+                if (permanentlyFailedPlayerGuids.count(player->GetGUID())) return;
+
+                if (GoldReward > 0)
+                {
+                    player->ModifyMoney(GoldReward);
+                    TrialTextCache::instance()->PSendSysMessage(player, TRIAL_STRING_GOLD_AWARDED, GoldReward / 10000);
+                }
+                if (TitleRewardID > 0)
+                {
+                    if (CharTitlesEntry const* titleEntry = sCharTitlesStore.LookupEntry(TitleRewardID))
+                    {
+                        player->SetTitle(titleEntry);
+                        TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_TITLE_GRANTED);
+                    }
+                }
+            });
+        }
+
+        // If it was a test trial with a temporary group, disband it
+        if (isTestTrial)
+        {
+            if (Player* p = GetAnyParticipant())
+                if (Group* group = p->GetGroup())
+                {
+                    sLog->outDetail("[TrialOfFinality] Disbanding temporary test trial group %u for instance %u.", group->GetId(), instance->GetInstanceId());
+                    group->Disband();
+                }
+        }
+
+        // The instance will be destroyed automatically when the last player leaves.
+        // No need to manually manage trial info maps anymore.
+        sLog->outInfo("sys", "[TrialOfFinality] Cleaned up trial for instance %u.", instance->GetInstanceId());
+    }
+
+    // Called from the movement hook on the map thread; the actual check is deferred to the next coalesced tick.
+    void MarkPlayerMoved(Player* player)
+    {
+        if (IsSpectator(player))
+            return;
+        BoundaryState& state = boundaryStates[player->GetGUID()];
+        if (!state.Dirty)
+        {
+            state.Dirty = true;
+            boundaryDirtyPlayers.push_back(player->GetGUID());
+        }
+    }
+
+    void CheckPlayerLocationsAndEnforceBoundaries(bool fullSweep)
+    {
+        TRIAL_PERF_SCOPE(TRIAL_PERF_BOUNDARY);
+        uint32 groupId = lobbyGroupId;
+
+        // Take the pending list first; ending the trial below may move players again.
+        std::vector<ObjectGuid> toCheck;
+        toCheck.swap(boundaryDirtyPlayers);
+        for (ObjectGuid const& guid : toCheck)
+            boundaryStates[guid].Dirty = false;
+
+        if (fullSweep)
+        {
+            toCheck.clear();
+            DoForAllParticipants([&toCheck](Player* player) { toCheck.push_back(player->GetGUID()); });
+        }
+        else
+        {
+            // Players already outside are re-checked every tick so the warning grace period is enforced
+            // even while they stand still.
+            for (auto const& [guid, state] : boundaryStates)
+                if (state.Outside && std::find(toCheck.begin(), toCheck.end(), guid) == toCheck.end())
+                    toCheck.push_back(guid);
+        }
+
+        for (ObjectGuid const& guid : toCheck)
+        {
+            Player* player = ObjectAccessor::GetPlayer(instance, guid);
+            if (player && EnforceBoundary(player, groupId))
+                break;
+        }
+    }
+
+    // Returns true if the trial was ended by this player's violation.
+    bool EnforceBoundary(Player* player, uint32 groupId)
+    {
+        if (GetBossState(currentWave - 1) != IN_PROGRESS)
+            return true;
+        if (!player->IsAlive() || (GMDebugEnable && player->GetSession()->GetSecurity() >= SEC_GAMEMASTER))
+            return false;
+
+        BoundaryState& state = boundaryStates[player->GetGUID()];
+        TrialBoundaryZone zone = ArenaBoundary.Classify(player->GetPositionX(), player->GetPositionY(), player->GetPositionZ());
+
+        bool warnedBefore = playersWarnedForLeavingArena.count(player->GetGUID()) > 0;
+        TrialBoundaryAction action = DecideBoundaryAction(state, zone, warnedBefore, boundaryClockMs, ArenaBoundaryWarningGraceMs);
+        if (action == BOUNDARY_ACTION_NONE)
+            return false;
+        if (action == BOUNDARY_ACTION_WARN)
+        {
+            playersWarnedForLeavingArena.insert(player->GetGUID());
+            TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_ARENA_WARNING);
+            LogTrialDbEvent(TRIAL_EVENT_PLAYER_WARNED_ARENA_LEAVE, groupId, player, currentWave, highestLevelAtStart, "Player left arena boundary and was warned.");
+            TraceInstant(TRIAL_TRACE_TRACK_PLAYERS, "BoundaryWarning", player->GetGUID().GetCounter());
+            return false;
+        }
+
+        sLog->outWarn("sys", "[TrialOfFinality] Player %s (Instance %u) left the arena after being warned. Failing the trial.", player->GetName().c_str(), instance->GetInstanceId());
+        std::string reason = player->GetName() + " has fled the Trial of Finality, forfeiting the challenge for the group.";
+        LogTrialDbEvent(TRIAL_EVENT_PLAYER_FORFEIT_ARENA, groupId, player, currentWave, highestLevelAtStart, reason);
+        TraceInstant(TRIAL_TRACE_TRACK_PLAYERS, "BoundaryFail", player->GetGUID().GetCounter());
+        FinalizeTrialOutcome(false, reason);
+        return true;
+    }
+
+    void HandleTrialForfeit(Player* player)
+    {
+        if (IsSpectator(player))
+        {
+            TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_FORFEIT_OUTSIDE_TRIAL);
+            return;
+        }
+
+        if (playersWhoVotedForfeit.count(player->GetGUID()))
+        {
+            TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_FORFEIT_ALREADY_VOTED);
+            return;
+        }
+
+        uint32 activePlayers = 0;
+        DoForAllParticipants([&](Player* p) {
+            TrialMemberStatus status;
+            status.Alive = p->IsAlive();
+            status.PermaFailed = permanentlyFailedPlayerGuids.count(p->GetGUID()) > 0;
+            if (IsForfeitVoter(status))
+                activePlayers++;
+        });
+
+        if (activePlayers == 0)
+        {
+            TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_FORFEIT_NO_VOTERS);
+            return;
+        }
+
+        uint32 groupId = player->GetGroup() ? player->GetGroup()->GetId() : 0;
+
+        if (!forfeitVoteInProgress)
+        {
+            forfeitVoteInProgress = true;
+            forfeitVoteStartTime = time(nullptr);
+            playersWhoVotedForfeit.insert(player->GetGUID());
+            LogTrialDbEvent(TRIAL_EVENT_FORFEIT_VOTE_START, groupId, player, currentWave, highestLevelAtStart, "Forfeit vote started.");
+            TraceInstant(TRIAL_TRACE_TRACK_PLAYERS, "ForfeitVoteStart", player->GetGUID().GetCounter());
+            std::string name = player->GetName();
+            TrialLocalizedNotification notice(TRIAL_STRING_FORFEIT_VOTE_STARTED, name.c_str(), activePlayers);
+            instance->DoForAllPlayers([&notice](Player* target) { notice.Send(target); });
+        }
+        else
+        {
+            playersWhoVotedForfeit.insert(player->GetGUID());
+            TraceInstant(TRIAL_TRACE_TRACK_PLAYERS, "ForfeitVote", player->GetGUID().GetCounter());
+            std::string name = player->GetName();
+            TrialLocalizedNotification notice(TRIAL_STRING_FORFEIT_VOTE_CAST, name.c_str(), uint32(playersWhoVotedForfeit.size()), activePlayers);
+            instance->DoForAllPlayers([&notice](Player* target) { notice.Send(target); });
+        }
+
+        if (IsForfeitVotePassed(playersWhoVotedForfeit.size(), activePlayers))
+        {
+            std::string reason = "The group has unanimously voted to forfeit the trial.";
+            LogTrialDbEvent(TRIAL_EVENT_FORFEIT_VOTE_SUCCESS, groupId, player, currentWave, highestLevelAtStart, reason);
+            TrialMetrics::Add(TRIAL_METRIC_TRIALS_FORFEITED);
+            TraceInstant(TRIAL_TRACE_TRACK_TRIAL, "ForfeitVoteSuccess");
+            // The trial is over; a crash from here on must not let a recovered participant restart the wave.
+            MarkSnapshotDirty(SNAPSHOT_PHASE_CONCLUDED);
+            WriteSnapshot();
+            CleanupTrial(false);
+            DumpTrace();
+        }
+    }
+
+    // --- Stress Test ---
+    // Starts the wave program for a group of bots; called by `.trial stress` right after the map is created.
+    void StartStressTrial(std::shared_ptr<TrialStressInstanceStats> stats, uint32 groupSize, uint8 level)
+    {
+        stressStats = std::move(stats);
+        TrialStressScope stressScope(stressStats.get());
+        stressGroupSize = groupSize;
+        stressRun = std::make_unique<TrialRunState>(uint32(WaveProgram.size()), ArenaBoundaryWarningGraceMs);
+        for (uint32 bot = 1; bot <= groupSize; ++bot)
+            stressRun->AddParticipant(bot);
+        stressRun->Start();
+        stressCombatTimer = STRESS_COMBAT_TICK_MS;
+
+        highestLevelAtStart = level;
+        isTestTrial = true; // Keeps the run off the leaderboards
+        lobbyGroupId = 0;
+        if (!crowdSpawned)
+            SpawnCrowd();
+        trialStartMs = getMSTime();
+        TrialMetrics::Add(TRIAL_METRIC_TRIALS_STARTED);
+        metricsTrialActive = true;
+        TrialMetrics::Add(TRIAL_METRIC_TRIALS_ACTIVE);
+        TraceInstant(TRIAL_TRACE_TRACK_TRIAL, "TrialStart");
+        PrepareAndAnnounceWave(1);
+        SetBossState(0, IN_PROGRESS);
+        MarkSnapshotDirty(SNAPSHOT_PHASE_WAVE);
+        LogTrialDbEvent(TRIAL_EVENT_START, 0, nullptr, 0, level, "Stress trial started with " + std::to_string(groupSize) + " bots.");
+    }
+
+    // One second of a bot fight: the downed may be raised, the standing bots hit the first living creature
+    // so that it dies in StressSecondsPerCreature at full strength, and every creature may down a bot.
+    void UpdateStressBots()
+    {
+        if (activeMonsters.empty() || GetBossState(currentWave - 1) != IN_PROGRESS)
+            return; // Between waves
+
+        static thread_local std::mt19937 rng(std::random_device{}());
+        std::uniform_real_distribution<float> roll(0.0f, 1.0f);
+
+        for (uint32 bot = 1; bot <= stressGroupSize; ++bot)
+        {
+            if (stressRun->GetMember(bot)->Downed && roll(rng) < StressResurrectChance)
+            {
+                stressRun->OnResurrected(bot);
+                MarkSnapshotDirty(SNAPSHOT_PHASE_WAVE);
+                LogTrialDbEvent(TRIAL_EVENT_PLAYER_RESURRECTED, 0, nullptr, currentWave, highestLevelAtStart, "Stress bot " + std::to_string(bot) + " resurrected.");
+                TraceInstant(TRIAL_TRACE_TRACK_BOTS, "Resurrected", bot);
+            }
+        }
+
+        uint32 attackers = uint32(activeMonsters.size());
+        Creature* target = nullptr;
+        for (ObjectGuid const& guid : activeMonsters)
+        {
+            target = instance->GetCreature(guid);
+            if (target && target->IsAlive())
+                break;
+            target = nullptr;
+        }
+        if (target)
+        {
+            uint32 damage = uint32(target->GetMaxHealth() * stressRun->GetStandingCount() / (float(stressGroupSize) * StressSecondsPerCreature)) + 1;
+            if (damage >= target->GetHealth())
+                target->KillSelf(); // JustDied reaches HandleMonsterKilled, as for a kill by a player
+            else
+                target->ModifyHealth(-int32(damage));
+        }
+
+        for (uint32 i = 0; i < attackers && !stressRun->IsOver() && GetBossState(currentWave - 1) == IN_PROGRESS; ++i)
+        {
+            if (roll(rng) >= StressDownChance)
+                continue;
+            std::vector<uint32> standing;
+            for (uint32 bot = 1; bot <= stressGroupSize; ++bot)
+                if (IsMemberStanding(*stressRun->GetMember(bot)))
+                    standing.push_back(bot);
+            if (!standing.empty())
+                HandleStressBotDowned(standing[urand(0, standing.size() - 1)]);
+        }
+    }
+
+    void HandleStressBotDowned(uint32 bot)
+    {
+        stressStats->Downs.fetch_add(1, std::memory_order_relaxed);
+        TrialStressRegistry::instance()->Aggregate().Downs.fetch_add(1, std::memory_order_relaxed);
+        MarkSnapshotDirty(SNAPSHOT_PHASE_WAVE);
+        LogTrialDbEvent(TRIAL_EVENT_PLAYER_DEATH_TOKEN, 0, nullptr, currentWave, highestLevelAtStart, "Stress bot " + std::to_string(bot) + " downed.");
+        TraceInstant(TRIAL_TRACE_TRACK_BOTS, "Downed", bot);
+        if (stressRun->OnDowned(bot))
+            FinalizeTrialOutcome(false, "All players were defeated.");
+    }
+
+    // The wave is cleared: the downed survived it, and the intermission raises every bot.
+    void AdvanceStressBots()
+    {
+        stressStats->WavesCleared.fetch_add(1, std::memory_order_relaxed);
+        TrialStressRegistry::instance()->Aggregate().WavesCleared.fetch_add(1, std::memory_order_relaxed);
+        stressRun->OnWaveCleared();
+        for (uint32 bot = 1; bot <= stressGroupSize; ++bot)
+            stressRun->OnResurrected(bot);
+    }
+
+    // `.trial stress stop`, on the world thread while no map is updating.
+    void AbortStressTrial()
+    {
+        if (!stressStats || stressStats->Outcome.load() != STRESS_OUTCOME_RUNNING)
+            return;
+        TrialStressScope stressScope(stressStats.get());
+        if (GetBossState(currentWave - 1) == IN_PROGRESS)
+            FinalizeTrialOutcome(false, "Stress test stopped.");
+        else
+            CleanupTrial(false);
+        stressStats->Outcome.store(STRESS_OUTCOME_STOPPED);
+    }
+};
+
+// --- Instance Script Loader ---
+// Registers our custom instance script with the server.
+class instance_trial_of_finality_loader : public InstanceScriptLoader
+{
+    public:
+        instance_trial_of_finality_loader() : InstanceScriptLoader("instance_trial_of_finality") { }
+
+        InstanceScript* GetInstanceScript(InstanceMap* map) const override
+        {
+            return new instance_trial_of_finality(map);
+        }
+};
+
+// --- Logging Function ---
+void LogTrialDbEvent(TrialEventType eventType, uint32 groupId = 0, Player* player = nullptr,
+                     int waveNumber = 0, uint8 highestLevel = 0, const std::string& details = "") {
+    std::string playerName_s = player ? player->GetName() : "";
+
+    TrialEventRecord record;
+    record.Type = eventType;
+    record.GroupId = groupId;
+    record.PlayerGuid = player ? player->GetGUID().GetCounter() : 0;
+    record.AccountId = player && player->GetSession() ? player->GetSession()->GetAccountId() : 0;
+    record.HighestLevel = highestLevel;
+    record.Wave = waveNumber;
+    record.PlayerName = playerName_s;
+    record.Details = details;
+
+    std::string slog_message;
+    FormatTrialEventSlog(record, slog_message);
+    sLog->outMessage("sys", LOG_LEVEL_INFO, "%s", slog_message.c_str());
+
+    std::string escaped_details = details;
+    if (!details.empty()) { CharacterDatabase.EscapeString(escaped_details); }
+    std::string escaped_player_name = playerName_s;
+    if (!playerName_s.empty()) { CharacterDatabase.EscapeString(escaped_player_name); }
+    record.PlayerName = escaped_player_name;
+    record.Details = escaped_details;
+
+    std::string query;
+    FormatTrialEventInsert(record, query);
+    CharacterDatabase.Execute(query.c_str());
+    CountTrialDbWrite();
+}
+
+// --- Wave Spawn Positions (Now loaded from config) ---
+std::vector<Position> WAVE_SPAWN_POSITIONS;
+
+// --- Configuration Variables ---
+const uint32 AURA_ID_TRIAL_PERMADEATH = 40000;
+bool ModuleEnabled = false;
+uint32 FateweaverArithosEntry = 0;
+uint32 FateweaverArithosDisplayID = 0;
+uint32 AnnouncerEntry = 0;
+uint32 TrialTokenEntry = 0;
+uint32 TitleRewardID = 0;
+uint32 GoldReward = 200000000;
+uint8 MinGroupSize = 1;
+uint8 MaxGroupSize = 5;
+uint8 MaxLevelDifference = 10;
+uint16 ArenaMapID = 0;
+float ArenaTeleportX = 0.0f;
+float ArenaTeleportY = 0.0f;
+float ArenaTeleportZ = 0.0f;
+float ArenaTeleportO = 0.0f;
+float ArenaRadius = 100.0f;
+float ArenaBoundaryHysteresis = 3.0f;
+float ArenaBoundaryFailDistance = 30.0f;
+uint32 ArenaBoundaryWarningGraceMs = 5000;
+uint32 ValidationCooldownMs = 5000;
+uint32 ArrivalTimeoutMs = 30000;
+uint32 ResumeGraceMs = 120000;
+bool SpectatorsEnable = false;
+uint32 SpectatorsMaxPerInstance = 5;
+uint32 SpectatorsMovementIntervalMs = 500;
+bool SpectatorsDropCombatLog = true;
+bool StatusSyncEnable = true;
+uint32 StatusSyncPollIntervalMs = 2000;
+uint32 StatusSyncRetentionHours = 24;
+bool BlackBoxEnable = true;
+uint32 BlackBoxSeconds = 60;
+uint32 BlackBoxMaxRecords = 4096;
+uint32 BlackBoxPositionIntervalMs = 1000;
+std::string BlackBoxDirectory = ".";
+bool TraceEnable = false;
+uint32 TraceCapacity = 8192;
+std::string TraceDirectory = ".";
+bool MetricsEnable = false;
+std::string MetricsFile = "trial_of_finality.prom";
+uint32 MetricsIntervalSeconds = 15;
+bool StressEnable = false;
+uint32 StressMaxInstances = 200;
+float StressSecondsPerCreature = 8.0f;
+float StressDownChance = 0.002f;
+float StressResurrectChance = 0.05f;
+bool LeaderboardEnable = true;
+uint32 LeaderboardSize = 10;
+uint32 LeaderboardSaveIntervalMs = 300000;
+bool CrowdEnable = false;
+std::vector<uint32> CrowdEntries;
+std::vector<Position> CrowdLayout;
+uint32 CrowdMaxPerInstance = 40;
+uint32 CrowdEmoteIntervalMs = 2000;
+uint32 CrowdEmotesPerTick = 3;
+uint32 CrowdDisableAboveDiffMs = 150;
+bool ExitOverrideHearthstone = false;
+uint16 ExitMapID = 0;
+float ExitTeleportX = 0.0f;
+float ExitTeleportY = 0.0f;
+float ExitTeleportZ = 0.0f;
+float ExitTeleportO = 0.0f;
+std::string NpcScalingMode = "match_highest_level";
+std::string DisableCharacterMethod = "custom_flag";
+bool GMDebugEnable = false;
+bool GMDebugAllowPlayerbots = false;
+bool WorldAnnounceEnable = true;
+uint32 WorldAnnounceMinIntervalSeconds = 10; // Minimum time between two world announcements
+uint32 WorldAnnounceMaxQueued = 3; // Victories waiting to be announced; further ones are not announced
+std::string WorldAnnounceFormat = "Hark, heroes! The group led by {group_leader}, with valiant trialists {player_list}, has vanquished all foes and emerged victorious from the Trial of Finality! All hail the Conquerors!";
+bool CheeringNpcsEnable = true;
+std::set<uint32> CheeringNpcCityZoneIDs;
+float CheeringNpcsRadiusAroundPlayer = 40.0f;
+int CheeringNpcsMaxPerPlayerCluster = 5;
+int CheeringNpcsMaxTotalWorld = 50;
+uint32 CheeringNpcsTargetNpcFlags = UNIT_NPC_FLAG_NONE;
+uint32 CheeringNpcsExcludeNpcFlags = UNIT_NPC_FLAG_VENDOR | UNIT_NPC_FLAG_TRAINER | UNIT_NPC_FLAG_FLIGHTMASTER | UNIT_NPC_FLAG_REPAIRER | UNIT_NPC_FLAG_AUCTIONEER | UNIT_NPC_FLAG_BANKER | UNIT_NPC_FLAG_TABARDDESIGNER | UNIT_NPC_FLAG_STABLEMASTER | UNIT_NPC_FLAG_GUILDMASTER | UNIT_NPC_FLAG_BATTLEMASTER | UNIT_NPC_FLAG_INNKEEPER | UNIT_NPC_FLAG_SPIRITHEALER | UNIT_NPC_FLAG_SPIRITGUIDE | UNIT_NPC_FLAG_PETITIONER;
+uint32 CheeringNpcsCheerIntervalMs = 2000; // Interval for the second cheer
+bool PermaDeathExemptGMs = true; // Exempt GMs from perma-death
+uint32 ConfirmationTimeoutSeconds = 60; // Seconds for players to confirm trial participation
+bool ConfirmationEnable = true; // Enable/disable the confirmation system
+std::string ConfirmationRequiredMode = "all"; // "all", "majority", "leader_plus_one"
+
+enum TrialConfirmationMode : uint8
+{
+    CONFIRMATION_MODE_ALL = 0,          // Every prompted member must accept
+    CONFIRMATION_MODE_MAJORITY,         // More than half of the group, leader included
+    CONFIRMATION_MODE_LEADER_PLUS_ONE   // The leader and at least one other member
+};
+TrialConfirmationMode ConfirmationMode = CONFIRMATION_MODE_ALL;
+bool ForfeitEnable = true; // Enable/disable the forfeit feature
+
+// --- Custom NPC Scaling Settings ---
+struct CustomNpcScalingTier {
+    float HealthMultiplier = 1.0f;
+    std::vector<uint32> AurasToAdd;
+};
+
+// --- Difficulty Tiers and Level Bands (Now loaded from config) ---
+enum TrialDifficultyTier : uint8
+{
+    TRIAL_TIER_EASY = 0,
+    TRIAL_TIER_MEDIUM,
+    TRIAL_TIER_HARD,
+    MAX_TRIAL_TIERS
+};
+
+const char* const TrialTierNames[MAX_TRIAL_TIERS] = { "Easy", "Medium", "Hard" };
+
+// Highest level covered by the compiled selection table. Groups above it use the last column.
+const uint8 MAX_TRIAL_LEVEL = DEFAULT_MAX_LEVEL;
+
+// A level band owns its own creature pools and scaling rules for every difficulty tier.
+// Each inner pool vector represents a "spawn choice", which can be a single creature or a pre-defined group.
+struct TrialLevelBand
+{
+    uint8 MinLevel = 1;
+    uint8 MaxLevel = MAX_TRIAL_LEVEL;
+    std::vector<std::vector<uint32>> Pools[MAX_TRIAL_TIERS];
+    CustomNpcScalingTier Scaling[MAX_TRIAL_TIERS];
+};
+
+// One cell of the compiled [wave][level] table. A null pool means no band covers that level.
+struct TrialWaveSelection
+{
+    const std::vector<std::vector<uint32>>* Pool = nullptr;
+    const CustomNpcScalingTier* Scaling = nullptr;
+};
+
+std::vector<TrialLevelBand> LevelBands;
+// Band index for each level, or -1 if the level is not covered by any band.
+std::array<int8, MAX_TRIAL_LEVEL + 1> LevelToBandIndex;
+// Compiled at config load: WaveSelectionTable[wave - 1][level] -> pool and scaling rules.
+std::vector<std::array<TrialWaveSelection, MAX_TRIAL_LEVEL + 1>> WaveSelectionTable;
+
+inline uint8 ClampTrialLevel(uint8 level)
+{
+    return std::min(level, MAX_TRIAL_LEVEL);
+}
+
+inline bool IsTrialLevelCovered(uint8 level)
+{
+    return LevelToBandIndex[ClampTrialLevel(level)] >= 0;
+}
+
+// Leaderboard key of the band covering the level: the band's minimum level, or 0 if no band covers it.
+inline uint8 GetTrialBandKey(uint8 level)
+{
+    int8 index = LevelToBandIndex[ClampTrialLevel(level)];
+    return index >= 0 ? LevelBands[index].MinLevel : 0;
+}
+
+
+// --- Localized Trial Strings ---
+// Fixed player-facing texts live in acore_string so they can be localized.
+enum TrialStrings : uint32
+{
+    TRIAL_STRING_WAVE_SURVIVED              = 90100,
+    TRIAL_STRING_TRIAL_BEGUN                = 90101,
+    TRIAL_STRING_PLAYER_DOWNED              = 90102,
+    TRIAL_STRING_PLAYER_RESURRECTED         = 90103,
+    TRIAL_STRING_FATE_SEALED                = 90104,
+    TRIAL_STRING_TRIAL_CONCLUDED            = 90105,
+    TRIAL_STRING_TITLE_GRANTED              = 90106,
+    TRIAL_STRING_ARENA_WARNING              = 90107,
+    TRIAL_STRING_FORFEIT_VOTE_TIMED_OUT     = 90108,
+    TRIAL_STRING_FORFEIT_ALREADY_VOTED      = 90109,
+    TRIAL_STRING_FORFEIT_NO_VOTERS          = 90110,
+    TRIAL_STRING_FORFEIT_OUTSIDE_TRIAL      = 90111,
+    TRIAL_STRING_MODULE_DISABLED            = 90112,
+    TRIAL_STRING_NOT_IN_GROUP               = 90113,
+    TRIAL_STRING_NOT_GROUP_LEADER           = 90114,
+    TRIAL_STRING_START_NO_LEVEL             = 90115,
+    TRIAL_STRING_START_NO_INSTANCE          = 90116,
+    TRIAL_STRING_VALIDATION_IN_PROGRESS     = 90117,
+    TRIAL_STRING_VALIDATION_NPC_GONE        = 90118,
+
+    // Announcer lines: three per default wave, 90120 + (wave - 1) * 3 + line
+    TRIAL_STRING_ANNOUNCE_WAVE_FIRST        = 90120,
+    TRIAL_STRING_ANNOUNCE_GENERIC           = 90135,
+
+    TRIAL_STRING_CONFIRM_ALREADY_PENDING    = 90136,
+    TRIAL_STRING_CONFIRM_NONE_PENDING       = 90137,
+    TRIAL_STRING_CONFIRM_TIMED_OUT          = 90138,
+    TRIAL_STRING_CONFIRM_LEFT_BEHIND        = 90139,
+    TRIAL_STRING_CONFIRM_ALREADY_ANSWERED   = 90140,
+    TRIAL_STRING_CONFIRM_USAGE              = 90141,
+    TRIAL_STRING_CONFIRM_ABORTED            = 90142,
+    TRIAL_STRING_LOBBY_WAITING              = 90143,
+    TRIAL_STRING_RECOVERY_RESUMING          = 90144,
+    TRIAL_STRING_RECOVERY_RESOLVED          = 90145,
+    TRIAL_STRING_SPECTATE_JOINED            = 90146,
+    TRIAL_STRING_SPECTATE_LEFT              = 90147,
+    TRIAL_STRING_SPECTATE_USAGE             = 90148,
+    TRIAL_STRING_SPECTATE_NO_TRIAL          = 90149,
+    TRIAL_STRING_SPECTATE_FULL              = 90150,
+    TRIAL_STRING_SPECTATE_NOT_NOW           = 90151,
+    TRIAL_STRING_SPECTATE_NOT_SPECTATING    = 90152,
+    TRIAL_STRING_SPECTATE_ALREADY           = 90153,
+    TRIAL_STRING_LEADERBOARD_DISABLED       = 90154,
+    TRIAL_STRING_LEADERBOARD_EMPTY          = 90155,
+    TRIAL_STRING_LEADERBOARD_USAGE          = 90156,
+
+    // Texts with runtime values (printf-style arguments)
+    TRIAL_STRING_GOLD_AWARDED               = 90157,
+    TRIAL_STRING_FORFEIT_VOTE_STARTED       = 90158,
+    TRIAL_STRING_FORFEIT_VOTE_CAST          = 90159,
+    TRIAL_STRING_VALIDATION_TOO_FAR         = 90160,
+    TRIAL_STRING_VALIDATION_BOT_PERMITTED   = 90161,
+    TRIAL_STRING_VALIDATION_BOT_FORBIDDEN   = 90162,
+    TRIAL_STRING_VALIDATION_HAS_TOKEN       = 90163,
+    TRIAL_STRING_VALIDATION_TOO_SMALL       = 90164,
+    TRIAL_STRING_VALIDATION_TOO_LARGE       = 90165,
+    TRIAL_STRING_VALIDATION_LEVEL_SPREAD    = 90166,
+    TRIAL_STRING_VALIDATION_LEVEL_UNCOVERED = 90167,
+    TRIAL_STRING_START_MEMBER_SEALED        = 90168,
+    TRIAL_STRING_CONFIRM_PROPOSED           = 90169,
+    TRIAL_STRING_CONFIRM_PROPOSAL_RECEIVED  = 90170,
+    TRIAL_STRING_CONFIRM_MEMBER_ACCEPTED    = 90171,
+    TRIAL_STRING_CONFIRM_MEMBER_DECLINED    = 90172,
+    TRIAL_STRING_GM_RESET_STATUS            = 90173,
+    TRIAL_STRING_GM_RESET_TOKEN             = 90174,
+    TRIAL_STRING_GM_RESET_AURA              = 90175,
+
+    TRIAL_STRING_FIRST                      = TRIAL_STRING_WAVE_SURVIVED,
+    TRIAL_STRING_LAST                       = TRIAL_STRING_GM_RESET_AURA
+};
+
+// A text that is either a localized acore_string entry or a literal from the configuration file.
+struct TrialText
+{
+    uint32 StringId = 0;
+    std::string Literal;
+
+    std::string Resolve(LocaleConstant locale) const
+    {
+        if (StringId)
+            if (char const* text = sObjectMgr->GetAcoreString(StringId, locale))
+                return text;
+        return Literal;
+    }
+};
+
+// Prebuilt system-message and notification packets for every trial string in every locale.
+// Built on the world thread at startup (after acore_string is loaded) and on config reload; read-only
+// from the map threads afterwards, so sending a fixed text never formats or encodes a packet.
+class TrialTextCache
+{
+public:
+    static TrialTextCache* instance() { static TrialTextCache instance; return &instance; }
+
+    void Build()
+    {
+        for (uint32 id = TRIAL_STRING_FIRST; id <= TRIAL_STRING_LAST; ++id)
+        {
+            LocalizedPackets& packets = _packets[id - TRIAL_STRING_FIRST];
+            for (uint8 locale = 0; locale < TOTAL_LOCALES; ++locale)
+            {
+                char const* text = sObjectMgr->GetAcoreString(id, LocaleConstant(locale));
+                std::string_view message = text ? text : "";
+
+                packets.System[locale].clear();
+                ChatHandler::BuildChatPacket(packets.System[locale], CHAT_MSG_SYSTEM, LANG_UNIVERSAL, nullptr, nullptr, message);
+
+                packets.Notification[locale].Initialize(SMSG_NOTIFICATION, message.size() + 1);
+                packets.Notification[locale] << message;
+            }
+        }
+        _built = true;
+        sLog->outDetail("[TrialOfFinality] Prebuilt %u localized text packets.", uint32(_packets.size() * TOTAL_LOCALES * 2));
+    }
+
+    void SendSysMessage(Player* player, TrialStrings id) const
+    {
+        if (!player || !player->GetSession())
+            return;
+        if (!_built)
+        {
+            ChatHandler(player->GetSession()).SendSysMessage(id);
+            return;
+        }
+        player->SendDirectMessage(&_packets[id - TRIAL_STRING_FIRST].System[player->GetSession()->GetSessionDbLocaleIndex()]);
+    }
+
+    void SendNotification(Player* player, TrialStrings id) const
+    {
+        if (!player || !player->GetSession())
+            return;
+        if (!_built)
+        {
+            player->GetSession()->SendNotification(id);
+            return;
+        }
+        player->SendDirectMessage(&_packets[id - TRIAL_STRING_FIRST].Notification[player->GetSession()->GetSessionDbLocaleIndex()]);
+    }
+
+    // Texts with runtime values cannot be prebuilt; they are formatted from the player's locale through
+    // the chat handler's acore_string path.
+    template<typename... Args>
+    void PSendSysMessage(Player* player, TrialStrings id, Args... args) const
+    {
+        if (!player || !player->GetSession())
+            return;
+        ChatHandler(player->GetSession()).PSendSysMessage(id, args...);
+    }
+
+private:
+    struct LocalizedPackets
+    {
+        std::array<WorldPacket, TOTAL_LOCALES> System;
+        std::array<WorldPacket, TOTAL_LOCALES> Notification;
+    };
+
+    TrialTextCache() { }
+    ~TrialTextCache() { }
+    TrialTextCache(const TrialTextCache&) = delete;
+    TrialTextCache& operator=(const TrialTextCache&) = delete;
+
+    std::array<LocalizedPackets, TRIAL_STRING_LAST - TRIAL_STRING_FIRST + 1> _packets;
+    bool _built = false;
+};
+
+// One notification with runtime values sent to a whole instance: the text is formatted and the packet
+// built once per locale, on the first recipient with that locale. Arguments are copied, so string
+// arguments must outlive the object.
+class TrialLocalizedNotification
+{
+public:
+    template<typename... Args>
+    explicit TrialLocalizedNotification(TrialStrings id, Args... args) : _id(id)
+    {
+        _format = [args...](char const* format)
+        {
+            char buffer[512];
+            std::snprintf(buffer, sizeof(buffer), format, args...);
+            return std::string(buffer);
+        };
+    }
+
+    void Send(Player* player)
+    {
+        if (!player || !player->GetSession())
+            return;
+        LocaleConstant locale = player->GetSession()->GetSessionDbLocaleIndex();
+        std::unique_ptr<WorldPacket>& packet = _packets[locale];
+        if (!packet)
+        {
+            char const* format = sObjectMgr->GetAcoreString(_id, locale);
+            std::string text = _format(format ? format : "");
+            packet = std::make_unique<WorldPacket>(SMSG_NOTIFICATION, text.size() + 1);
+            *packet << text;
+        }
+        player->SendDirectMessage(packet.get());
+    }
+
+private:
+    TrialStrings _id;
+    std::function<std::string(char const*)> _format;
+    std::array<std::unique_ptr<WorldPacket>, TOTAL_LOCALES> _packets;
+};
+
+// --- Wave Program (Now loaded from config) ---
+// One descriptor per wave, parsed once at config load. The instance script walks this array by index.
+struct TrialWaveDescriptor
+{
+    TrialDifficultyTier PoolTier = TRIAL_TIER_EASY;    // Which tier's creature pool the wave draws from
+    TrialDifficultyTier ScalingTier = TRIAL_TIER_EASY; // Which tier's custom scaling rules apply
+    uint32 DelayMs = 8000;                              // Delay between the wave's announcement and its spawn
+    std::vector<Position> SpawnLayout;                  // Resolved from Arena.SpawnPositions
+    std::vector<TrialText> Announcements;               // The announcer yells one of these at random
+};
+
+std::vector<TrialWaveDescriptor> WaveProgram;
+
+TrialArenaBoundary ArenaBoundary;
+
+// --- Main Trial Logic ---
+
+enum FateweaverArithosGossipActions
+{
+    GOSSIP_ACTION_INFO = 1,
+    GOSSIP_ACTION_START_TRIAL = 2,
+    GOSSIP_ACTION_RETURN = 3,
+    GOSSIP_ACTION_CONFIRM_ACCEPT = 4,
+    GOSSIP_ACTION_CONFIRM_DECLINE = 5,
+    GOSSIP_ACTION_LEADERBOARD_FASTEST = 6,
+    GOSSIP_ACTION_LEADERBOARD_WAVES = 7
+};
+
+// --- Pre-Trial Data Structures and Manager ---
+// This manager is now a simple data-passing utility to transfer information
+// from the outer world script (NPC interaction) into the newly created instance.
+struct PreTrialData
+{
+    uint8 highestLevel;
+    bool isTestTrial = false;
+    std::vector<ObjectGuid> expectedMembers;    // Everyone teleported in; the lobby waits for all of them
+};
+
+class TrialManager
+{
+public:
+    static TrialManager* instance() { static TrialManager instance; return &instance; }
+
+    // Caches the necessary pre-trial data for a group.
+    void PrepareForInstance(Group* group, uint8 highestLevel, bool isTest, std::vector<ObjectGuid> expectedMembers)
+    {
+        if (!group) return;
+        sLog->outDetail("[TrialOfFinality] Preparing group %u for instance, highest level: %u, isTest: %d, expected members: %u", group->GetId(), highestLevel, isTest, uint32(expectedMembers.size()));
+        m_preTrialData[group->GetId()] = { highestLevel, isTest, std::move(expectedMembers) };
+    }
+
+    // Retrieves the cached data; intended to be called from the InstanceScript.
+    PreTrialData* GetPreTrialData(uint32 groupId)
+    {
+        auto it = m_preTrialData.find(groupId);
+        if (it != m_preTrialData.end())
+            return &it->second;
+        return nullptr;
+    }
+
+    // Cleans up the cached data once it has been consumed by the InstanceScript.
+    void CleanupPreTrialData(uint32 groupId)
+    {
+        m_preTrialData.erase(groupId);
+    }
+
+    // Cheap in-memory checks; fills the online roster (sorted) on success. With onlyMembers, the other
+    // members of the group are ignored (the leader is always checked).
+    static bool ValidateGroupForTrial(Player* leader, Creature* trialNpc, std::vector<ObjectGuid>& memberGuids,
+        const std::set<ObjectGuid>* onlyMembers = nullptr);
+
+    // Runs the in-memory checks, then the perma-death check as a single async query, and starts the
+    // trial from the query callback. The DB result is cached per group roster for a short cooldown and
+    // repeated requests while a query is in flight are dropped.
+    void RequestTrialStart(Player* leader, Creature* trialNpc);
+
+    // Creates the instance and teleports the group. Expects a validated group. When participants is
+    // given, only those members (plus the leader) are taken along.
+    static void StartTrialForGroup(Player* leader, const std::vector<ObjectGuid>* participants = nullptr);
+
+    // --- Trial Confirmation ---
+    // Opens a proposal for the validated roster and prompts every other online member.
+    void ProposeTrial(Player* leader, Creature* trialNpc, const std::vector<ObjectGuid>& roster);
+    void HandleTrialConfirmation(Player* player, bool accepted);
+    bool IsAwaitingConfirmation(Player* player);
+    static void SendConfirmationPrompt(Player* member, Creature* trialNpc);
+
+    // World thread ticker; runs the perma-death query callbacks, expires timed-out proposals and drops
+    // validation results past their cooldown.
+    void OnUpdate(uint32 diff);
+
+    // Groups waiting for the perma-death query or for member confirmation.
+    uint32 GetQueueLength();
+
+private:
+    struct PendingTrialInfo
+    {
+        ObjectGuid LeaderGuid;
+        ObjectGuid NpcGuid;                             // Fateweaver the trial was requested from
+        uint32 GroupId = 0;
+        std::vector<ObjectGuid> MemberGuidsToConfirm;   // Online members other than the leader
+        std::set<ObjectGuid> MemberGuidsAccepted;
+        std::set<ObjectGuid> MemberGuidsDeclined;
+        uint32 Generation = 0;
+    };
+
+    // Timer wheel payload. A proposal that resolved early leaves its entry behind; the generation
+    // check makes that entry a no-op instead of paying for a removal from the wheel.
+    struct PendingTrialTimeout
+    {
+        uint32 GroupId;
+        uint32 Generation;
+    };
+
+    enum ConfirmationOutcome { CONFIRMATION_PENDING, CONFIRMATION_START, CONFIRMATION_ABORT };
+    static ConfirmationOutcome EvaluateConfirmation(const PendingTrialInfo& info);
+    static void StartConfirmedTrial(const PendingTrialInfo& info);
+    static void AbortPendingTrial(const PendingTrialInfo& info, TrialStrings reason);
+
+    TrialManager() : m_confirmationWheel(1000) {}
+    ~TrialManager() {}
+    TrialManager(const TrialManager&) = delete;
+    TrialManager& operator=(const TrialManager&) = delete;
+
+    // A query still in flight after this long is treated as lost, so the group can ask again.
+    static constexpr uint32 VALIDATION_QUERY_TIMEOUT_MS = 30000;
+    // How often OnUpdate sweeps m_validations for expired entries.
+    static constexpr uint32 VALIDATION_SWEEP_INTERVAL_MS = 10000;
+
+    struct GroupValidationEntry
+    {
+        std::vector<ObjectGuid> Roster;     // Sorted online roster the DB result applies to
+        bool InFlight = false;
+        bool HasResult = false;
+        uint32 SealedGuid = 0;              // First perma-failed member found, 0 if none
+        uint32 CheckedAtMs = 0;
+        uint32 IssuedAtMs = 0;
+
+        bool IsInFlight(uint32 now) const { return InFlight && getMSTimeDiff(IssuedAtMs, now) < VALIDATION_QUERY_TIMEOUT_MS; }
+    };
+
+    void HandleSealedMemberResult(ObjectGuid leaderGuid, ObjectGuid npcGuid, uint32 groupId, std::vector<ObjectGuid> roster, QueryResult result);
+    static void ContinueTrialStart(Player* leader, Creature* trialNpc, const std::vector<ObjectGuid>& roster, uint32 sealedGuid);
+
+    std::map<uint32, PreTrialData> m_preTrialData;
+    std::mutex m_validationLock;
+    std::unordered_map<uint32, GroupValidationEntry> m_validations;
+    uint32 m_validationSweepTimer = VALIDATION_SWEEP_INTERVAL_MS;
+
+    // Queries are issued from map threads and handed to the world thread, which owns m_queryProcessor;
+    // a leader logging out mid-query no longer takes the callback with their session.
+    std::mutex m_queryLock;
+    std::vector<QueryCallback> m_incomingQueries;
+    QueryCallbackProcessor m_queryProcessor;
+
+    // Proposals are created on map threads and expired on the world thread.
+    std::mutex m_pendingLock;
+    std::unordered_map<uint32, PendingTrialInfo> m_pendingTrials;
+    TrialTimerWheel<PendingTrialTimeout> m_confirmationWheel;
+    uint32 m_nextGeneration = 0;
+};
+
+// --- Session Resume ---
+// In-memory record of a participant who disconnected mid-trial. Lets the login path route the player
+// back into their instance and restore their trial state without touching the database.
+struct TrialResumeRecord
+{
+    uint32 InstanceId = 0;
+    uint32 GroupId = 0;
+    bool Downed = false;
+    time_t DownedAt = 0;
+    bool VotedForfeit = false;
+    bool WarnedForLeavingArena = false;
+    uint32 DisconnectedAtMs = 0;
+};
+
+class TrialResumeRegistry
+{
+public:
+    static TrialResumeRegistry* instance() { static TrialResumeRegistry instance; return &instance; }
+
+    void Store(ObjectGuid guid, const TrialResumeRecord& record)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _records[guid.GetCounter()] = record;
+    }
+
+    // Copies the record out if it exists and its grace period has not run out.
+    bool Find(ObjectGuid guid, TrialResumeRecord& out)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        auto it = _records.find(guid.GetCounter());
+        if (it == _records.end())
+            return false;
+        if (getMSTimeDiff(it->second.DisconnectedAtMs, getMSTime()) > ResumeGraceMs)
+        {
+            _records.erase(it);
+            return false;
+        }
+        out = it->second;
+        return true;
+    }
+
+    void Remove(ObjectGuid guid)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _records.erase(guid.GetCounter());
+    }
+
+    void RemoveInstance(uint32 instanceId)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        for (auto it = _records.begin(); it != _records.end();)
+        {
+            if (it->second.InstanceId == instanceId)
+                it = _records.erase(it);
+            else
+                ++it;
+        }
+    }
+
+private:
+    TrialResumeRegistry() { }
+    ~TrialResumeRegistry() { }
+    TrialResumeRegistry(const TrialResumeRegistry&) = delete;
+    TrialResumeRegistry& operator=(const TrialResumeRegistry&) = delete;
+
+    std::mutex _lock;
+    std::unordered_map<uint32, TrialResumeRecord> _records;
+};
+
+// --- Spectators ---
+// Observers attached to a running trial. The outgoing packet hook runs for every packet of every
+// session, on whichever thread sends it, so it never takes the registry lock: it reads an immutable
+// session index that joins and leaves replace whole. Each stream throttles under its own lock and
+// counts into atomic per-instance counters. The common case (nobody spectating anywhere) reads one
+// atomic and returns.
+
+// Packet counters of one instance, updated by the packet filter without the registry lock.
+struct TrialSpectatorCounters
+{
+    std::atomic<uint64> PacketsSent{ 0 };
+    std::atomic<uint64> BytesSent{ 0 };
+    std::atomic<uint64> MovementDropped{ 0 };
+    std::atomic<uint64> CombatLogDropped{ 0 };
+    std::atomic<uint64> BytesDropped{ 0 };
+
+    void Reset()
+    {
+        PacketsSent = 0;
+        BytesSent = 0;
+        MovementDropped = 0;
+        CombatLogDropped = 0;
+        BytesDropped = 0;
+    }
+};
+
+struct TrialSpectatorStream
+{
+    WorldSession* Session = nullptr;
+    ObjectGuid PlayerGuid;
+    uint32 InstanceId = 0;
+    WorldLocation ReturnPoint;
+    std::shared_ptr<TrialSpectatorCounters> Counters;  // Shared with the instance; outlives a reset
+    std::mutex MovementLock;                            // Two threads can send to one session at once
+    std::unordered_map<uint64, uint32> LastMovementMs; // Mover -> last forwarded movement update
+};
+
+// Per-instance packet counters, kept after spectators leave so `.trial spectators` can compare runs.
+struct TrialSpectatorInstanceStats
+{
+    uint32 Spectators = 0;
+    uint32 PeakSpectators = 0;
+    uint32 MeasureStartMs = 0;
+    uint64 PacketsSent = 0;
+    uint64 BytesSent = 0;
+    uint64 MovementDropped = 0;
+    uint64 CombatLogDropped = 0;
+    uint64 BytesDropped = 0;
+};
+
+class TrialSpectatorRegistry
+{
+public:
+    static TrialSpectatorRegistry* instance() { static TrialSpectatorRegistry instance; return &instance; }
+
+    bool HasSpectators() const { return _index.load(std::memory_order_acquire) != nullptr; }
+
+    // Reserves a place in the instance; fails once it holds SpectatorsMaxPerInstance observers.
+    bool Add(WorldSession* session, Player* player, uint32 instanceId)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        InstanceEntry& entry = _instances[instanceId];
+        if (entry.Spectators >= SpectatorsMaxPerInstance)
+            return false;
+        if (!entry.MeasureStartMs)
+            entry.MeasureStartMs = getMSTime();
+        entry.PeakSpectators = std::max(entry.PeakSpectators, ++entry.Spectators);
+
+        std::unique_ptr<TrialSpectatorStream>& stream = _streams[session];
+        if (stream)
+            Retire(nullptr, std::move(stream)); // A reader may still hold the replaced stream
+        stream = std::make_unique<TrialSpectatorStream>();
+        stream->Session = session;
+        stream->PlayerGuid = player->GetGUID();
+        stream->InstanceId = instanceId;
+        stream->ReturnPoint = player->GetWorldLocation();
+        stream->Counters = entry.Counters;
+        _instanceByGuid[player->GetGUID()] = instanceId;
+        PublishIndex();
+        return true;
+    }
+
+    // Drops the session's stream and hands back where the observer came from.
+    bool Remove(WorldSession* session, WorldLocation& returnPoint)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        auto it = _streams.find(session);
+        if (it == _streams.end())
+            return false;
+        returnPoint = it->second->ReturnPoint;
+        auto entryItr = _instances.find(it->second->InstanceId);
+        if (entryItr != _instances.end() && entryItr->second.Spectators)
+            --entryItr->second.Spectators;
+        _instanceByGuid.erase(it->second->PlayerGuid);
+        std::unique_ptr<TrialSpectatorStream> stream = std::move(it->second);
+        _streams.erase(it);
+        PublishIndex();
+        Retire(nullptr, std::move(stream));
+        return true;
+    }
+
+    // Returns the instance the player is spectating, or 0.
+    uint32 GetSpectatedInstance(ObjectGuid guid)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        auto it = _instanceByGuid.find(guid);
+        return it != _instanceByGuid.end() ? it->second : 0;
+    }
+
+    // Observers who logged out while spectating; their next login takes them back to ReturnPoint.
+    void StorePendingReturn(ObjectGuid guid, WorldLocation const& returnPoint)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _pendingReturns[guid.GetCounter()] = returnPoint;
+    }
+
+    bool HasPendingReturn(ObjectGuid guid)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        return _pendingReturns.count(guid.GetCounter()) > 0;
+    }
+
+    bool TakePendingReturn(ObjectGuid guid, WorldLocation& returnPoint)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        auto it = _pendingReturns.find(guid.GetCounter());
+        if (it == _pendingReturns.end())
+            return false;
+        returnPoint = it->second;
+        _pendingReturns.erase(it);
+        return true;
+    }
+
+    // Starts a new measurement: counters restart, instances without observers are forgotten.
+    void ResetStats()
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        uint32 now = getMSTime();
+        for (auto it = _instances.begin(); it != _instances.end();)
+        {
+            if (!it->second.Spectators)
+            {
+                it = _instances.erase(it);
+                continue;
+            }
+            it->second.PeakSpectators = it->second.Spectators;
+            it->second.MeasureStartMs = now;
+            it->second.Counters->Reset();
+            ++it;
+        }
+    }
+
+    // Outgoing packet filter. Combat log packets are dropped, and movement updates are forwarded at
+    // most once per SpectatorsMovementIntervalMs for each mover. Everything else passes untouched.
+    bool FilterPacket(WorldSession* session, WorldPacket& packet)
+    {
+        const StreamIndex* index = _index.load(std::memory_order_acquire);
+        if (!index)
+            return true;
+        auto it = std::lower_bound(index->begin(), index->end(), session,
+            [](const StreamIndex::value_type& entry, WorldSession* key) { return entry.first < key; });
+        if (it == index->end() || it->first != session)
+            return true;
+        TrialSpectatorStream& stream = *it->second;
+        TrialSpectatorCounters& counters = *stream.Counters;
+
+        switch (packet.GetOpcode())
+        {
+            case SMSG_ATTACKERSTATEUPDATE:
+            case SMSG_SPELLNONMELEEDAMAGELOG:
+            case SMSG_PERIODICAURALOG:
+            case SMSG_SPELLLOGEXECUTE:
+            case SMSG_SPELLLOGMISS:
+            case SMSG_SPELLHEALLOG:
+            case SMSG_SPELLENERGIZELOG:
+            case SMSG_SPELLDAMAGESHIELD:
+            case SMSG_SPELLDISPELLOG:
+            case SMSG_SPELLINSTAKILLLOG:
+            case SMSG_PROCRESIST:
+            case SMSG_RESISTLOG:
+            case SMSG_ENVIRONMENTALDAMAGELOG:
+                if (SpectatorsDropCombatLog)
+                {
+                    counters.CombatLogDropped.fetch_add(1, std::memory_order_relaxed);
+                    counters.BytesDropped.fetch_add(packet.size(), std::memory_order_relaxed);
+                    return false;
+                }
+                break;
+            case MSG_MOVE_HEARTBEAT:
+            case MSG_MOVE_SET_FACING:
+            case SMSG_MONSTER_MOVE:
+            {
+                uint64 mover = 0;
+                size_t readPos = packet.rpos();
+                try
+                {
+                    packet.rpos(0);
+                    packet.readPackGUID(mover);
+                }
+                catch (ByteBufferException const&)
+                {
+                    mover = 0;
+                }
+                packet.rpos(readPos);
+                if (!mover)
+                    break;
+
+                uint32 now = getMSTime();
+                std::lock_guard<std::mutex> lock(stream.MovementLock);
+                auto [lastItr, inserted] = stream.LastMovementMs.try_emplace(mover, now);
+                if (!inserted)
+                {
+                    if (getMSTimeDiff(lastItr->second, now) < SpectatorsMovementIntervalMs)
+                    {
+                        counters.MovementDropped.fetch_add(1, std::memory_order_relaxed);
+                        counters.BytesDropped.fetch_add(packet.size(), std::memory_order_relaxed);
+                        return false;
+                    }
+                    lastItr->second = now;
+                }
+                break;
+            }
+            default:
+                break;
+        }
+
+        counters.PacketsSent.fetch_add(1, std::memory_order_relaxed);
+        counters.BytesSent.fetch_add(packet.size(), std::memory_order_relaxed);
+        return true;
+    }
+
+    std::vector<std::pair<uint32, TrialSpectatorInstanceStats>> GetInstanceStats()
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        std::vector<std::pair<uint32, TrialSpectatorInstanceStats>> result;
+        for (auto const& [instanceId, entry] : _instances)
+        {
+            TrialSpectatorInstanceStats stats;
+            stats.Spectators = entry.Spectators;
+            stats.PeakSpectators = entry.PeakSpectators;
+            stats.MeasureStartMs = entry.MeasureStartMs;
+            stats.PacketsSent = entry.Counters->PacketsSent.load(std::memory_order_relaxed);
+            stats.BytesSent = entry.Counters->BytesSent.load(std::memory_order_relaxed);
+            stats.MovementDropped = entry.Counters->MovementDropped.load(std::memory_order_relaxed);
+            stats.CombatLogDropped = entry.Counters->CombatLogDropped.load(std::memory_order_relaxed);
+            stats.BytesDropped = entry.Counters->BytesDropped.load(std::memory_order_relaxed);
+            result.emplace_back(instanceId, stats);
+        }
+        return result;
+    }
+
+private:
+    // Sorted by session; replaced, never modified, once published.
+    typedef std::vector<std::pair<WorldSession*, TrialSpectatorStream*>> StreamIndex;
+
+    struct InstanceEntry
+    {
+        uint32 Spectators = 0;
+        uint32 PeakSpectators = 0;
+        uint32 MeasureStartMs = 0;
+        std::shared_ptr<TrialSpectatorCounters> Counters = std::make_shared<TrialSpectatorCounters>();
+    };
+
+    // A replaced index or removed stream may still be in use by a packet filter call on another thread.
+    // It is freed once it has been retired for RETIRE_GRACE_MS, far longer than one call can take.
+    struct RetiredEntry
+    {
+        uint32 RetiredAtMs = 0;
+        std::unique_ptr<const StreamIndex> Index;
+        std::unique_ptr<TrialSpectatorStream> Stream;
+    };
+    static constexpr uint32 RETIRE_GRACE_MS = 10 * IN_MILLISECONDS;
+
+    TrialSpectatorRegistry() { }
+    ~TrialSpectatorRegistry() { }
+    TrialSpectatorRegistry(const TrialSpectatorRegistry&) = delete;
+    TrialSpectatorRegistry& operator=(const TrialSpectatorRegistry&) = delete;
+
+    // Called with _lock held, after every change to _streams.
+    void PublishIndex()
+    {
+        std::unique_ptr<StreamIndex> index;
+        if (!_streams.empty())
+        {
+            index = std::make_unique<StreamIndex>();
+            index->reserve(_streams.size());
+            for (auto const& [session, stream] : _streams)
+                index->emplace_back(session, stream.get());
+            std::sort(index->begin(), index->end());
+        }
+        _index.store(index.get(), std::memory_order_release);
+        Retire(std::move(_currentIndex), nullptr);
+        _currentIndex = std::move(index);
+    }
+
+    // Called with _lock held.
+    void Retire(std::unique_ptr<const StreamIndex> index, std::unique_ptr<TrialSpectatorStream> stream)
+    {
+        uint32 now = getMSTime();
+        _retired.erase(std::remove_if(_retired.begin(), _retired.end(), [now](const RetiredEntry& entry)
+        {
+            return getMSTimeDiff(entry.RetiredAtMs, now) > RETIRE_GRACE_MS;
+        }), _retired.end());
+        if (index || stream)
+            _retired.push_back({ now, std::move(index), std::move(stream) });
+    }
+
+    std::mutex _lock;
+    std::atomic<const StreamIndex*> _index{ nullptr };
+    std::unique_ptr<const StreamIndex> _currentIndex;
+    std::vector<RetiredEntry> _retired;
+    std::unordered_map<WorldSession*, std::unique_ptr<TrialSpectatorStream>> _streams;
+    std::unordered_map<ObjectGuid, uint32> _instanceByGuid;
+    std::unordered_map<uint32, InstanceEntry> _instances;
+    std::unordered_map<uint32, WorldLocation> _pendingReturns;
+};
+
+// Spectators are hidden from players, cannot be targeted or attacked, and cannot attack or cast.
+void SetTrialSpectatorState(Player* player, bool spectating)
+{
+    uint32 const flags = UNIT_FLAG_NON_ATTACKABLE | UNIT_FLAG_NOT_SELECTABLE | UNIT_FLAG_PACIFIED | UNIT_FLAG_SILENCED;
+    if (spectating)
+    {
+        player->CombatStop();
+        player->SetFlag(UNIT_FIELD_FLAGS, flags);
+    }
+    else
+    {
+        player->RemoveFlag(UNIT_FIELD_FLAGS, flags);
+    }
+    player->SetVisible(!spectating);
+}
+
+// Ends the player's spectating session and sends them back to where they started watching from.
+bool StopSpectating(Player* player)
+{
+    WorldLocation returnPoint;
+    if (!TrialSpectatorRegistry::instance()->Remove(player->GetSession(), returnPoint))
+        return false;
+    SetTrialSpectatorState(player, false);
+    TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_SPECTATE_LEFT);
+    player->TeleportTo(returnPoint);
+    return true;
+}
+
+// --- Leaderboards ---
+// Realm leaderboards kept in memory. Every board is a bounded, sorted top-K list with at most one entry
+// per character, so recording a run and reading a board are both O(K). The boards are written to
+// `trial_of_finality_leaderboard` every few minutes and read back once at startup; nothing else touches
+// the database.
+enum TrialLeaderboardMetric : uint8
+{
+    LEADERBOARD_FASTEST_CLEAR = 0,  // Successful runs, shortest duration first
+    LEADERBOARD_MOST_WAVES,         // Any finished run, most waves cleared first, then fastest
+    MAX_LEADERBOARD_METRICS
+};
+
+enum TrialLeaderboardScope : uint8
+{
+    LEADERBOARD_SCOPE_OVERALL = 0,
+    LEADERBOARD_SCOPE_CLASS,        // Key: class id
+    LEADERBOARD_SCOPE_BAND          // Key: minimum level of the trial's level band
+};
+
+const char* const TrialLeaderboardMetricNames[MAX_LEADERBOARD_METRICS] = { "Fastest clear", "Most waves" };
+
+struct TrialLeaderboardEntry
+{
+    uint32 PlayerGuid = 0;
+    std::string PlayerName;
+    uint8 Class = 0;
+    uint8 Level = 0;
+    uint8 Waves = 0;
+    uint32 DurationMs = 0;
+    uint32 AchievedAt = 0;  // Unix time
+};
+
+class TrialTopK
+{
+public:
+    static bool IsBetter(TrialLeaderboardMetric metric, const TrialLeaderboardEntry& a, const TrialLeaderboardEntry& b)
+    {
+        if (metric == LEADERBOARD_MOST_WAVES && a.Waves != b.Waves)
+            return a.Waves > b.Waves;
+        if (a.DurationMs != b.DurationMs)
+            return a.DurationMs < b.DurationMs;
+        return a.AchievedAt < b.AchievedAt; // The earlier record holds a tie
+    }
+
+    // Returns true if the board changed.
+    bool Offer(TrialLeaderboardMetric metric, const TrialLeaderboardEntry& entry, size_t k)
+    {
+        auto existing = std::find_if(_entries.begin(), _entries.end(),
+            [&entry](const TrialLeaderboardEntry& e) { return e.PlayerGuid == entry.PlayerGuid; });
+        if (existing != _entries.end())
+        {
+            if (!IsBetter(metric, entry, *existing))
+                return false;
+            _entries.erase(existing);
+        }
+
+        auto pos = std::upper_bound(_entries.begin(), _entries.end(), entry,
+            [metric](const TrialLeaderboardEntry& a, const TrialLeaderboardEntry& b) { return IsBetter(metric, a, b); });
+        if (size_t(pos - _entries.begin()) >= k)
+            return false;
+        _entries.insert(pos, entry);
+        if (_entries.size() > k)
+            _entries.resize(k);
+        return true;
+    }
+
+    const std::vector<TrialLeaderboardEntry>& GetEntries() const { return _entries; }
+
+private:
+    std::vector<TrialLeaderboardEntry> _entries; // Best first
+};
+
+class TrialLeaderboards
+{
+public:
+    static TrialLeaderboards* instance() { static TrialLeaderboards instance; return &instance; }
 
-    void Initialize() override
+    static uint32 MakeBoardId(TrialLeaderboardScope scope, uint32 key) { return (uint32(scope) << 16) | (key & 0xFFFF); }
+
+    // Records one participant's result on the overall, class and level band boards.
+    void RecordRun(const TrialLeaderboardEntry& entry, uint8 bandKey, bool cleared)
     {
-        // Set up the instance for 5 waves (boss encounters)
-        SetBossNumber(5);
-        currentWave = 0;
-        forfeitVoteInProgress = false;
-        boundaryCheckTimer = 5000;
-        forfeitCheckTimer = 1000;
-        isTestTrial = false;
+        std::lock_guard<std::mutex> lock(_lock);
+        for (uint8 metric = 0; metric < MAX_LEADERBOARD_METRICS; ++metric)
+        {
+            if (metric == LEADERBOARD_FASTEST_CLEAR && !cleared)
+                continue;
+            TrialLeaderboardMetric m = TrialLeaderboardMetric(metric);
+            OfferUnsaved(m, MakeBoardId(LEADERBOARD_SCOPE_OVERALL, 0), entry);
+            OfferUnsaved(m, MakeBoardId(LEADERBOARD_SCOPE_CLASS, entry.Class), entry);
+            if (bandKey)
+                OfferUnsaved(m, MakeBoardId(LEADERBOARD_SCOPE_BAND, bandKey), entry);
+        }
     }
 
-    void Update(uint32 diff) override
+    std::vector<TrialLeaderboardEntry> GetBoard(TrialLeaderboardMetric metric, TrialLeaderboardScope scope, uint32 key)
     {
-        scheduler.Update(diff);
+        std::lock_guard<std::mutex> lock(_lock);
+        auto it = _boards[metric].find(MakeBoardId(scope, key));
+        if (it == _boards[metric].end())
+            return {};
+        return it->second.GetEntries();
+    }
 
-        // --- Boundary Check ---
-        if (boundaryCheckTimer <= diff)
-        {
-            boundaryCheckTimer = 5000; // Reset timer
-            if (GetBossState(currentWave -1) == IN_PROGRESS)
-                CheckPlayerLocationsAndEnforceBoundaries();
-        }
-        else
+    void LoadFromDB()
+    {
         {
-            boundaryCheckTimer -= diff;
+            std::lock_guard<std::mutex> lock(_lock);
+            for (auto& boards : _boards)
+                boards.clear();
+            _unsaved.clear();
         }
+        uint32 count = MergeRows(CharacterDatabase.Query(LOAD_QUERY));
+        sLog->outInfo("sys", "[TrialOfFinality] Loaded %u leaderboard entries.", count);
+    }
 
-        // --- Forfeit Vote Check ---
-        if (forfeitCheckTimer <= diff)
+    // Upserts the results that entered a board since the last write, one row per character and board. Several
+    // worldservers may share the table: a row is only replaced by a better result, and no node deletes rows.
+    void SaveToDB()
+    {
+        std::ostringstream insert;
+        uint32 rows = 0;
         {
-            forfeitCheckTimer = 1000; // Reset timer
-            if (forfeitVoteInProgress)
+            std::lock_guard<std::mutex> lock(_lock);
+            if (_unsaved.empty())
+                return;
+            insert << "INSERT INTO trial_of_finality_leaderboard (metric, scope, scope_key, player_guid, player_name, class, level, waves, duration_ms, achieved_at) VALUES ";
+            for (UnsavedEntry const& unsaved : _unsaved)
             {
-                // Timeout Check
-                if (time(nullptr) - forfeitVoteStartTime > 30)
-                {
-                    forfeitVoteInProgress = false;
-                    playersWhoVotedForfeit.clear();
-                    std::string msg = "The vote to forfeit the trial has failed to pass in time and is now cancelled.";
-                    uint32 groupId = 0;
-                    if (!instance->GetPlayers().isEmpty())
-                        if (Player* p = instance->GetPlayers().begin()->GetSource())
-                            if (p->GetGroup())
-                                groupId = p->GetGroup()->GetId();
-                    LogTrialDbEvent(TRIAL_EVENT_FORFEIT_VOTE_CANCEL, groupId, nullptr, currentWave, highestLevelAtStart, "Vote timed out.");
-                    DoSendNotifyToInstance(msg.c_str());
-                }
+                TrialLeaderboardEntry const& entry = unsaved.Entry;
+                std::string name = entry.PlayerName;
+                CharacterDatabase.EscapeString(name);
+                insert << (rows++ ? "," : "") << "(" << uint32(unsaved.Metric) << "," << (unsaved.BoardId >> 16) << "," << (unsaved.BoardId & 0xFFFF) << ","
+                    << entry.PlayerGuid << ",'" << name << "'," << uint32(entry.Class) << "," << uint32(entry.Level) << ","
+                    << uint32(entry.Waves) << "," << entry.DurationMs << "," << entry.AchievedAt << ")";
             }
+            _unsaved.clear();
         }
-        else
+
+        // The same ordering as TrialTopK::IsBetter. Columns are assigned least significant first, so every
+        // comparison still sees the old value of each column that decides it.
+        static char const* const better = "((metric = 1 AND VALUES(waves) > waves) OR ((metric = 0 OR VALUES(waves) = waves) AND "
+            "(VALUES(duration_ms) < duration_ms OR (VALUES(duration_ms) = duration_ms AND VALUES(achieved_at) < achieved_at))))";
+        insert << " ON DUPLICATE KEY UPDATE";
+        char const* const columns[] = { "player_name", "class", "level", "achieved_at", "duration_ms", "waves" };
+        for (size_t i = 0; i < std::size(columns); ++i)
+            insert << (i ? ", " : " ") << columns[i] << " = IF(" << better << ", VALUES(" << columns[i] << "), " << columns[i] << ")";
+        CharacterDatabase.Execute(insert.str().c_str());
+        sLog->outDetail("[TrialOfFinality] Leaderboards saved (%u entries).", rows);
+    }
+
+    // Called from the world thread. Writes this node's new results, then merges in what the other nodes wrote.
+    void Update(uint32 diff)
+    {
+        _queryProcessor.ProcessReadyCallbacks();
+        if (_saveTimer > diff)
         {
-            forfeitCheckTimer -= diff;
+            _saveTimer -= diff;
+            return;
         }
+        _saveTimer = LeaderboardSaveIntervalMs;
+        SaveToDB();
+        _queryProcessor.AddCallback(CharacterDatabase.AsyncQuery(LOAD_QUERY).WithCallback([this](QueryResult result)
+        {
+            MergeRows(result);
+        }));
     }
 
-    void HandleMonsterKilled(Creature* creature)
+private:
+    TrialLeaderboards() { }
+    ~TrialLeaderboards() { }
+    TrialLeaderboards(const TrialLeaderboards&) = delete;
+    TrialLeaderboards& operator=(const TrialLeaderboards&) = delete;
+
+    static constexpr char const* LOAD_QUERY = "SELECT metric, scope, scope_key, player_guid, player_name, class, level, waves, duration_ms, achieved_at FROM trial_of_finality_leaderboard";
+
+    struct UnsavedEntry
     {
-        if (activeMonsters.erase(creature->GetGUID()))
+        TrialLeaderboardMetric Metric;
+        uint32 BoardId;
+        TrialLeaderboardEntry Entry;
+    };
+
+    void OfferUnsaved(TrialLeaderboardMetric metric, uint32 boardId, const TrialLeaderboardEntry& entry)
+    {
+        if (_boards[metric][boardId].Offer(metric, entry, LeaderboardSize))
+            _unsaved.push_back({ metric, boardId, entry });
+    }
+
+    // Rows of every node go through Offer(), which keeps each character's best result and applies the
+    // current size, so row order, rows that have since dropped off a board and a changed Leaderboard.Size
+    // do not matter. Merged rows are already in the table and are not written back.
+    uint32 MergeRows(QueryResult result)
+    {
+        uint32 count = 0;
+        if (!result)
+            return count;
+        std::lock_guard<std::mutex> lock(_lock);
+        do
         {
-            sLog->outDetail("[TrialOfFinality] Instance %u killed a trial monster. %lu remaining in wave %d.",
-                instance->GetInstanceId(), activeMonsters.size(), currentWave);
+            Field* fields = result->Fetch();
+            uint8 metric = fields[0].Get<uint8>();
+            if (metric >= MAX_LEADERBOARD_METRICS)
+                continue;
+            TrialLeaderboardEntry entry;
+            entry.PlayerGuid = fields[3].Get<uint32>();
+            entry.PlayerName = fields[4].Get<std::string>();
+            entry.Class = fields[5].Get<uint8>();
+            entry.Level = fields[6].Get<uint8>();
+            entry.Waves = fields[7].Get<uint8>();
+            entry.DurationMs = fields[8].Get<uint32>();
+            entry.AchievedAt = fields[9].Get<uint32>();
+            _boards[metric][MakeBoardId(TrialLeaderboardScope(fields[1].Get<uint8>()), fields[2].Get<uint32>())]
+                .Offer(TrialLeaderboardMetric(metric), entry, LeaderboardSize);
+            ++count;
+        } while (result->NextRow());
+        return count;
+    }
 
-            if (activeMonsters.empty())
-            {
-                sLog->outInfo("sys", "[TrialOfFinality] Instance %u has cleared wave %d.", instance->GetInstanceId(), currentWave);
-                SetBossState(currentWave - 1, DONE); // Mark current wave as done (wave 1 is boss 0)
+    std::mutex _lock;
+    std::unordered_map<uint32, TrialTopK> _boards[MAX_LEADERBOARD_METRICS];
+    std::vector<UnsavedEntry> _unsaved;     // Results that entered a board since the last write
+    uint32 _saveTimer = 0;
+    QueryCallbackProcessor _queryProcessor;
+};
 
-                // Clear any downed players from the previous wave - they are now safe
-                if (!downedPlayerGuids.empty())
-                {
-                    instance->DoForAllPlayers([this](Player* player)
-                    {
-                        if (downedPlayerGuids.count(player->GetGUID()))
-                        {
-                            ChatHandler(player->GetSession()).SendSysMessage("The wave is over! You have survived... for now.");
-                        }
-                    });
-                    downedPlayerGuids.clear();
-                }
+// Formats a run duration as "12m 05s".
+std::string FormatTrialDuration(uint32 durationMs)
+{
+    uint32 seconds = durationMs / IN_MILLISECONDS;
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%um %02us", seconds / MINUTE, seconds % MINUTE);
+    return buffer;
+}
 
-                if (currentWave < 5)
-                {
-                    PrepareAndAnnounceWave(currentWave + 1, 8000); // 8 second delay between waves
-                    SetBossState(currentWave, IN_PROGRESS);
-                }
-                else
-                {
-                    FinalizeTrialOutcome(true, "All 5 waves successfully cleared.");
-                }
-            }
-        }
+std::string FormatLeaderboardLine(TrialLeaderboardMetric metric, uint32 position, const TrialLeaderboardEntry& entry)
+{
+    std::string line = std::to_string(position) + ". " + entry.PlayerName + " (" + std::to_string(entry.Level) + ") - ";
+    if (metric == LEADERBOARD_MOST_WAVES)
+        line += std::to_string(entry.Waves) + " waves, ";
+    return line + FormatTrialDuration(entry.DurationMs);
+}
+
+// --- Shared Perma-Death Status ---
+// Several worldservers may share one character database. Every write to character_trial_finality_status
+// appends a row to character_trial_finality_status_log in the same transaction, after the status row, so
+// two writes for one character are serialized by that row's lock and their log versions follow commit
+// order. Each node keeps the sealed characters in memory and polls only the log rows after its cursor.
+class TrialStatusCache
+{
+public:
+    static TrialStatusCache* instance() { static TrialStatusCache instance; return &instance; }
+
+    // A version missing from the log is waited for this long (a transaction still committing), then
+    // skipped (a rolled back insert leaves a permanent hole in the auto-increment sequence).
+    static constexpr uint32 GAP_TIMEOUT_MS = 30000;
+    // Rows re-read after the startup load, so a write committing during the load is not missed.
+    static constexpr uint64 STARTUP_REWIND = 64;
+    static constexpr uint32 POLL_BATCH = 500;
+
+    bool IsReady() const { return _ready.load(std::memory_order_acquire); }
+
+    bool IsSealed(uint32 guid)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        return _sealed.count(guid) > 0;
     }
 
-    void OnCreatureCreate(Creature* creature) override
+    // Returns the first sealed member of the roster, or 0.
+    uint32 FindSealed(const std::vector<ObjectGuid>& roster)
     {
-        if (creature->GetEntry() == AnnouncerEntry)
-        {
-            announcerGuid = creature->GetGUID();
-        }
-        else if (creature->IsHostileToPlayers()) // A simple way to identify trial monsters
-        {
-            activeMonsters.insert(creature->GetGUID());
-        }
+        std::lock_guard<std::mutex> lock(_lock);
+        for (ObjectGuid const& guid : roster)
+            if (_sealed.count(guid.GetCounter()))
+                return guid.GetCounter();
+        return 0;
     }
 
-    void OnPlayerEnter(Player* player) override
+    // A write made by this node is visible here at once; the log row comes back later and changes nothing.
+    void SetLocal(uint32 guid, bool sealed)
     {
-        if (!player)
-        {
-            return;
-        }
+        std::lock_guard<std::mutex> lock(_lock);
+        if (sealed)
+            _sealed.insert(guid);
+        else
+            _sealed.erase(guid);
+    }
+
+    void LoadFromDB()
+    {
+        // The cursor is read before the table: anything committed in between is applied again by the first poll.
+        uint64 maxVersion = 0;
+        if (QueryResult result = CharacterDatabase.Query("SELECT COALESCE(MAX(version), 0) FROM character_trial_finality_status_log"))
+            maxVersion = (*result)[0].Get<uint64>();
 
-        // The first player to enter initializes the instance's difficulty and starts the trial.
-        if (GetBossState(0) == NOT_STARTED)
+        std::unordered_set<uint32> sealed;
+        if (QueryResult result = CharacterDatabase.Query("SELECT guid FROM character_trial_finality_status WHERE is_perma_failed = 1"))
         {
-            if (PreTrialData* data = TrialManager::instance()->GetPreTrialData(player->GetGroup()->GetId()))
+            do
             {
-                highestLevelAtStart = data->highestLevel;
-                isTestTrial = data->isTestTrial;
-                TrialManager::instance()->CleanupPreTrialData(player->GetGroup()->GetId()); // Clean up the cached data
-                sLog->outInfo("sys", "[TrialOfFinality] Instance %u initialized for group %u with highest level %u.", instance->GetInstanceId(), player->GetGroup()->GetId(), highestLevelAtStart);
+                sealed.insert((*result)[0].Get<uint32>());
+            } while (result->NextRow());
+        }
 
-                // Start Wave 1
-                PrepareAndAnnounceWave(1, 5000);
-                SetBossState(0, IN_PROGRESS);
-                LogTrialDbEvent(TRIAL_EVENT_START, player->GetGroup()->GetId(), player, 0, highestLevelAtStart, "Trial started in instance.");
-            }
-            else
-            {
-                sLog->outError("sys", "[TrialOfFinality] Could not find pre-trial data for group %u when entering instance %u. Aborting.", player->GetGroup()->GetId(), instance->GetInstanceId());
-                player->TeleportTo(player->GetBindPoint());
-                return;
-            }
+        uint32 sealedCount = uint32(sealed.size());
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            _sealed.swap(sealed);
+            _cursor = maxVersion > STARTUP_REWIND ? maxVersion - STARTUP_REWIND : 0;
+            _gaps.clear();
         }
+        _ready.store(true, std::memory_order_release);
+        sLog->outInfo("sys", "[TrialOfFinality] Perma-death status cache loaded: %u sealed characters, change log at version %llu.",
+            sealedCount, (unsigned long long)maxVersion);
+    }
 
-        // Setup for each player entering
-        player->SetDisableXpGain(true, true);
-        player->AddItem(TrialTokenEntry, 1);
-        ChatHandler(player->GetSession()).SendSysMessage("The Trial of Finality has begun!");
+    // Stops answering from memory when StatusSync is switched off; LoadFromDB starts over from the table.
+    void Reset()
+    {
+        _ready.store(false, std::memory_order_release);
+        std::lock_guard<std::mutex> lock(_lock);
+        _sealed.clear();
+        _gaps.clear();
+        sLog->outInfo("sys", "[TrialOfFinality] Perma-death status cache disabled; status checks query the database.");
     }
 
-    // --- Wave Management ---
-    void PrepareAndAnnounceWave(int waveNumber, uint32 delayMs)
+    // World thread. Runs finished poll callbacks and starts the next poll once the interval has passed.
+    void Update(uint32 diff)
     {
-        currentWave = waveNumber;
-        uint32 groupId = 0;
-        if (!instance->GetPlayers().isEmpty())
-            if (Player* p = instance->GetPlayers().begin()->GetSource())
-                if (p->GetGroup())
-                    groupId = p->GetGroup()->GetId();
-        sLog->outInfo("sys", "[TrialOfFinality] Instance %u preparing for wave %d.", instance->GetInstanceId(), waveNumber);
-        LogTrialDbEvent(TRIAL_EVENT_WAVE_START, groupId, nullptr, waveNumber, highestLevelAtStart, "Announcing wave.");
+        _queryProcessor.ProcessReadyCallbacks();
 
-        Creature* announcer = nullptr;
-        if (announcerGuid.IsEmpty())
+        if (_pruneTimer <= diff)
         {
-            Position announcerPos = { ArenaTeleportX + 5.0f, ArenaTeleportY, ArenaTeleportZ, ArenaTeleportO };
-            announcer = instance->SummonCreature(AnnouncerEntry, announcerPos, TEMPSUMMON_MANUAL_DESPAWN);
+            _pruneTimer = HOUR * IN_MILLISECONDS;
+            CharacterDatabase.Execute(("DELETE FROM character_trial_finality_status_log WHERE changed_at < NOW() - INTERVAL " + std::to_string(StatusSyncRetentionHours) + " HOUR").c_str());
         }
         else
+            _pruneTimer -= diff;
+
+        if (_pollTimer > diff)
         {
-            announcer = instance->GetCreature(announcerGuid);
+            _pollTimer -= diff;
+            return;
         }
+        _pollTimer = StatusSyncPollIntervalMs;
+        if (_pollInFlight)
+            return;
 
-        if (announcer)
+        _pollInFlight = true;
+        uint64 cursor;
         {
-            if (auto* ai = dynamic_cast<npc_trial_announcer_ai*>(announcer->AI()))
-                ai->AnnounceWave(waveNumber);
-            else
-            {
-                std::string waveAnnounce = "Brave contenders, prepare yourselves! Wave " + std::to_string(waveNumber) + " approaches!";
-                announcer->Yell(waveAnnounce, LANG_UNIVERSAL, nullptr);
-            }
+            std::lock_guard<std::mutex> lock(_lock);
+            cursor = _cursor;
         }
+        uint64 issuedNs = TrialPerfNowNs();
+        _queryProcessor.AddCallback(
+            CharacterDatabase.AsyncQuery(("SELECT version, guid, is_perma_failed FROM character_trial_finality_status_log WHERE version > " +
+                std::to_string(cursor) + " ORDER BY version LIMIT " + std::to_string(POLL_BATCH)).c_str())
+            .WithCallback([this, issuedNs](QueryResult result)
+            {
+                TrialMetrics::RecordDbLatency(issuedNs);
+                _pollInFlight = false;
+                if (ApplyChanges(result))
+                    _pollTimer = 0; // A full batch that moved the cursor: more rows are waiting
+            }));
+    }
 
-        scheduler.Schedule(std::chrono::milliseconds(delayMs), [this]()
-        {
-            SpawnActualWave();
-        });
+    void GetStats(uint64& cursor, uint32& sealed, uint32& gaps, uint64& applied)
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        cursor = _cursor;
+        sealed = uint32(_sealed.size());
+        gaps = uint32(_gaps.size());
+        applied = _applied;
     }
 
-    void SpawnActualWave()
+private:
+    TrialStatusCache() { }
+    ~TrialStatusCache() { }
+    TrialStatusCache(const TrialStatusCache&) = delete;
+    TrialStatusCache& operator=(const TrialStatusCache&) = delete;
+
+    // Rows come in version order. Rows past an open gap are applied now and read again on the next
+    // poll, which is harmless: replaying a suffix of the log in order ends in the same state.
+    bool ApplyChanges(QueryResult result)
     {
-        uint32 activePlayers = 0;
-        instance->DoForAllPlayers([&](Player* player)
+        uint32 now = getMSTime();
+        uint32 rows = 0;
+        std::lock_guard<std::mutex> lock(_lock);
+        uint64 previousCursor = _cursor;
+        uint64 expected = _cursor + 1;
+        uint64 highest = _cursor;
+        if (result)
         {
-            if (player->IsAlive() && !downedPlayerGuids.count(player->GetGUID()))
-                activePlayers++;
-        });
+            do
+            {
+                Field* fields = result->Fetch();
+                uint64 version = fields[0].Get<uint64>();
+                if (version <= previousCursor)
+                    continue; // A poll issued before a reload of the cache; the load already covers it
+                if (fields[2].Get<bool>())
+                    _sealed.insert(fields[1].Get<uint32>());
+                else
+                    _sealed.erase(fields[1].Get<uint32>());
+                ++_applied;
+                ++rows;
+
+                _gaps.erase(version);
+                for (uint64 missing = expected; missing < version && _gaps.size() < POLL_BATCH; ++missing)
+                    _gaps.emplace(missing, now);
+                expected = version + 1;
+                highest = std::max(highest, version);
+            } while (result->NextRow());
+        }
 
-        if (activePlayers == 0)
+        for (auto it = _gaps.begin(); it != _gaps.end();)
         {
-            sLog->outError("sys", "[TrialOfFinality] Instance %u, Wave %d: No active players left to spawn wave for. Finalizing trial.", instance->GetInstanceId(), currentWave);
-            // FinalizeTrialOutcome(false, "All players defeated or disconnected before wave " + std::to_string(currentWave) + " could spawn."); // to be implemented
-            return;
+            if (getMSTimeDiff(it->second, now) > GAP_TIMEOUT_MS)
+                it = _gaps.erase(it);
+            else
+                ++it;
         }
+        _cursor = _gaps.empty() ? highest : std::max(_cursor, _gaps.begin()->first - 1);
+        return rows == POLL_BATCH && _cursor > previousCursor;
+    }
 
-        const std::vector<std::vector<uint32>>* currentWaveNpcPool = nullptr;
-        const CustomNpcScalingTier* customScalingTier = nullptr;
-        float healthMultiplier = 1.0f;
-        const std::vector<uint32>* aurasToAdd = nullptr;
+    std::mutex _lock;
+    std::atomic<bool> _ready{ false };
+    std::unordered_set<uint32> _sealed;
+    uint64 _cursor = 0;                 // Every version up to here has been applied
+    std::map<uint64, uint32> _gaps;     // Missing version -> first noticed
+    uint64 _applied = 0;
+    bool _pollInFlight = false;
+    uint32 _pollTimer = 0;
+    uint32 _pruneTimer = 0;
+    QueryCallbackProcessor _queryProcessor;
+};
 
-        if (currentWave <= 2) {
-            currentWaveNpcPool = &NpcPoolEasy;
-            customScalingTier = &CustomScalingEasy;
-        } else if (currentWave <= 4) {
-            currentWaveNpcPool = &NpcPoolMedium;
-            customScalingTier = &CustomScalingMedium;
-        } else {
-            currentWaveNpcPool = &NpcPoolHard;
-            customScalingTier = &CustomScalingHard;
-        }
+// The only way the module writes perma-death status.
+void WriteTrialPermaDeathStatus(uint32 guid, bool sealed)
+{
+    std::string guidStr = std::to_string(guid);
+    auto trans = CharacterDatabase.BeginTransaction();
+    if (sealed)
+        trans->Append(("INSERT INTO character_trial_finality_status (guid, is_perma_failed, last_failed_timestamp) VALUES (" + guidStr + ", 1, NOW()) ON DUPLICATE KEY UPDATE is_perma_failed = 1, last_failed_timestamp = NOW()").c_str());
+    else
+        trans->Append(("UPDATE character_trial_finality_status SET is_perma_failed = 0, last_failed_timestamp = NULL WHERE guid = " + guidStr).c_str());
+    trans->Append(("INSERT INTO character_trial_finality_status_log (guid, is_perma_failed) VALUES (" + guidStr + (sealed ? ", 1)" : ", 0)")).c_str());
+    CharacterDatabase.CommitTransaction(trans);
+    TrialStatusCache::instance()->SetLocal(guid, sealed);
+    if (sealed)
+        TrialMetrics::Add(TRIAL_METRIC_PERMADEATHS);
+}
 
-        if (NpcScalingMode == "custom_scaling_rules" && customScalingTier) {
-            healthMultiplier = customScalingTier->HealthMultiplier;
-            aurasToAdd = &customScalingTier->AurasToAdd;
-        }
+// --- Metrics Exporter ---
+// Writes the metrics in the Prometheus text format for node_exporter's textfile collector. The file is
+// written next to it and renamed into place, so a scrape never reads a half-written file.
+class TrialMetricsExporter
+{
+public:
+    static TrialMetricsExporter* instance() { static TrialMetricsExporter instance; return &instance; }
 
-        if (!currentWaveNpcPool || currentWaveNpcPool->empty()) {
-            sLog->outError("sys", "[TrialOfFinality] Instance %u, Wave %d: Cannot spawn wave. NPC pool for this difficulty is empty.", instance->GetInstanceId(), currentWave);
-            // FinalizeTrialOutcome(false, "Internal error: NPC pool empty for wave " + std::to_string(currentWave));
+    void Update(uint32 diff)
+    {
+        if (_timer > diff)
+        {
+            _timer -= diff;
             return;
         }
+        _timer = MetricsIntervalSeconds * IN_MILLISECONDS;
+        Export();
+    }
 
-        if (WAVE_SPAWN_POSITIONS.empty()) {
-            sLog->outError("sys", "[TrialOfFinality] Instance %u, Wave %d: Cannot spawn wave. No spawn positions are configured or loaded.", instance->GetInstanceId(), currentWave);
-            // FinalizeTrialOutcome(false, "Internal error: No spawn positions configured.");
+    void Export()
+    {
+        std::array<int64, TRIAL_METRIC_COUNT> totals = TrialMetrics::Collect();
+        uint32 now = getMSTime();
+        double minutes = _lastExportMs ? std::max(1u, getMSTimeDiff(_lastExportMs, now)) / 60000.0 : 0.0;
+
+        std::ostringstream out;
+        WriteCounter(out, "trials_started_total", "Trials that left the lobby.", totals[TRIAL_METRIC_TRIALS_STARTED]);
+        WriteCounter(out, "trials_completed_total", "Trials cleared.", totals[TRIAL_METRIC_TRIALS_COMPLETED]);
+        WriteCounter(out, "trials_failed_total", "Trials failed.", totals[TRIAL_METRIC_TRIALS_FAILED]);
+        WriteCounter(out, "trials_forfeited_total", "Trials ended by a forfeit vote.", totals[TRIAL_METRIC_TRIALS_FORFEITED]);
+        WriteGauge(out, "trials_started_per_minute", "Trials started per minute since the previous export.", minutes ? (totals[TRIAL_METRIC_TRIALS_STARTED] - _previous[TRIAL_METRIC_TRIALS_STARTED]) / minutes : 0.0);
+        WriteGauge(out, "trials_completed_per_minute", "Trials cleared per minute since the previous export.", minutes ? (totals[TRIAL_METRIC_TRIALS_COMPLETED] - _previous[TRIAL_METRIC_TRIALS_COMPLETED]) / minutes : 0.0);
+        WriteGauge(out, "trials_failed_per_minute", "Trials failed per minute since the previous export.", minutes ? (totals[TRIAL_METRIC_TRIALS_FAILED] - _previous[TRIAL_METRIC_TRIALS_FAILED]) / minutes : 0.0);
+        WriteGauge(out, "trials_active", "Trial instances with a running trial.", double(totals[TRIAL_METRIC_TRIALS_ACTIVE]));
+        WriteGauge(out, "queue_length", "Groups waiting for the perma-death check or for member confirmation.", double(TrialManager::instance()->GetQueueLength()));
+        WriteCounter(out, "waves_spawned_total", "Waves spawned.", totals[TRIAL_METRIC_WAVES_SPAWNED]);
+        WriteGauge(out, "creatures_alive", "Wave creatures alive in all trial instances.", double(totals[TRIAL_METRIC_CREATURES_ALIVE]));
+        WriteCounter(out, "permadeaths_total", "Perma-deaths applied.", totals[TRIAL_METRIC_PERMADEATHS]);
+        WriteGauge(out, "db_async_queue_size", "Statements waiting in the characters database async queue, which holds the trial log writes.", double(CharacterDatabase.QueueSize()));
+        WriteCounter(out, "db_queries_total", "Module queries whose result was waited for.", totals[TRIAL_METRIC_DB_QUERIES]);
+        WriteCounter(out, "db_query_seconds_total", "Time spent waiting for module query results.", totals[TRIAL_METRIC_DB_QUERY_MICROS] / 1e6);
+        _previous = totals;
+        _lastExportMs = now;
+
+        std::string temp = MetricsFile + ".tmp";
+        FILE* file = fopen(temp.c_str(), "w");
+        if (!file)
+        {
+            sLog->outError("sys", "[TrialOfFinality] Could not write metrics file '%s'.", temp.c_str());
             return;
         }
-        uint32 numSpawnsPerWave = WAVE_SPAWN_POSITIONS.size();
+        std::string text = out.str();
+        bool written = fwrite(text.data(), 1, text.size(), file) == text.size();
+        written = (fclose(file) == 0) && written;
+        if (!written || std::rename(temp.c_str(), MetricsFile.c_str()) != 0)
+            sLog->outError("sys", "[TrialOfFinality] Could not replace metrics file '%s'.", MetricsFile.c_str());
+    }
 
-        uint32 numGroupsToSpawn = std::min((uint32)numSpawnsPerWave, activePlayers + 1);
-        numGroupsToSpawn = std::max(numGroupsToSpawn, 1u);
+private:
+    TrialMetricsExporter() { }
+    ~TrialMetricsExporter() { }
+    TrialMetricsExporter(const TrialMetricsExporter&) = delete;
+    TrialMetricsExporter& operator=(const TrialMetricsExporter&) = delete;
 
-        if (numGroupsToSpawn > currentWaveNpcPool->size()) {
-            sLog->outWarn("sys", "[TrialOfFinality] Instance %u, Wave %d: Requested %u encounter groups, but pool only has %lu. Spawning %lu instead.",
-                instance->GetInstanceId(), currentWave, numGroupsToSpawn, currentWaveNpcPool->size(), currentWaveNpcPool->size());
-            numGroupsToSpawn = currentWaveNpcPool->size();
-        }
+    template<typename T>
+    static void Write(std::ostringstream& out, const char* type, const char* name, const char* help, T value)
+    {
+        out << "# HELP trial_of_finality_" << name << ' ' << help << "\n"
+            << "# TYPE trial_of_finality_" << name << ' ' << type << "\n"
+            << "trial_of_finality_" << name << ' ' << value << "\n";
+    }
+    template<typename T>
+    static void WriteCounter(std::ostringstream& out, const char* name, const char* help, T value) { Write(out, "counter", name, help, value); }
+    static void WriteGauge(std::ostringstream& out, const char* name, const char* help, double value) { Write(out, "gauge", name, help, value); }
 
-        std::vector<std::vector<uint32>> selectedGroups = *currentWaveNpcPool;
-        std::random_device rd;
-        std::mt19937 g(rd());
-        std::shuffle(selectedGroups.begin(), selectedGroups.end(), g);
+    uint32 _timer = 0;
+    uint32 _lastExportMs = 0;
+    std::array<int64, TRIAL_METRIC_COUNT> _previous{};
+};
 
-        sLog->outInfo("sys", "[TrialOfFinality] Instance %u, Wave %d: Spawning %u encounter groups. Highest Lvl: %u. Health Multi: %.2f",
-            instance->GetInstanceId(), currentWave, numGroupsToSpawn, highestLevelAtStart, healthMultiplier);
-        activeMonsters.clear();
+// --- TrialManager Method Implementations ---
+bool TrialManager::ValidateGroupForTrial(Player* leader, Creature* trialNpc, std::vector<ObjectGuid>& memberGuids,
+    const std::set<ObjectGuid>* onlyMembers) {
+    ChatHandler handler(leader->GetSession());
+    Group* group = leader->GetGroup();
 
-        uint32 spawnPosIndex = 0;
-        for (uint32 i = 0; i < numGroupsToSpawn; ++i)
-        {
-            const std::vector<uint32>& groupOfNpcs = selectedGroups[i];
-            if (spawnPosIndex + groupOfNpcs.size() > numSpawnsPerWave)
-                continue;
+    if (!group) {
+        TrialTextCache::instance()->SendSysMessage(leader, TRIAL_STRING_NOT_IN_GROUP);
+        return false;
+    }
+    if (group->GetLeaderGUID() != leader->GetGUID()) {
+        TrialTextCache::instance()->SendSysMessage(leader, TRIAL_STRING_NOT_GROUP_LEADER);
+        return false;
+    }
 
-            for (uint32 creatureEntry : groupOfNpcs)
-            {
-                const Position& spawnPos = WAVE_SPAWN_POSITIONS[spawnPosIndex++];
-                if (Creature* creature = instance->SummonCreature(creatureEntry, spawnPos, TEMPSUMMON_TIMED_DESPAWN_OUT_OF_COMBAT, 3600 * 1000))
-                {
-                    creature->SetAI(new npc_trial_monster_ai(creature));
-                    creature->SetLevel(highestLevelAtStart);
-                    if (healthMultiplier != 1.0f)
-                    {
-                        creature->SetMaxHealth(uint32(creature->GetMaxHealth() * healthMultiplier));
-                        creature->SetHealth(creature->GetMaxHealth());
-                    }
-                    if (aurasToAdd)
-                    {
-                        for (uint32 auraId : *aurasToAdd)
-                            creature->AddAura(auraId, creature);
-                    }
-                    // OnCreatureCreate will add to activeMonsters
-                }
+    uint8 memberCount = 0;
+    uint8 minLevel = 255, maxLevel = 0;
+    memberGuids.clear();
+
+    for (GroupReference* itr = group->GetFirstMember(); itr != nullptr; itr = itr->next()) {
+        Player* member = itr->GetSource();
+        if (!member || !member->GetSession()) {
+            continue; // Skip offline members
+        }
+        if (onlyMembers && member != leader && !onlyMembers->count(member->GetGUID())) {
+            continue;
+        }
+        memberCount++;
+        memberGuids.push_back(member->GetGUID());
+
+        if (member->getLevel() > maxLevel) maxLevel = member->getLevel();
+        if (member->getLevel() < minLevel) minLevel = member->getLevel();
+
+        if (!trialNpc->IsWithinDistInMap(member, 50.0f)) {
+            handler.PSendSysMessage(TRIAL_STRING_VALIDATION_TOO_FAR, member->GetName().c_str());
+            return false;
+        }
+
+        if (member->GetSession()->IsPlayerBot()) {
+            // Playerbots are allowed if the leader is a GM and the debug setting is enabled
+            if (leader->GetSession()->GetSecurity() >= SEC_GAMEMASTER && GMDebugAllowPlayerbots) {
+                handler.PSendSysMessage(TRIAL_STRING_VALIDATION_BOT_PERMITTED, member->GetName().c_str());
+            } else {
+                handler.PSendSysMessage(TRIAL_STRING_VALIDATION_BOT_FORBIDDEN, member->GetName().c_str());
+                return false;
             }
         }
+
+        if (member->HasItemCount(TrialTokenEntry, 1, true)) {
+            handler.PSendSysMessage(TRIAL_STRING_VALIDATION_HAS_TOKEN, member->GetName().c_str());
+            return false;
+        }
+    }
+
+    if (memberCount < MinGroupSize) {
+        handler.PSendSysMessage(TRIAL_STRING_VALIDATION_TOO_SMALL, MinGroupSize);
+        return false;
+    }
+    if (memberCount > MaxGroupSize) {
+        handler.PSendSysMessage(TRIAL_STRING_VALIDATION_TOO_LARGE, MaxGroupSize);
+        return false;
+    }
+    if ((maxLevel - minLevel) > MaxLevelDifference) {
+        handler.PSendSysMessage(TRIAL_STRING_VALIDATION_LEVEL_SPREAD, MaxLevelDifference);
+        return false;
+    }
+    if (!IsTrialLevelCovered(maxLevel)) {
+        handler.PSendSysMessage(TRIAL_STRING_VALIDATION_LEVEL_UNCOVERED, uint32(maxLevel));
+        return false;
+    }
+
+    std::sort(memberGuids.begin(), memberGuids.end());
+    return true;
+}
+
+void TrialManager::RequestTrialStart(Player* leader, Creature* trialNpc)
+{
+    std::vector<ObjectGuid> roster;
+    if (!ValidateGroupForTrial(leader, trialNpc, roster))
+        return;
+
+    uint32 groupId = leader->GetGroup()->GetId();
+    bool inFlight = false;
+    bool cached = false;
+    uint32 cachedSealedGuid = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_validationLock);
+        uint32 now = getMSTime();
+        GroupValidationEntry& entry = m_validations[groupId];
+        if (entry.IsInFlight(now))
+            inFlight = true;
+        else if (entry.HasResult && entry.Roster == roster && getMSTimeDiff(entry.CheckedAtMs, now) < ValidationCooldownMs)
+        {
+            cached = true;
+            cachedSealedGuid = entry.SealedGuid;
+        }
+        else
+        {
+            entry.Roster = roster;
+            entry.InFlight = true;
+            entry.HasResult = false;
+            entry.IssuedAtMs = now;
+        }
     }
 
-    // --- Player State and Trial Outcome ---
-    void HandlePlayerDowned(Player* downedPlayer)
+    if (inFlight)
     {
-        if (!downedPlayer) return;
-
-        ObjectGuid playerGuid = downedPlayer->GetGUID();
-        downedPlayerGuids[playerGuid] = time(nullptr);
-        uint32 groupId = downedPlayer->GetGroup() ? downedPlayer->GetGroup()->GetId() : 0;
+        TrialTextCache::instance()->SendSysMessage(leader, TRIAL_STRING_VALIDATION_IN_PROGRESS);
+        return;
+    }
+    if (cached)
+    {
+        ContinueTrialStart(leader, trialNpc, roster, cachedSealedGuid);
+        return;
+    }
 
-        sLog->outInfo("sys", "[TrialOfFinality] Player %s (GUID %s, Instance %u) has been downed in wave %d.",
-            downedPlayer->GetName().c_str(), playerGuid.ToString().c_str(), instance->GetInstanceId(), currentWave);
+    // The shared status cache answers from memory; the database query below is the fallback without it.
+    if (TrialStatusCache::instance()->IsReady())
+    {
+        uint32 sealedGuid = TrialStatusCache::instance()->FindSealed(roster);
+        {
+            std::lock_guard<std::mutex> lock(m_validationLock);
+            m_validations.erase(groupId);
+        }
+        ContinueTrialStart(leader, trialNpc, roster, sealedGuid);
+        return;
+    }
 
-        ChatHandler(downedPlayer->GetSession()).SendSysMessage("You have been defeated! You must be resurrected before the wave ends to avoid permanent failure!");
-        LogTrialDbEvent(TRIAL_EVENT_PLAYER_DEATH_TOKEN, groupId, downedPlayer, currentWave, highestLevelAtStart, "Player downed, awaiting resurrection or wave end.");
+    std::string guidString;
+    for (size_t i = 0; i < roster.size(); ++i) {
+        guidString += std::to_string(roster[i].GetCounter());
+        if (i < roster.size() - 1) guidString += ",";
+    }
 
-        // Check if this was the last player
-        uint32 activePlayers = 0;
-        instance->DoForAllPlayers([&](Player* player)
+    ObjectGuid leaderGuid = leader->GetGUID();
+    ObjectGuid npcGuid = trialNpc->GetGUID();
+    uint64 issuedNs = TrialPerfNowNs();
+    QueryCallback callback = CharacterDatabase.AsyncQuery("SELECT guid FROM character_trial_finality_status WHERE guid IN (" + guidString + ") AND is_perma_failed = 1 LIMIT 1")
+        .WithCallback([this, leaderGuid, npcGuid, groupId, roster, issuedNs](QueryResult result)
         {
-            if (player->IsAlive() && !downedPlayerGuids.count(player->GetGUID()))
-                activePlayers++;
+            TrialMetrics::RecordDbLatency(issuedNs);
+            HandleSealedMemberResult(leaderGuid, npcGuid, groupId, roster, result);
         });
+    std::lock_guard<std::mutex> lock(m_queryLock);
+    m_incomingQueries.push_back(std::move(callback));
+}
 
-        if (activePlayers == 0)
-        {
-            sLog->outInfo("sys", "[TrialOfFinality] All players in instance %u are downed. Finalizing trial as a failure.", instance->GetInstanceId());
-            FinalizeTrialOutcome(false, "All players were defeated.");
-        }
+void TrialManager::HandleSealedMemberResult(ObjectGuid leaderGuid, ObjectGuid npcGuid, uint32 groupId, std::vector<ObjectGuid> roster, QueryResult result)
+{
+    uint32 sealedGuid = result ? (*result)[0].Get<uint32>() : 0;
+    {
+        std::lock_guard<std::mutex> lock(m_validationLock);
+        GroupValidationEntry& entry = m_validations[groupId];
+        entry.InFlight = false;
+        entry.HasResult = true;
+        entry.SealedGuid = sealedGuid;
+        entry.CheckedAtMs = getMSTime();
     }
 
-    void HandlePlayerResurrect(Player* player)
+    Player* leader = ObjectAccessor::FindPlayer(leaderGuid);
+    if (!leader || !leader->GetSession())
+        return;
+    Creature* trialNpc = ObjectAccessor::GetCreature(*leader, npcGuid);
+    if (!trialNpc)
     {
-        if (downedPlayerGuids.erase(player->GetGUID()))
-        {
-            uint32 groupId = player->GetGroup() ? player->GetGroup()->GetId() : 0;
-            sLog->outInfo("sys", "[TrialOfFinality] Player %s (GUID %s, Instance %u) was resurrected during the trial.",
-                player->GetName().c_str(), player->GetGUID().ToString().c_str(), instance->GetInstanceId());
-            ChatHandler(player->GetSession()).SendSysMessage("You have been resurrected! Your fate is no longer sealed... for now.");
-            LogTrialDbEvent(TRIAL_EVENT_PLAYER_RESURRECTED, groupId, player, currentWave, highestLevelAtStart, "Player resurrected mid-wave.");
-        }
+        TrialTextCache::instance()->SendSysMessage(leader, TRIAL_STRING_VALIDATION_NPC_GONE);
+        return;
     }
 
-    void FinalizeTrialOutcome(bool overallSuccess, const std::string& reason)
+    // The group may have changed while the query ran; re-run the cheap checks against the live state.
+    std::vector<ObjectGuid> currentRoster;
+    if (!ValidateGroupForTrial(leader, trialNpc, currentRoster))
+        return;
+    if (currentRoster != roster)
     {
-        uint32 groupId = 0;
-        Player* leader = nullptr;
-        if (!instance->GetPlayers().isEmpty())
-            if ((leader = instance->GetPlayers().begin()->GetSource()))
-                if (leader->GetGroup())
-                    groupId = leader->GetGroup()->GetId();
+        RequestTrialStart(leader, trialNpc);
+        return;
+    }
+    ContinueTrialStart(leader, trialNpc, roster, sealedGuid);
+}
 
-        sLog->outInfo("sys", "[TrialOfFinality] Finalizing trial for instance %u. Overall Success: %s. Reason: %s.",
-            instance->GetInstanceId(), (overallSuccess ? "Yes" : "No"), reason.c_str());
+void TrialManager::ContinueTrialStart(Player* leader, Creature* trialNpc, const std::vector<ObjectGuid>& roster, uint32 sealedGuid)
+{
+    if (sealedGuid)
+    {
+        std::string failedPlayerName;
+        if (!sCharacterCache->GetCharacterNameByGuid(ObjectGuid(HighGuid::Player, sealedGuid), failedPlayerName))
+            failedPlayerName = "GUID " + std::to_string(sealedGuid);
+        TrialTextCache::instance()->PSendSysMessage(leader, TRIAL_STRING_START_MEMBER_SEALED, failedPlayerName.c_str());
+        return;
+    }
 
-        if (!overallSuccess)
+    if (ConfirmationEnable && roster.size() > 1)
+        TrialManager::instance()->ProposeTrial(leader, trialNpc, roster);
+    else
+        StartTrialForGroup(leader);
+}
+
+void TrialManager::StartTrialForGroup(Player* player, const std::vector<ObjectGuid>* participants)
+{
+    auto isParticipant = [player, participants](Player* member) {
+        return !participants || member == player || std::find(participants->begin(), participants->end(), member->GetGUID()) != participants->end();
+    };
+
+    // Calculate highest level before creating the instance
+    uint8 highestLevel = 0;
+    if (Group* group = player->GetGroup())
+    {
+        for (GroupReference* itr = group->GetFirstMember(); itr != nullptr; itr = itr->next())
         {
-            SetBossState(currentWave - 1, FAIL);
-            if (!downedPlayerGuids.empty())
+            if (Player* member = itr->GetSource())
             {
-                for(const auto& pair : downedPlayerGuids)
+                if (member->GetSession() && isParticipant(member) && member->getLevel() > highestLevel)
                 {
-                    ObjectGuid playerGuid = pair.first;
-                    permanentlyFailedPlayerGuids.insert(playerGuid); // Mark for internal logic
-                    Player* downedPlayer = ObjectAccessor::FindPlayer(playerGuid);
-                    if (downedPlayer && downedPlayer->GetSession())
-                    {
-                        if (PermaDeathExemptGMs && downedPlayer->GetSession()->GetSecurity() >= SEC_GAMEMASTER)
-                        {
-                            sLog->outInfo("sys", "[TrialOfFinality] GM Player %s (GUID %s) is EXEMPT from perma-death.", downedPlayer->GetName().c_str(), playerGuid.ToString().c_str());
-                        }
-                        else
-                        {
-                            CharacterDatabase.ExecuteFmt("INSERT INTO character_trial_finality_status (guid, is_perma_failed, last_failed_timestamp) VALUES (%u, 1, NOW()) ON DUPLICATE KEY UPDATE is_perma_failed = 1, last_failed_timestamp = NOW()", playerGuid.GetCounter());
-                            sLog->outFatal("[TrialOfFinality] Player %s (GUID %s) PERMANENTLY FAILED due to trial failure: %s.", downedPlayer->GetName().c_str(), playerGuid.ToString().c_str(), reason.c_str());
-                            LogTrialDbEvent(TRIAL_EVENT_PERMADEATH_APPLIED, groupId, downedPlayer, currentWave, highestLevelAtStart, "Perma-death DB flag set: " + reason);
-                            ChatHandler(downedPlayer->GetSession()).SendSysMessage("The trial has ended in failure. Your fate is sealed.");
-                        }
-                    }
-                    else
-                    {
-                        CharacterDatabase.ExecuteFmt("INSERT INTO character_trial_finality_status (guid, is_perma_failed, last_failed_timestamp) VALUES (%u, 1, NOW()) ON DUPLICATE KEY UPDATE is_perma_failed = 1, last_failed_timestamp = NOW()", playerGuid.GetCounter());
-                        sLog->outFatal("[TrialOfFinality] Offline Player (GUID %s) PERMANENTLY FAILED due to trial failure: %s.", playerGuid.ToString().c_str(), reason.c_str());
-                        LogTrialDbEvent(TRIAL_EVENT_PERMADEATH_APPLIED, groupId, nullptr, currentWave, highestLevelAtStart, "Offline Player - Perma-death DB flag set: " + reason);
-                    }
+                    highestLevel = member->getLevel();
                 }
             }
-            downedPlayerGuids.clear();
-            LogTrialDbEvent(TRIAL_EVENT_TRIAL_FAILURE, groupId, leader, currentWave, highestLevelAtStart, reason);
-        }
-        else
-        {
-            LogTrialDbEvent(TRIAL_EVENT_TRIAL_SUCCESS, groupId, leader, currentWave, highestLevelAtStart, reason);
-            // World announcement and cheering logic could be triggered here if desired
         }
-        CleanupTrial(overallSuccess);
     }
 
-    void CleanupTrial(bool success)
+    if (highestLevel == 0)
     {
-        // Despawn any remaining monsters
-        for (const auto& monsterGuid : activeMonsters)
-            if (Creature* monster = instance->GetCreature(monsterGuid))
-                monster->DespawnOrUnsummon();
-        activeMonsters.clear();
+        sLog->outError("sys", "[TrialOfFinality] Could not start trial for group %u, unable to determine highest level.", player->GetGroup()->GetId());
+        TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_START_NO_LEVEL);
+        return;
+    }
 
-        // Despawn announcer
-        if (!announcerGuid.IsEmpty())
-            if (Creature* announcer = instance->GetCreature(announcerGuid))
-                announcer->DespawnOrUnsummon();
+    // Cache the data for the instance script to pick up
+    std::vector<ObjectGuid> expectedMembers;
+    for (GroupReference* itr = player->GetGroup()->GetFirstMember(); itr != nullptr; itr = itr->next())
+        if (Player* member = itr->GetSource())
+            if (member->GetSession() && isParticipant(member))
+                expectedMembers.push_back(member->GetGUID());
+    TrialManager::instance()->PrepareForInstance(player->GetGroup(), highestLevel, false, expectedMembers);
+
+    // Create a new private instance for the group
+    InstanceMap* instanceMap = sMapMgr->CreateNewInstance(ArenaMapID, player, INSTANCE_DIFFICULTY_NORMAL);
+    if (!instanceMap)
+    {
+        sLog->outError("sys", "[TrialOfFinality] Could not create instance map %u for group %u.", ArenaMapID, player->GetGroup()->GetId());
+        TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_START_NO_INSTANCE);
+        return;
+    }
 
-        // Process all players in the instance
-        instance->DoForAllPlayers([this, success](Player* player)
+    // Teleport all group members to the new instance
+    for (GroupReference* itr = player->GetGroup()->GetFirstMember(); itr != nullptr; itr = itr->next())
+    {
+        if (Player* member = itr->GetSource())
         {
-            player->DestroyItemCount(TrialTokenEntry, 1, true, false);
-            player->SetDisableXpGain(false, true);
-
-            if (!permanentlyFailedPlayerGuids.count(player->GetGUID()))
+            if (member->GetSession() && isParticipant(member))
             {
-                 ChatHandler(player->GetSession()).SendSysMessage("The Trial of Finality has concluded. You are being teleported out.");
-                 if (ExitOverrideHearthstone)
-                     player->TeleportTo(ExitMapID, ExitTeleportX, ExitTeleportY, ExitTeleportZ, ExitTeleportO);
-                 else
-                     player->TeleportTo(player->GetBindPoint());
+                member->TeleportTo(ArenaMapID, ArenaTeleportX, ArenaTeleportY, ArenaTeleportZ, ArenaTeleportO, 0, instanceMap->GetInstanceId());
             }
-        });
+        }
+    }
+}
 
-        // Give rewards on success
-        if (success)
-        {
-            instance->DoForAllPlayers([this](Player* player)
-            {
-                if (permanentlyFailedPlayerGuids.count(player->GetGUID())) return;
+// --- Trial Confirmation ---
+void TrialManager::ProposeTrial(Player* leader, Creature* trialNpc, const std::vector<ObjectGuid>& roster)
+{
+    uint32 groupId = leader->GetGroup()->GetId();
+    PendingTrialInfo info;
+    info.LeaderGuid = leader->GetGUID();
+    info.NpcGuid = trialNpc->GetGUID();
+    info.GroupId = groupId;
+    for (ObjectGuid const& guid : roster)
+        if (guid != leader->GetGUID())
+            info.MemberGuidsToConfirm.push_back(guid);
 
-                if (GoldReward > 0)
-                {
-                    player->ModifyMoney(GoldReward);
-                    ChatHandler(player->GetSession()).PSendSysMessage("You have been awarded %u gold for your victory!", GoldReward / 10000);
-                }
-                if (TitleRewardID > 0)
-                {
-                    if (CharTitlesEntry const* titleEntry = sCharTitlesStore.LookupEntry(TitleRewardID))
-                    {
-                        player->SetTitle(titleEntry);
-                        ChatHandler(player->GetSession()).SendSysMessage("You have been granted a new title!");
-                    }
-                }
-            });
+    {
+        std::lock_guard<std::mutex> lock(m_pendingLock);
+        if (m_pendingTrials.count(groupId))
+        {
+            TrialTextCache::instance()->SendSysMessage(leader, TRIAL_STRING_CONFIRM_ALREADY_PENDING);
+            return;
         }
+        info.Generation = ++m_nextGeneration;
+        m_pendingTrials[groupId] = info;
+        m_confirmationWheel.Schedule(ConfirmationTimeoutSeconds * IN_MILLISECONDS, { groupId, info.Generation });
+    }
 
-        // If it was a test trial with a temporary group, disband it
-        if (isTestTrial)
+    sLog->outDetail("[TrialOfFinality] Group %u proposed the trial; waiting for %u members (mode %s).", groupId, uint32(info.MemberGuidsToConfirm.size()), ConfirmationRequiredMode.c_str());
+    TrialTextCache::instance()->PSendSysMessage(leader, TRIAL_STRING_CONFIRM_PROPOSED, uint32(info.MemberGuidsToConfirm.size()), ConfirmationTimeoutSeconds);
+    std::string leaderName = leader->GetName();
+    for (ObjectGuid const& guid : info.MemberGuidsToConfirm)
+    {
+        if (Player* member = ObjectAccessor::FindPlayer(guid))
         {
-            if (!instance->GetPlayers().isEmpty())
-                if (Player* p = instance->GetPlayers().begin()->GetSource())
-                    if (Group* group = p->GetGroup())
-                    {
-                        sLog->outDetail("[TrialOfFinality] Disbanding temporary test trial group %u for instance %u.", group->GetId(), instance->GetInstanceId());
-                        group->Disband();
-                    }
+            TrialTextCache::instance()->PSendSysMessage(member, TRIAL_STRING_CONFIRM_PROPOSAL_RECEIVED, leaderName.c_str(), ConfirmationTimeoutSeconds);
+            SendConfirmationPrompt(member, trialNpc);
         }
-
-        // The instance will be destroyed automatically when the last player leaves.
-        // No need to manually manage trial info maps anymore.
-        sLog->outInfo("sys", "[TrialOfFinality] Cleaned up trial for instance %u.", instance->GetInstanceId());
     }
+}
 
-    void CheckPlayerLocationsAndEnforceBoundaries()
-    {
-        Position centerPos(ArenaTeleportX, ArenaTeleportY, ArenaTeleportZ, 0.0f);
-        uint32 groupId = 0;
-        if (!instance->GetPlayers().isEmpty())
-            if (Player* p = instance->GetPlayers().begin()->GetSource())
-                if (p->GetGroup())
-                    groupId = p->GetGroup()->GetId();
+void TrialManager::SendConfirmationPrompt(Player* member, Creature* trialNpc)
+{
+    ClearGossipMenuFor(member);
+    AddGossipItemFor(member, GOSSIP_ICON_BATTLE, "I accept the Trial of Finality.", GOSSIP_SENDER_MAIN, GOSSIP_ACTION_CONFIRM_ACCEPT,
+        "If you fall and are not resurrected before the wave ends, your character's journey ends permanently. Accept?", 0, false);
+    AddGossipItemFor(member, GOSSIP_ICON_CHAT, "I decline.", GOSSIP_SENDER_MAIN, GOSSIP_ACTION_CONFIRM_DECLINE);
+    SendGossipMenuFor(member, trialNpc->GetGossipMenuId(), trialNpc->GetGUID());
+}
 
-        instance->DoForAllPlayers([this, &centerPos, groupId](Player* player)
-        {
-            if (player->IsAlive() && !(GMDebugEnable && player->GetSession()->GetSecurity() >= SEC_GAMEMASTER))
-            {
-                bool isOutside = player->GetDistance(centerPos) > ArenaRadius;
-                if (isOutside)
-                {
-                    if (playersWarnedForLeavingArena.count(player->GetGUID()))
-                    {
-                        sLog->outWarn("sys", "[TrialOfFinality] Player %s (Instance %u) left the arena after being warned. Failing the trial.", player->GetName().c_str(), instance->GetInstanceId());
-                        std::string reason = player->GetName() + " has fled the Trial of Finality, forfeiting the challenge for the group.";
-                        LogTrialDbEvent(TRIAL_EVENT_PLAYER_FORFEIT_ARENA, groupId, player, currentWave, highestLevelAtStart, reason);
-                        FinalizeTrialOutcome(false, reason);
-                    }
-                    else
-                    {
-                        playersWarnedForLeavingArena.insert(player->GetGUID());
-                        ChatHandler(player->GetSession()).SendSysMessage("WARNING: You have left the trial arena! Return immediately or you will forfeit the trial for your entire group!");
-                        LogTrialDbEvent(TRIAL_EVENT_PLAYER_WARNED_ARENA_LEAVE, groupId, player, currentWave, highestLevelAtStart, "Player left arena boundary and was warned.");
-                    }
-                }
-            }
-        });
+bool TrialManager::IsAwaitingConfirmation(Player* player)
+{
+    Group* group = player->GetGroup();
+    if (!group)
+        return false;
+    std::lock_guard<std::mutex> lock(m_pendingLock);
+    auto it = m_pendingTrials.find(group->GetId());
+    if (it == m_pendingTrials.end())
+        return false;
+    const PendingTrialInfo& info = it->second;
+    return std::find(info.MemberGuidsToConfirm.begin(), info.MemberGuidsToConfirm.end(), player->GetGUID()) != info.MemberGuidsToConfirm.end()
+        && !info.MemberGuidsAccepted.count(player->GetGUID()) && !info.MemberGuidsDeclined.count(player->GetGUID());
+}
+
+void TrialManager::HandleTrialConfirmation(Player* player, bool accepted)
+{
+    Group* group = player->GetGroup();
+    if (!group)
+    {
+        TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_NOT_IN_GROUP);
+        return;
     }
 
-    void HandleTrialForfeit(Player* player)
+    PendingTrialInfo info;
+    ConfirmationOutcome outcome;
     {
-        if (playersWhoVotedForfeit.count(player->GetGUID()))
+        std::lock_guard<std::mutex> lock(m_pendingLock);
+        auto it = m_pendingTrials.find(group->GetId());
+        if (it == m_pendingTrials.end() ||
+            std::find(it->second.MemberGuidsToConfirm.begin(), it->second.MemberGuidsToConfirm.end(), player->GetGUID()) == it->second.MemberGuidsToConfirm.end())
         {
-            ChatHandler(player->GetSession()).SendSysMessage("You have already voted to forfeit.");
+            TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_CONFIRM_NONE_PENDING);
             return;
         }
-
-        uint32 activePlayers = 0;
-        instance->DoForAllPlayers([&](Player* p) {
-            if (p->IsAlive() && !permanentlyFailedPlayerGuids.count(p->GetGUID()))
-                activePlayers++;
-        });
-
-        if (activePlayers == 0)
+        if (it->second.MemberGuidsAccepted.count(player->GetGUID()) || it->second.MemberGuidsDeclined.count(player->GetGUID()))
         {
-            ChatHandler(player->GetSession()).SendSysMessage("There are no active players to vote.");
+            TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_CONFIRM_ALREADY_ANSWERED);
             return;
         }
 
-        uint32 groupId = player->GetGroup() ? player->GetGroup()->GetId() : 0;
-
-        if (!forfeitVoteInProgress)
-        {
-            forfeitVoteInProgress = true;
-            forfeitVoteStartTime = time(nullptr);
-            playersWhoVotedForfeit.insert(player->GetGUID());
-            std::string msg = player->GetName() + " has initiated a vote to forfeit! Type `/trialforfeit` to agree. (1/" + std::to_string(activePlayers) + " votes)";
-            LogTrialDbEvent(TRIAL_EVENT_FORFEIT_VOTE_START, groupId, player, currentWave, highestLevelAtStart, "Forfeit vote started.");
-            DoSendNotifyToInstance(msg.c_str());
-        }
+        if (accepted)
+            it->second.MemberGuidsAccepted.insert(player->GetGUID());
         else
-        {
-            playersWhoVotedForfeit.insert(player->GetGUID());
-            std::string msg = player->GetName() + " has also voted to forfeit. (" + std::to_string(playersWhoVotedForfeit.size()) + "/" + std::to_string(activePlayers) + " votes)";
-            DoSendNotifyToInstance(msg.c_str());
-        }
+            it->second.MemberGuidsDeclined.insert(player->GetGUID());
 
-        if (playersWhoVotedForfeit.size() >= activePlayers)
-        {
-            std::string reason = "The group has unanimously voted to forfeit the trial.";
-            LogTrialDbEvent(TRIAL_EVENT_FORFEIT_VOTE_SUCCESS, groupId, player, currentWave, highestLevelAtStart, reason);
-            CleanupTrial(false);
-        }
+        info = it->second;
+        outcome = EvaluateConfirmation(info);
+        if (outcome != CONFIRMATION_PENDING)
+            m_pendingTrials.erase(it); // The wheel entry expires later as a no-op
     }
-};
 
-// --- Instance Script Loader ---
-// Registers our custom instance script with the server.
-class instance_trial_of_finality_loader : public InstanceScriptLoader
-{
-    public:
-        instance_trial_of_finality_loader() : InstanceScriptLoader("instance_trial_of_finality") { }
+    uint32 total = info.MemberGuidsToConfirm.size();
+    uint32 answered = info.MemberGuidsAccepted.size() + info.MemberGuidsDeclined.size();
+    auto notify = [&info](auto&& send) {
+        if (Player* leader = ObjectAccessor::FindPlayer(info.LeaderGuid))
+            send(leader);
+        for (ObjectGuid const& guid : info.MemberGuidsToConfirm)
+            if (Player* member = ObjectAccessor::FindPlayer(guid))
+                send(member);
+    };
+    std::string name = player->GetName();
+    notify([&](Player* target) {
+        TrialTextCache::instance()->PSendSysMessage(target, accepted ? TRIAL_STRING_CONFIRM_MEMBER_ACCEPTED : TRIAL_STRING_CONFIRM_MEMBER_DECLINED,
+            name.c_str(), answered, total);
+    });
+
+    if (outcome == CONFIRMATION_START)
+        StartConfirmedTrial(info);
+    else if (outcome == CONFIRMATION_ABORT)
+        AbortPendingTrial(info, TRIAL_STRING_CONFIRM_ABORTED);
+}
 
-        InstanceScript* GetInstanceScript(InstanceMap* map) const override
-        {
-            return new instance_trial_of_finality(map);
-        }
-};
+TrialManager::ConfirmationOutcome TrialManager::EvaluateConfirmation(const PendingTrialInfo& info)
+{
+    // The leader proposed the trial and counts as an accepted member.
+    uint32 total = info.MemberGuidsToConfirm.size() + 1;
+    uint32 yes = info.MemberGuidsAccepted.size() + 1;
+    uint32 no = info.MemberGuidsDeclined.size();
 
-// --- Logging Enum and Function ---
-enum TrialEventType {
-    TRIAL_EVENT_START,
-    TRIAL_EVENT_WAVE_START,
-    TRIAL_EVENT_PLAYER_DEATH_TOKEN,
-    TRIAL_EVENT_TRIAL_SUCCESS,
-    TRIAL_EVENT_TRIAL_FAILURE,
-    TRIAL_EVENT_GM_COMMAND_RESET,
-    TRIAL_EVENT_GM_COMMAND_TEST_START,
-    TRIAL_EVENT_PLAYER_RESURRECTED,
-    TRIAL_EVENT_PERMADEATH_APPLIED,
-    TRIAL_EVENT_PLAYER_DISCONNECT,
-    TRIAL_EVENT_PLAYER_RECONNECT,
-    TRIAL_EVENT_STRAY_TOKEN_REMOVED,
-    TRIAL_EVENT_PLAYER_WARNED_ARENA_LEAVE,
-    TRIAL_EVENT_PLAYER_FORFEIT_ARENA,
-    TRIAL_EVENT_WORLD_ANNOUNCEMENT_SUCCESS,
-    TRIAL_EVENT_NPC_CHEER_TRIGGERED,
-    TRIAL_EVENT_FORFEIT_VOTE_START,
-    TRIAL_EVENT_FORFEIT_VOTE_CANCEL,
-    TRIAL_EVENT_FORFEIT_VOTE_SUCCESS
-};
+    // However many accept, the trial still needs MinGroupSize participants.
+    if (total - no < MinGroupSize)
+        return CONFIRMATION_ABORT;
 
-void LogTrialDbEvent(TrialEventType eventType, uint32 groupId = 0, Player* player = nullptr,
-                     int waveNumber = 0, uint8 highestLevel = 0, const std::string& details = "") {
-    std::string eventTypeStr = "UNKNOWN";
-    switch (eventType) {
-        case TRIAL_EVENT_START: eventTypeStr = "TRIAL_START"; break;
-        case TRIAL_EVENT_WAVE_START: eventTypeStr = "WAVE_START"; break;
-        case TRIAL_EVENT_PLAYER_DEATH_TOKEN: eventTypeStr = "PLAYER_DEATH_TOKEN"; break;
-        case TRIAL_EVENT_TRIAL_SUCCESS: eventTypeStr = "TRIAL_SUCCESS"; break;
-        case TRIAL_EVENT_TRIAL_FAILURE: eventTypeStr = "TRIAL_FAILURE"; break;
-        case TRIAL_EVENT_GM_COMMAND_RESET: eventTypeStr = "GM_COMMAND_RESET"; break;
-        case TRIAL_EVENT_GM_COMMAND_TEST_START: eventTypeStr = "GM_COMMAND_TEST_START"; break;
-        case TRIAL_EVENT_PLAYER_RESURRECTED: eventTypeStr = "PLAYER_RESURRECTED"; break;
-        case TRIAL_EVENT_PERMADEATH_APPLIED: eventTypeStr = "PERMADEATH_APPLIED"; break;
-        case TRIAL_EVENT_PLAYER_DISCONNECT: eventTypeStr = "PLAYER_DISCONNECT"; break;
-        case TRIAL_EVENT_PLAYER_RECONNECT: eventTypeStr = "PLAYER_RECONNECT"; break;
-        case TRIAL_EVENT_STRAY_TOKEN_REMOVED: eventTypeStr = "STRAY_TOKEN_REMOVED"; break;
-        case TRIAL_EVENT_PLAYER_WARNED_ARENA_LEAVE: eventTypeStr = "PLAYER_WARNED_ARENA_LEAVE"; break;
-        case TRIAL_EVENT_PLAYER_FORFEIT_ARENA: eventTypeStr = "PLAYER_FORFEIT_ARENA"; break;
-        case TRIAL_EVENT_WORLD_ANNOUNCEMENT_SUCCESS: eventTypeStr = "WORLD_ANNOUNCEMENT_SUCCESS"; break;
-        case TRIAL_EVENT_NPC_CHEER_TRIGGERED: eventTypeStr = "NPC_CHEER_TRIGGERED"; break;
-        case TRIAL_EVENT_FORFEIT_VOTE_START: eventTypeStr = "FORFEIT_VOTE_START"; break;
-        case TRIAL_EVENT_FORFEIT_VOTE_CANCEL: eventTypeStr = "FORFEIT_VOTE_CANCEL"; break;
-        case TRIAL_EVENT_FORFEIT_VOTE_SUCCESS: eventTypeStr = "FORFEIT_VOTE_SUCCESS"; break;
-    }
-
-    ObjectGuid playerGuid = player ? player->GetGUID() : ObjectGuid::Empty;
-    std::string playerName_s = player ? player->GetName() : "";
-    uint32 accountId = player && player->GetSession() ? player->GetSession()->GetAccountId() : 0;
-
-    std::ostringstream slog_message;
-    slog_message << "[TrialEventSLOG] Type: " << eventTypeStr
-            << ", GroupID: " << groupId
-            << ", PlayerGUID: " << playerGuid.GetCounter()
-            << ", PlayerName: " << (playerName_s.empty() ? "N/A" : playerName_s)
-            << ", AccountID: " << accountId
-            << ", HighestLvl: " << (unsigned int)highestLevel
-            << ", Wave: " << waveNumber
-            << ", Details: '" << details << "'";
-    sLog->outMessage("sys", LOG_LEVEL_INFO, "%s", slog_message.str().c_str());
+    switch (ConfirmationMode)
+    {
+        case CONFIRMATION_MODE_MAJORITY:
+            if (yes * 2 > total && yes >= MinGroupSize) return CONFIRMATION_START;
+            if ((total - no) * 2 <= total) return CONFIRMATION_ABORT;
+            break;
+        case CONFIRMATION_MODE_LEADER_PLUS_ONE:
+            if (yes >= 2 && yes >= MinGroupSize) return CONFIRMATION_START;
+            if (no == info.MemberGuidsToConfirm.size()) return CONFIRMATION_ABORT;
+            break;
+        case CONFIRMATION_MODE_ALL:
+        default:
+            if (no) return CONFIRMATION_ABORT;
+            if (yes == total) return CONFIRMATION_START;
+            break;
+    }
+    return CONFIRMATION_PENDING;
+}
 
-    std::string escaped_details = details;
-    if (!details.empty()) { CharacterDatabase.EscapeString(escaped_details); }
-    std::string escaped_player_name = playerName_s;
-    if (!playerName_s.empty()) { CharacterDatabase.EscapeString(escaped_player_name); }
+void TrialManager::StartConfirmedTrial(const PendingTrialInfo& info)
+{
+    // The wait can last ConfirmationTimeoutSeconds: the leader may have changed groups, and members may
+    // have left, moved away, entered combat, picked up a token or changed level. Check everything again
+    // for the members who accepted, against the group that was proposed.
+    Player* leader = ObjectAccessor::FindPlayer(info.LeaderGuid);
+    Creature* trialNpc = leader && leader->GetSession() ? ObjectAccessor::GetCreature(*leader, info.NpcGuid) : nullptr;
+    std::vector<ObjectGuid> roster;
+    if (!trialNpc || !leader->GetGroup() || leader->GetGroup()->GetId() != info.GroupId ||
+        !ValidateGroupForTrial(leader, trialNpc, roster, &info.MemberGuidsAccepted))
+    {
+        AbortPendingTrial(info, TRIAL_STRING_CONFIRM_ABORTED);
+        return;
+    }
 
-    CharacterDatabase.ExecuteFmt(
-        "INSERT INTO trial_of_finality_log (event_type, group_id, player_guid, player_name, player_account_id, highest_level_in_group, wave_number, details) "
-        "VALUES ('%s', %s, %s, %s, %s, %s, %s, %s)",
-        eventTypeStr.c_str(),
-        (groupId == 0 ? "NULL" : std::to_string(groupId).c_str()),
-        (playerGuid.IsEmpty() ? "NULL" : std::to_string(playerGuid.GetCounter()).c_str()),
-        (playerName_s.empty() ? "NULL" : ("'" + escaped_player_name + "'").c_str()),
-        (accountId == 0 ? "NULL" : std::to_string(accountId).c_str()),
-        (highestLevel == 0 ? "NULL" : std::to_string(highestLevel).c_str()),
-        std::to_string(waveNumber).c_str(),
-        (details.empty() ? "NULL" : ("'" + escaped_details + "'").c_str())
-    );
+    std::vector<ObjectGuid> participants;
+    for (ObjectGuid const& guid : roster)
+        if (guid != info.LeaderGuid)
+            participants.push_back(guid);
+    for (ObjectGuid const& guid : info.MemberGuidsToConfirm)
+        if (!info.MemberGuidsAccepted.count(guid))
+            if (Player* member = ObjectAccessor::FindPlayer(guid))
+                TrialTextCache::instance()->SendSysMessage(member, TRIAL_STRING_CONFIRM_LEFT_BEHIND);
+
+    sLog->outInfo("sys", "[TrialOfFinality] Group %u confirmed the trial with %u of %u members.", leader->GetGroup()->GetId(), uint32(participants.size() + 1), uint32(info.MemberGuidsToConfirm.size() + 1));
+    StartTrialForGroup(leader, &participants);
 }
 
-// --- Creature ID Pools for Waves (Now loaded from config) ---
-// Each inner vector represents a "spawn choice", which can be a single creature or a pre-defined group.
-std::vector<std::vector<uint32>> NpcPoolEasy;
-std::vector<std::vector<uint32>> NpcPoolMedium;
-std::vector<std::vector<uint32>> NpcPoolHard;
+void TrialManager::AbortPendingTrial(const PendingTrialInfo& info, TrialStrings reason)
+{
+    if (Player* leader = ObjectAccessor::FindPlayer(info.LeaderGuid))
+        TrialTextCache::instance()->SendSysMessage(leader, reason);
+    for (ObjectGuid const& guid : info.MemberGuidsToConfirm)
+        if (Player* member = ObjectAccessor::FindPlayer(guid))
+            TrialTextCache::instance()->SendSysMessage(member, reason);
+}
 
-// --- Wave Spawn Positions (Now loaded from config) ---
-std::vector<Position> WAVE_SPAWN_POSITIONS;
+uint32 TrialManager::GetQueueLength()
+{
+    uint32 length = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_validationLock);
+        uint32 now = getMSTime();
+        for (auto const& pair : m_validations)
+            if (pair.second.IsInFlight(now))
+                ++length;
+    }
+    std::lock_guard<std::mutex> lock(m_pendingLock);
+    return length + uint32(m_pendingTrials.size());
+}
 
-// --- Configuration Variables ---
-const uint32 AURA_ID_TRIAL_PERMADEATH = 40000;
-bool ModuleEnabled = false;
-uint32 FateweaverArithosEntry = 0;
-uint32 FateweaverArithosDisplayID = 0;
-uint32 AnnouncerEntry = 0;
-uint32 TrialTokenEntry = 0;
-uint32 TitleRewardID = 0;
-uint32 GoldReward = 200000000;
-uint8 MinGroupSize = 1;
-uint8 MaxGroupSize = 5;
-uint8 MaxLevelDifference = 10;
-uint16 ArenaMapID = 0;
-float ArenaTeleportX = 0.0f;
-float ArenaTeleportY = 0.0f;
-float ArenaTeleportZ = 0.0f;
-float ArenaTeleportO = 0.0f;
-float ArenaRadius = 100.0f;
-bool ExitOverrideHearthstone = false;
-uint16 ExitMapID = 0;
-float ExitTeleportX = 0.0f;
-float ExitTeleportY = 0.0f;
-float ExitTeleportZ = 0.0f;
-float ExitTeleportO = 0.0f;
-std::string NpcScalingMode = "match_highest_level";
-std::string DisableCharacterMethod = "custom_flag";
-bool GMDebugEnable = false;
-bool GMDebugAllowPlayerbots = false;
-bool WorldAnnounceEnable = true;
-std::string WorldAnnounceFormat = "Hark, heroes! The group led by {group_leader}, with valiant trialists {player_list}, has vanquished all foes and emerged victorious from the Trial of Finality! All hail the Conquerors!";
-bool CheeringNpcsEnable = true;
-std::set<uint32> CheeringNpcCityZoneIDs;
-float CheeringNpcsRadiusAroundPlayer = 40.0f;
-int CheeringNpcsMaxPerPlayerCluster = 5;
-int CheeringNpcsMaxTotalWorld = 50;
-uint32 CheeringNpcsTargetNpcFlags = UNIT_NPC_FLAG_NONE;
-uint32 CheeringNpcsExcludeNpcFlags = UNIT_NPC_FLAG_VENDOR | UNIT_NPC_FLAG_TRAINER | UNIT_NPC_FLAG_FLIGHTMASTER | UNIT_NPC_FLAG_REPAIRER | UNIT_NPC_FLAG_AUCTIONEER | UNIT_NPC_FLAG_BANKER | UNIT_NPC_FLAG_TABARDDESIGNER | UNIT_NPC_FLAG_STABLEMASTER | UNIT_NPC_FLAG_GUILDMASTER | UNIT_NPC_FLAG_BATTLEMASTER | UNIT_NPC_FLAG_INNKEEPER | UNIT_NPC_FLAG_SPIRITHEALER | UNIT_NPC_FLAG_SPIRITGUIDE | UNIT_NPC_FLAG_PETITIONER;
-uint32 CheeringNpcsCheerIntervalMs = 2000; // Interval for the second cheer
-bool PermaDeathExemptGMs = true; // Exempt GMs from perma-death
-uint32 ConfirmationTimeoutSeconds = 60; // Seconds for players to confirm trial participation
-bool ConfirmationEnable = true; // Enable/disable the confirmation system
-std::string ConfirmationRequiredMode = "all"; // "all", (future: "majority", "leader_plus_one")
-bool ForfeitEnable = true; // Enable/disable the forfeit feature
+void TrialManager::OnUpdate(uint32 diff)
+{
+    {
+        std::vector<QueryCallback> incoming;
+        {
+            std::lock_guard<std::mutex> lock(m_queryLock);
+            incoming.swap(m_incomingQueries);
+        }
+        for (QueryCallback& callback : incoming)
+            m_queryProcessor.AddCallback(std::move(callback));
+    }
+    m_queryProcessor.ProcessReadyCallbacks();
 
-// --- Custom NPC Scaling Settings ---
-struct CustomNpcScalingTier {
-    float HealthMultiplier = 1.0f;
-    std::vector<uint32> AurasToAdd;
-};
-CustomNpcScalingTier CustomScalingEasy;
-CustomNpcScalingTier CustomScalingMedium;
-CustomNpcScalingTier CustomScalingHard;
+    if (m_validationSweepTimer > diff)
+        m_validationSweepTimer -= diff;
+    else
+    {
+        m_validationSweepTimer = VALIDATION_SWEEP_INTERVAL_MS;
+        uint32 now = getMSTime();
+        std::lock_guard<std::mutex> lock(m_validationLock);
+        for (auto it = m_validations.begin(); it != m_validations.end();)
+        {
+            const GroupValidationEntry& entry = it->second;
+            if (entry.IsInFlight(now) || (entry.HasResult && getMSTimeDiff(entry.CheckedAtMs, now) < ValidationCooldownMs))
+                ++it;
+            else
+                it = m_validations.erase(it);
+        }
+    }
 
+    std::vector<PendingTrialInfo> expired;
+    {
+        std::lock_guard<std::mutex> lock(m_pendingLock);
+        if (!m_confirmationWheel.Size())
+            return;
+        m_confirmationWheel.Update(diff, [this, &expired](PendingTrialTimeout& timeout)
+        {
+            auto it = m_pendingTrials.find(timeout.GroupId);
+            if (it == m_pendingTrials.end() || it->second.Generation != timeout.Generation)
+                return;
+            expired.push_back(std::move(it->second));
+            m_pendingTrials.erase(it);
+        });
+    }
 
-// --- Main Trial Logic ---
+    for (const PendingTrialInfo& info : expired)
+    {
+        sLog->outDetail("[TrialOfFinality] A trial proposal timed out with %u of %u members accepted.", uint32(info.MemberGuidsAccepted.size()), uint32(info.MemberGuidsToConfirm.size()));
+        AbortPendingTrial(info, TRIAL_STRING_CONFIRM_TIMED_OUT);
+    }
+}
 
-struct PendingSecondCheer {
-    ObjectGuid npcGuid;
-    time_t cheerTime;
+// --- Cheering NPCs ---
+// Spawn positions of eligible city NPCs, bucketed into a uniform grid per zone. The cell size equals the
+// search radius, so a radius query only has to look at the 3x3 cells around the player.
+struct CheeringNpcSpawn
+{
+    ObjectGuid::LowType SpawnId;
+    uint32 MapId;
+    float X;
+    float Y;
 };
 
-// --- Pre-Trial Data Structures and Manager ---
-// This manager is now a simple data-passing utility to transfer information
-// from the outer world script (NPC interaction) into the newly created instance.
-struct PreTrialData
+class CheeringZoneGrid
 {
-    uint8 highestLevel;
-    bool isTestTrial = false;
+public:
+    void Add(const CheeringNpcSpawn& spawn) { _spawns.push_back(spawn); }
+    size_t Size() const { return _spawns.size(); }
+    const CheeringNpcSpawn& Get(uint32 index) const { return _spawns[index]; }
+
+    void Build(float cellSize)
+    {
+        _cellSize = std::max(cellSize, 1.0f);
+        _cells.clear();
+        for (uint32 i = 0; i < _spawns.size(); ++i)
+            _cells[CellKey(CellCoord(_spawns[i].X), CellCoord(_spawns[i].Y))].push_back(i);
+    }
+
+    // Appends to out the indices of the maxResults spawns nearest to (x, y) within radius on mapId, nearest first.
+    void FindNearest(uint32 mapId, float x, float y, float radius, uint32 maxResults, std::vector<std::pair<float, uint32>>& scratch, std::vector<uint32>& out) const
+    {
+        scratch.clear();
+        float radiusSq = radius * radius;
+        int32 cx = CellCoord(x);
+        int32 cy = CellCoord(y);
+        for (int32 dx = -1; dx <= 1; ++dx)
+        {
+            for (int32 dy = -1; dy <= 1; ++dy)
+            {
+                auto itr = _cells.find(CellKey(cx + dx, cy + dy));
+                if (itr == _cells.end())
+                    continue;
+                for (uint32 index : itr->second)
+                {
+                    const CheeringNpcSpawn& spawn = _spawns[index];
+                    if (spawn.MapId != mapId)
+                        continue;
+                    float distSq = (spawn.X - x) * (spawn.X - x) + (spawn.Y - y) * (spawn.Y - y);
+                    if (distSq <= radiusSq)
+                        scratch.emplace_back(distSq, index);
+                }
+            }
+        }
+
+        size_t count = std::min<size_t>(maxResults, scratch.size());
+        std::partial_sort(scratch.begin(), scratch.begin() + count, scratch.end());
+        for (size_t i = 0; i < count; ++i)
+            out.push_back(scratch[i].second);
+    }
+
+private:
+    int32 CellCoord(float v) const { return int32(std::floor(v / _cellSize)); }
+    static uint64 CellKey(int32 cx, int32 cy) { return (uint64(uint32(cx)) << 32) | uint32(cy); }
+
+    float _cellSize = 40.0f;
+    std::vector<CheeringNpcSpawn> _spawns;
+    std::unordered_map<uint64, std::vector<uint32>> _cells;
 };
 
-class TrialManager
+// Makes city NPCs near the winners cheer after a victory. Victories are queued from map threads and
+// processed on the world thread, where all emotes and second cheers run through one timer wheel.
+class TrialCheerManager
 {
 public:
-    static TrialManager* instance() { static TrialManager instance; return &instance; }
+    static TrialCheerManager* instance() { static TrialCheerManager instance; return &instance; }
 
-    // Caches the necessary pre-trial data for a group.
-    void PrepareForInstance(Group* group, uint8 highestLevel, bool isTest = false)
+    // Delay between a victory and looking up the winners, so their teleport out of the arena has landed.
+    static constexpr uint32 CHEER_RESOLVE_DELAY_MS = 10000;
+    // Delay between consecutive NPCs starting to cheer, so a crowd ripples instead of cheering in one frame.
+    static constexpr uint32 CHEER_STAGGER_MS = 150;
+
+    typedef std::unordered_map<uint32, CheeringZoneGrid> ZoneIndex;
+
+    // Config load fills and builds a ZoneIndex of its own, then installs it here with the other settings.
+    static void BuildIndex(ZoneIndex& zones, float cellSize)
     {
-        if (!group) return;
-        m_preTrialData[group->GetId()] = { highestLevel, isTest };
-        sLog->outDetail("[TrialOfFinality] Preparing group %u for instance, highest level: %u, isTest: %d", group->GetId(), highestLevel, isTest);
+        for (auto& pair : zones)
+            pair.second.Build(cellSize);
     }
 
-    // Retrieves the cached data; intended to be called from the InstanceScript.
-    PreTrialData* GetPreTrialData(uint32 groupId)
+    void SetIndex(ZoneIndex zones) { _zones = std::move(zones); }
+    const ZoneIndex& GetZones() const { return _zones; }
+
+    // Thread-safe; called from the instance's map thread when a trial is won.
+    void QueueVictory(uint32 groupId, std::vector<ObjectGuid> winners)
     {
-        auto it = m_preTrialData.find(groupId);
-        if (it != m_preTrialData.end())
-            return &it->second;
-        return nullptr;
+        if (!CheeringNpcsEnable || winners.empty())
+            return;
+        std::lock_guard<std::mutex> lock(_incomingLock);
+        _incoming.push_back({ CHEER_TASK_RESOLVE_VICTORY, groupId, 0, 0, std::move(winners) });
     }
 
-    // Cleans up the cached data once it has been consumed by the InstanceScript.
-    void CleanupPreTrialData(uint32 groupId)
+    // Called from the world thread.
+    void Update(uint32 diff)
     {
-        m_preTrialData.erase(groupId);
-    }
+        {
+            std::lock_guard<std::mutex> lock(_incomingLock);
+            for (CheerTask& task : _incoming)
+                _wheel.Schedule(CHEER_RESOLVE_DELAY_MS, std::move(task));
+            _incoming.clear();
+        }
+
+        if (_wheel.Size() == 0)
+            return;
 
-    static bool ValidateGroupForTrial(Player* leader, Creature* trialNpc);
+        _wheel.Update(diff, [this](CheerTask& task)
+        {
+            if (task.Type == CHEER_TASK_RESOLVE_VICTORY)
+                ResolveVictory(task);
+            else
+                PerformCheer(task);
+        });
+    }
 
 private:
-    TrialManager() {}
-    ~TrialManager() {}
-    TrialManager(const TrialManager&) = delete;
-    TrialManager& operator=(const TrialManager&) = delete;
-    std::map<uint32, PreTrialData> m_preTrialData;
-};
+    enum CheerTaskType : uint8
+    {
+        CHEER_TASK_RESOLVE_VICTORY,
+        CHEER_TASK_FIRST_CHEER,
+        CHEER_TASK_SECOND_CHEER
+    };
 
-// --- TrialManager Method Implementations ---
-bool TrialManager::ValidateGroupForTrial(Player* leader, Creature* trialNpc) {
-    ChatHandler handler(leader->GetSession());
-    Group* group = leader->GetGroup();
+    struct CheerTask
+    {
+        CheerTaskType Type;
+        uint32 GroupId;
+        uint32 MapId;
+        ObjectGuid::LowType SpawnId;
+        std::vector<ObjectGuid> Winners;
+    };
+
+    void ResolveVictory(CheerTask& task)
+    {
+        // CheeringNpcsMaxTotalWorld bounds the NPCs a single victory can move and the cheers pending at any time.
+        uint32 budget = CheeringNpcsMaxTotalWorld > int(_pendingCheers) ? uint32(CheeringNpcsMaxTotalWorld) - _pendingCheers : 0;
+        std::unordered_set<ObjectGuid::LowType> chosen;
+        uint32 scheduled = 0;
 
-    if (!group) {
-        handler.SendSysMessage("You must be in a group to start the trial.");
-        return false;
-    }
-    if (group->GetLeaderGUID() != leader->GetGUID()) {
-        handler.SendSysMessage("Only the group leader can initiate the trial.");
-        return false;
+        for (ObjectGuid const& winnerGuid : task.Winners)
+        {
+            if (scheduled >= budget)
+                break;
+
+            Player* winner = ObjectAccessor::FindPlayer(winnerGuid);
+            if (!winner || !winner->IsInWorld() || !CheeringNpcCityZoneIDs.count(winner->GetZoneId()))
+                continue;
+
+            auto zoneItr = _zones.find(winner->GetZoneId());
+            if (zoneItr == _zones.end())
+                continue;
+
+            _nearest.clear();
+            zoneItr->second.FindNearest(winner->GetMapId(), winner->GetPositionX(), winner->GetPositionY(), CheeringNpcsRadiusAroundPlayer,
+                uint32(std::max(CheeringNpcsMaxPerPlayerCluster, 0)), _scratch, _nearest);
+
+            for (uint32 index : _nearest)
+            {
+                if (scheduled >= budget)
+                    break;
+                const CheeringNpcSpawn& spawn = zoneItr->second.Get(index);
+                if (!chosen.insert(spawn.SpawnId).second)
+                    continue; // Already cheering for a nearby winner of the same group
+
+                uint32 stagger = scheduled * CHEER_STAGGER_MS;
+                _wheel.Schedule(stagger, { CHEER_TASK_FIRST_CHEER, task.GroupId, spawn.MapId, spawn.SpawnId, {} });
+                ++_pendingCheers;
+                if (CheeringNpcsCheerIntervalMs > 0)
+                {
+                    _wheel.Schedule(stagger + CheeringNpcsCheerIntervalMs, { CHEER_TASK_SECOND_CHEER, task.GroupId, spawn.MapId, spawn.SpawnId, {} });
+                    ++_pendingCheers;
+                }
+                ++scheduled;
+            }
+        }
+
+        if (scheduled > 0)
+        {
+            sLog->outDetail("[TrialOfFinality] Scheduled %u cheering NPCs for the victory of group %u.", scheduled, task.GroupId);
+            LogTrialDbEvent(TRIAL_EVENT_NPC_CHEER_TRIGGERED, task.GroupId, nullptr, 0, 0, std::to_string(scheduled) + " city NPCs cheered for the winners.");
+        }
     }
 
-    uint8 memberCount = 0;
-    uint8 minLevel = 255, maxLevel = 0;
-    std::vector<ObjectGuid> memberGuids;
+    void PerformCheer(const CheerTask& task)
+    {
+        if (_pendingCheers > 0)
+            --_pendingCheers;
 
-    for (GroupReference* itr = group->GetFirstMember(); itr != nullptr; itr = itr->next()) {
-        Player* member = itr->GetSource();
-        if (!member || !member->GetSession()) {
-            continue; // Skip offline members
+        Map* map = sMapMgr->FindBaseNonInstanceMap(task.MapId);
+        if (!map)
+            return;
+
+        // Only creatures in loaded grids are in the spawn id store; unloaded ones simply do not cheer.
+        auto bounds = map->GetCreatureBySpawnIdStore().equal_range(task.SpawnId);
+        for (auto itr = bounds.first; itr != bounds.second; ++itr)
+        {
+            Creature* creature = itr->second;
+            if (creature->IsAlive() && !creature->IsInCombat())
+            {
+                creature->HandleEmoteCommand(EMOTE_ONESHOT_CHEER);
+                break;
+            }
         }
-        memberCount++;
-        memberGuids.push_back(member->GetGUID());
+    }
 
-        if (member->getLevel() > maxLevel) maxLevel = member->getLevel();
-        if (member->getLevel() < minLevel) minLevel = member->getLevel();
+    TrialCheerManager() : _wheel(50) { }
+    ~TrialCheerManager() { }
+    TrialCheerManager(const TrialCheerManager&) = delete;
+    TrialCheerManager& operator=(const TrialCheerManager&) = delete;
 
-        if (!trialNpc->IsWithinDistInMap(member, 50.0f)) {
-            handler.PSendSysMessage("Your group member %s is too far away from Fateweaver Arithos.", member->GetName().c_str());
-            return false;
+    ZoneIndex _zones;
+    TrialTimerWheel<CheerTask> _wheel;
+    uint32 _pendingCheers = 0;
+    std::vector<std::pair<float, uint32>> _scratch;
+    std::vector<uint32> _nearest;
+
+    std::mutex _incomingLock;
+    std::vector<CheerTask> _incoming;
+};
+
+// --- World Announcements ---
+// The announcement template is parsed once at config load into literal and placeholder segments.
+// Victories are queued from map threads; the world thread renders each one into a reused buffer,
+// builds a single chat packet and broadcasts that same packet to every session, at most once per
+// AnnounceWinners.World.MinIntervalSeconds.
+class TrialWorldAnnouncer
+{
+public:
+    static TrialWorldAnnouncer* instance() { static TrialWorldAnnouncer instance; return &instance; }
+
+    enum SegmentType : uint8
+    {
+        SEGMENT_LITERAL,
+        SEGMENT_GROUP_LEADER,
+        SEGMENT_PLAYER_LIST
+    };
+
+    struct Segment
+    {
+        SegmentType Type;
+        std::string Text;
+    };
+
+    // A compiled AnnounceWinners.World.MessageFormat. Built off to the side during config load and
+    // installed with SetTemplate together with the other reloaded settings.
+    struct Template
+    {
+        std::vector<Segment> Segments;
+        size_t LiteralLength = 0;
+
+        void AddLiteral(std::string text)
+        {
+            if (text.empty())
+                return;
+            LiteralLength += text.size();
+            Segments.push_back({ SEGMENT_LITERAL, std::move(text) });
         }
+    };
 
-        if (member->GetSession()->IsPlayerBot()) {
-            // Playerbots are allowed if the leader is a GM and the debug setting is enabled
-            if (leader->GetSession()->GetSecurity() >= SEC_GAMEMASTER && GMDebugAllowPlayerbots) {
-                handler.PSendSysMessage("Playerbot %s is permitted in the trial due to GM debug settings.", member->GetName().c_str());
-            } else {
-                handler.PSendSysMessage("Playerbots like %s are not permitted in the Trial of Finality.", member->GetName().c_str());
-                return false;
+    static Template Compile(const std::string& format)
+    {
+        Template compiled;
+        size_t pos = 0;
+        while (pos < format.size())
+        {
+            size_t open = format.find('{', pos);
+            size_t close = open == std::string::npos ? std::string::npos : format.find('}', open);
+            if (close == std::string::npos)
+            {
+                compiled.AddLiteral(format.substr(pos));
+                break;
             }
-        }
 
-        if (member->HasItemCount(TrialTokenEntry, 1, true)) {
-            handler.PSendSysMessage("Your group member %s already possesses a Trial Token and cannot start a new trial.", member->GetName().c_str());
-            return false;
+            compiled.AddLiteral(format.substr(pos, open - pos));
+            std::string placeholder = format.substr(open + 1, close - open - 1);
+            if (placeholder == "group_leader")
+                compiled.Segments.push_back({ SEGMENT_GROUP_LEADER, "" });
+            else if (placeholder == "player_list")
+                compiled.Segments.push_back({ SEGMENT_PLAYER_LIST, "" });
+            else
+            {
+                sLog->outWarn("sys", "[TrialOfFinality] Unknown placeholder '{%s}' in AnnounceWinners.World.MessageFormat. It will be printed as-is.", placeholder.c_str());
+                compiled.AddLiteral(format.substr(open, close - open + 1));
+            }
+            pos = close + 1;
         }
+        sLog->outDetail("[TrialOfFinality] Compiled world announcement template into %lu segments.", compiled.Segments.size());
+        return compiled;
     }
 
-    if (memberCount < MinGroupSize) {
-        handler.PSendSysMessage("Your group is too small. You need at least %u members to attempt the trial.", MinGroupSize);
-        return false;
-    }
-    if (memberCount > MaxGroupSize) {
-        handler.PSendSysMessage("Your group is too large. You can have at most %u members to attempt the trial.", MaxGroupSize);
-        return false;
-    }
-    if ((maxLevel - minLevel) > MaxLevelDifference) {
-        handler.PSendSysMessage("The level difference in your group is too high. The maximum allowed difference is %u levels.", MaxLevelDifference);
-        return false;
+    void SetTemplate(Template compiled) { _template = std::move(compiled); }
+
+    // Thread-safe; called from the instance's map thread when a trial is won.
+    void QueueVictory(uint32 groupId, std::string leaderName, std::vector<std::string> playerNames)
+    {
+        if (!WorldAnnounceEnable || _template.Segments.empty())
+            return;
+
+        std::lock_guard<std::mutex> lock(_pendingLock);
+        if (_pending.size() >= WorldAnnounceMaxQueued)
+        {
+            sLog->outDetail("[TrialOfFinality] World announcement for group %u dropped; %lu announcements are already waiting.", groupId, _pending.size());
+            return;
+        }
+        _pending.push_back({ groupId, std::move(leaderName), std::move(playerNames) });
     }
 
-    // Check perma-death status for all members in one query
-    if (!memberGuids.empty()) {
-        std::string guidString;
-        for(size_t i = 0; i < memberGuids.size(); ++i) {
-            guidString += std::to_string(memberGuids[i].GetCounter());
-            if (i < memberGuids.size() - 1) guidString += ",";
+    // Called from the world thread.
+    void Update(uint32 diff)
+    {
+        if (_cooldownMs > diff)
+        {
+            _cooldownMs -= diff;
+            return;
         }
+        _cooldownMs = 0;
 
-        if (!guidString.empty()) {
-            QueryResult result = CharacterDatabase.QueryFmt("SELECT guid FROM character_trial_finality_status WHERE guid IN (%s) AND is_perma_failed = 1", guidString.c_str());
-            if (result) {
-                Field* fields = result->Fetch();
-                uint32 failedGuid = fields[0].Get<uint32>();
-                Player* failedPlayer = ObjectAccessor::FindPlayer(ObjectGuid(HighGuid::Player, failedGuid));
-                std::string failedPlayerName = "Unknown";
-                if(failedPlayer)
-                {
-                    failedPlayerName = failedPlayer->GetName();
-                }
-                else
-                {
-                    // If player is not online, we have to do another query to get the name.
-                    // This is for a better error message.
-                    QueryResult charResult = CharacterDatabase.QueryFmt("SELECT name FROM characters WHERE guid = %u", failedGuid);
-                    if(charResult)
-                    {
-                        failedPlayerName = (*charResult)[0].Get<std::string>();
-                    }
-                    else
+        PendingAnnouncement announcement;
+        {
+            std::lock_guard<std::mutex> lock(_pendingLock);
+            if (_pending.empty())
+                return;
+            announcement = std::move(_pending.front());
+            _pending.pop_front();
+        }
+
+        Render(announcement);
+
+        WorldPacket data;
+        ChatHandler::BuildChatPacket(data, CHAT_MSG_SYSTEM, LANG_UNIVERSAL, nullptr, nullptr, _buffer);
+        sWorld->SendGlobalMessage(&data);
+
+        _cooldownMs = WorldAnnounceMinIntervalSeconds * IN_MILLISECONDS;
+        LogTrialDbEvent(TRIAL_EVENT_WORLD_ANNOUNCEMENT_SUCCESS, announcement.GroupId, nullptr, 0, 0, _buffer);
+    }
+
+private:
+    struct PendingAnnouncement
+    {
+        uint32 GroupId = 0;
+        std::string LeaderName;
+        std::vector<std::string> PlayerNames;
+    };
+
+    void Render(const PendingAnnouncement& announcement)
+    {
+        size_t listLength = 0;
+        for (const std::string& name : announcement.PlayerNames)
+            listLength += name.size() + 2;
+
+        _buffer.clear();
+        _buffer.reserve(_template.LiteralLength + announcement.LeaderName.size() + listLength);
+        for (const Segment& segment : _template.Segments)
+        {
+            switch (segment.Type)
+            {
+                case SEGMENT_LITERAL:
+                    _buffer += segment.Text;
+                    break;
+                case SEGMENT_GROUP_LEADER:
+                    _buffer += announcement.LeaderName;
+                    break;
+                case SEGMENT_PLAYER_LIST:
+                    for (size_t i = 0; i < announcement.PlayerNames.size(); ++i)
                     {
-                        failedPlayerName = "GUID " + std::to_string(failedGuid);
+                        if (i > 0)
+                            _buffer += ", ";
+                        _buffer += announcement.PlayerNames[i];
                     }
-                }
-
-                handler.PSendSysMessage("A member of your group, %s, has already had their fate sealed and cannot enter the trial again.", failedPlayerName.c_str());
-                return false;
+                    break;
             }
         }
     }
 
-    return true;
-}
+    TrialWorldAnnouncer() { }
+    ~TrialWorldAnnouncer() { }
+    TrialWorldAnnouncer(const TrialWorldAnnouncer&) = delete;
+    TrialWorldAnnouncer& operator=(const TrialWorldAnnouncer&) = delete;
+
+    Template _template;
+    std::string _buffer;
+    uint32 _cooldownMs = 0;
 
+    std::mutex _pendingLock;
+    std::deque<PendingAnnouncement> _pending;
+};
 
 // --- Announcer AI and Script ---
 struct npc_trial_announcer_ai : public ScriptedAI
 {
     npc_trial_announcer_ai(Creature* creature) : ScriptedAI(creature) {}
 
-    void AnnounceWave(int waveNumber)
+    // The announcer lives for the whole instance, so its yell packets are serialized once per line and
+    // locale and then reused for every player and every repeat of that line.
+    void AnnounceWave(const TrialWaveDescriptor& wave, uint32 waveNumber)
     {
-        std::vector<std::string> announcements;
-        switch (waveNumber)
-        {
-            case 1:
-                announcements = {
-                    "Let the trial commence! Your first challenge awaits!",
-                    "The first wave approaches! Show them your might!",
-                    "Prove your worth, contenders! The trial begins!"
-                };
-                break;
-            case 2:
-                announcements = {
-                    "A commendable start! But can you withstand the second wave?",
-                    "Do not falter! The next wave is upon you!",
-                    "Impressive... but the trial has just begun."
-                };
-                break;
-            case 3:
-                announcements = {
-                    "You show promise. Now, face a greater challenge!",
-                    "The third wave will test your resolve!",
-                    "Halfway there... or halfway to your doom?"
-                };
-                break;
-            case 4:
-                announcements = {
-                    "Only the strongest may proceed! The fourth wave descends!",
-                    "Your victory is within reach! Do not let it slip away!",
-                    "Feel the rising intensity? The end is near!"
-                };
-                break;
-            case 5:
-                announcements = {
-                    "The final wave! Your destiny is at hand!",
-                    "This is the ultimate test! Conquer them and achieve glory!",
-                    "Everything you have fought for comes to this! Annihilate them!"
-                };
-                break;
-        }
+        YellWaveLine(me, wave, waveNumber, _yellPackets);
+    }
 
-        if (!announcements.empty()) {
-            uint32 rand_idx = urand(0, announcements.size() - 1);
-            me->Yell(announcements[rand_idx], LANG_UNIVERSAL, nullptr);
-        }
+    // Yells one of the wave's lines to every player on the speaker's map, built once per locale into packets.
+    // Also used for an announcer creature running some other AI, with a packet map of the caller's.
+    static void YellWaveLine(Creature* speaker, const TrialWaveDescriptor& wave, uint32 waveNumber, std::unordered_map<uint32, WorldPacket>& packets)
+    {
+        if (wave.Announcements.empty())
+            return;
+
+        uint32 lineIndex = urand(0, wave.Announcements.size() - 1);
+        const TrialText& line = wave.Announcements[lineIndex];
+        uint32 lineKey = (waveNumber << 8) | lineIndex;
+
+        speaker->GetMap()->DoForAllPlayers([speaker, &line, lineKey, &packets](Player* player)
+        {
+            LocaleConstant locale = player->GetSession()->GetSessionDbLocaleIndex();
+            WorldPacket& packet = packets[(lineKey << 8) | locale];
+            if (packet.empty())
+                ChatHandler::BuildChatPacket(packet, CHAT_MSG_MONSTER_YELL, LANG_UNIVERSAL, speaker, nullptr, line.Resolve(locale));
+            player->SendDirectMessage(&packet);
+        });
     }
+
+private:
+    std::unordered_map<uint32, WorldPacket> _yellPackets;
 };
 
 class npc_trial_announcer : public CreatureScript
@@ -991,12 +4952,6 @@ struct npc_trial_monster_ai : public ScriptedAI
 };
 
 // --- NPC Scripts ---
-enum FateweaverArithosGossipActions
-{
-    GOSSIP_ACTION_INFO = 1,
-    GOSSIP_ACTION_START_TRIAL = 2,
-    GOSSIP_ACTION_RETURN = 3
-};
 
 class npc_fateweaver_arithos : public CreatureScript
 {
@@ -1016,6 +4971,11 @@ public:
             return true;
         }
 
+        if (TrialManager::instance()->IsAwaitingConfirmation(player)) {
+            TrialManager::SendConfirmationPrompt(player, creature);
+            return true;
+        }
+
         ClearGossipMenuFor(player);
         AddGossipItemFor(player, GOSSIP_ICON_CHAT, "Tell me more about the Trial of Finality.", GOSSIP_SENDER_MAIN, GOSSIP_ACTION_INFO);
 
@@ -1024,6 +4984,8 @@ public:
         } else {
              AddGossipItemFor(player, GOSSIP_ICON_CHAT, "(You must be your group's leader to propose the trial)", GOSSIP_SENDER_MAIN, GOSSIP_ACTION_INFO + 100);
         }
+        if (LeaderboardEnable)
+            AddGossipItemFor(player, GOSSIP_ICON_TALK, "Who are the champions of the Trial?", GOSSIP_SENDER_MAIN, GOSSIP_ACTION_LEADERBOARD_FASTEST);
         SendGossipMenuFor(player, creature->GetGossipMenuId(), creature->GetGUID());
         return true;
     }
@@ -1034,66 +4996,40 @@ public:
         switch(action)
         {
             case GOSSIP_ACTION_INFO:
-                AddGossipItemFor(player, GOSSIP_ICON_CHAT, "The trial is a test of mettle for groups of 1 to 5. You will face 5 waves of increasingly difficult foes. Success grants great rewards, but failure while holding a Trial Token means your character's journey ends, permanently. Only a teammate's resurrection during a wave can save you from this fate.", GOSSIP_SENDER_MAIN, GOSSIP_ACTION_INFO + 100);
+                AddGossipItemFor(player, GOSSIP_ICON_CHAT, "The trial is a test of mettle for groups of 1 to 5. You will face " + std::to_string(WaveProgram.size()) + " waves of increasingly difficult foes. Success grants great rewards, but failure while holding a Trial Token means your character's journey ends, permanently. Only a teammate's resurrection during a wave can save you from this fate.", GOSSIP_SENDER_MAIN, GOSSIP_ACTION_INFO + 100);
                 AddGossipItemFor(player, GOSSIP_ICON_CHAT, "Return", GOSSIP_SENDER_MAIN, GOSSIP_ACTION_RETURN);
                 SendGossipMenuFor(player, creature->GetGossipMenuId(), creature->GetGUID());
                 break;
             case GOSSIP_ACTION_START_TRIAL:
                 CloseGossipMenuFor(player);
-                if (TrialManager::ValidateGroupForTrial(player, creature))
-                {
-                    // Calculate highest level before creating the instance
-                    uint8 highestLevel = 0;
-                    if (Group* group = player->GetGroup())
-                    {
-                        for (GroupReference* itr = group->GetFirstMember(); itr != nullptr; itr = itr->next())
-                        {
-                            if (Player* member = itr->GetSource())
-                            {
-                                if (member->GetSession() && member->getLevel() > highestLevel)
-                                {
-                                    highestLevel = member->getLevel();
-                                }
-                            }
-                        }
-                    }
-
-                    if (highestLevel == 0)
-                    {
-                        sLog->outError("sys", "[TrialOfFinality] Could not start trial for group %u, unable to determine highest level.", player->GetGroup()->GetId());
-                        ChatHandler(player->GetSession()).SendSysMessage("Could not start the trial. Unable to determine the group's highest level.");
-                        return true;
-                    }
-
-                    // Cache the data for the instance script to pick up
-                    TrialManager::instance()->PrepareForInstance(player->GetGroup(), highestLevel);
-
-                    // Create a new private instance for the group
-                    InstanceMap* instanceMap = sMapMgr->CreateNewInstance(ArenaMapID, player, INSTANCE_DIFFICULTY_NORMAL);
-                    if (!instanceMap)
-                    {
-                        sLog->outError("sys", "[TrialOfFinality] Could not create instance map %u for group %u.", ArenaMapID, player->GetGroup()->GetId());
-                        ChatHandler(player->GetSession()).SendSysMessage("An error occurred while preparing the trial arena. Please try again later.");
-                        return true;
-                    }
-
-                    // Teleport all group members to the new instance
-                    for (GroupReference* itr = player->GetGroup()->GetFirstMember(); itr != nullptr; itr = itr->next())
-                    {
-                        if (Player* member = itr->GetSource())
-                        {
-                            if (member->GetSession())
-                            {
-                                member->TeleportTo(ArenaMapID, ArenaTeleportX, ArenaTeleportY, ArenaTeleportZ, ArenaTeleportO, 0, instanceMap->GetInstanceId());
-                            }
-                        }
-                    }
-                }
-                // ValidateGroupForTrial sends its own messages on failure
+                // Validation messages (and the start itself) are sent from the async validation callback
+                TrialManager::instance()->RequestTrialStart(player, creature);
                 break;
             case GOSSIP_ACTION_RETURN:
                 OnGossipHello(player, creature);
                 break;
+            case GOSSIP_ACTION_CONFIRM_ACCEPT:
+            case GOSSIP_ACTION_CONFIRM_DECLINE:
+                CloseGossipMenuFor(player);
+                TrialManager::instance()->HandleTrialConfirmation(player, action == GOSSIP_ACTION_CONFIRM_ACCEPT);
+                break;
+            case GOSSIP_ACTION_LEADERBOARD_FASTEST:
+            case GOSSIP_ACTION_LEADERBOARD_WAVES:
+            {
+                TrialLeaderboardMetric metric = action == GOSSIP_ACTION_LEADERBOARD_FASTEST ? LEADERBOARD_FASTEST_CLEAR : LEADERBOARD_MOST_WAVES;
+                std::vector<TrialLeaderboardEntry> board = TrialLeaderboards::instance()->GetBoard(metric, LEADERBOARD_SCOPE_OVERALL, 0);
+                if (board.empty())
+                    AddGossipItemFor(player, GOSSIP_ICON_CHAT, "No one has earned a place among the champions yet.", GOSSIP_SENDER_MAIN, GOSSIP_ACTION_INFO + 100);
+                for (uint32 i = 0; i < board.size(); ++i)
+                    AddGossipItemFor(player, GOSSIP_ICON_CHAT, FormatLeaderboardLine(metric, i + 1, board[i]), GOSSIP_SENDER_MAIN, GOSSIP_ACTION_INFO + 100);
+                if (metric == LEADERBOARD_FASTEST_CLEAR)
+                    AddGossipItemFor(player, GOSSIP_ICON_TALK, "Who has survived the most waves?", GOSSIP_SENDER_MAIN, GOSSIP_ACTION_LEADERBOARD_WAVES);
+                else
+                    AddGossipItemFor(player, GOSSIP_ICON_TALK, "Who has cleared the Trial the fastest?", GOSSIP_SENDER_MAIN, GOSSIP_ACTION_LEADERBOARD_FASTEST);
+                AddGossipItemFor(player, GOSSIP_ICON_CHAT, "Return", GOSSIP_SENDER_MAIN, GOSSIP_ACTION_RETURN);
+                SendGossipMenuFor(player, creature->GetGossipMenuId(), creature->GetGUID());
+                break;
+            }
             default:
                 CloseGossipMenuFor(player);
                 break;
@@ -1126,9 +5062,52 @@ public:
         }
     }
 
+    void OnLogout(Player* player) override
+    {
+        if (!ModuleEnabled || player->GetMapId() != ArenaMapID || !player->GetMap()->IsDungeon()) return;
+        WorldLocation spectatorReturn;
+        if (TrialSpectatorRegistry::instance()->Remove(player->GetSession(), spectatorReturn))
+        {
+            // The character is saved inside the arena; the next login sends them back out.
+            TrialSpectatorRegistry::instance()->StorePendingReturn(player->GetGUID(), spectatorReturn);
+            return;
+        }
+        if (auto* instance = (instance_trial_of_finality*)player->GetInstanceScript())
+            instance->HandlePlayerDisconnect(player);
+    }
+
     void OnLogin(Player* player) override {
         if (!ModuleEnabled) return;
 
+        WorldLocation spectatorReturn;
+        if (TrialSpectatorRegistry::instance()->TakePendingReturn(player->GetGUID(), spectatorReturn))
+        {
+            if (player->GetMapId() == ArenaMapID)
+                player->TeleportTo(spectatorReturn);
+            return;
+        }
+
+        // A participant reconnecting within the grace period goes straight back to their trial. The
+        // token scan and perma-death query are skipped: both were settled when the trial started, and a
+        // trial that ended while they were away clears the record, sending them down the normal path.
+        TrialResumeRecord resume;
+        if (TrialResumeRegistry::instance()->Find(player->GetGUID(), resume))
+        {
+            if (player->GetMapId() != ArenaMapID || player->GetInstanceId() != resume.InstanceId)
+            {
+                if (sMapMgr->FindMap(ArenaMapID, resume.InstanceId))
+                {
+                    player->TeleportTo(ArenaMapID, ArenaTeleportX, ArenaTeleportY, ArenaTeleportZ, ArenaTeleportO, 0, resume.InstanceId);
+                    return;
+                }
+                TrialResumeRegistry::instance()->Remove(player->GetGUID());
+            }
+            else
+            {
+                return;
+            }
+        }
+
         // Remove stray trial tokens if player logs in and is not in an active trial context
         if (player->HasItemCount(TrialTokenEntry, 1, true)) {
             // This check is now more robust. We check if the player is in ANY instance map.
@@ -1141,32 +5120,56 @@ public:
             }
         }
 
-        // Check for perma-death flag on login using the database
+        // Check for perma-death flag on login: from the shared status cache, or the database without it
         if (player && player->GetSession()) {
-            QueryResult result = CharacterDatabase.QueryFmt("SELECT is_perma_failed FROM character_trial_finality_status WHERE guid = %u", player->GetGUID().GetCounter());
-            if (result)
+            bool sealed = false;
+            if (TrialStatusCache::instance()->IsReady())
+                sealed = TrialStatusCache::instance()->IsSealed(player->GetGUID().GetCounter());
+            else
             {
-                Field* fields = result->Fetch();
-                if (fields[0].Get<bool>()) // is_perma_failed is true
-                {
-                    player->GetSession()->KickPlayer("Your fate was sealed in the Trial of Finality.");
-                    sLog->outWarn("sys", "[TrialOfFinality] Player %s (GUID %u, Account %u) kicked on login due to perma-death flag in DB.",
-                                 player->GetName().c_str(), player->GetGUID().GetCounter(), player->GetSession()->GetAccountId());
-                    if(player->HasAura(AURA_ID_TRIAL_PERMADEATH)) player->RemoveAura(AURA_ID_TRIAL_PERMADEATH); // Cleanup aura if it exists
-                    return;
-                }
+                uint64 issuedNs = TrialPerfNowNs();
+                QueryResult result = CharacterDatabase.QueryFmt("SELECT is_perma_failed FROM character_trial_finality_status WHERE guid = %u", player->GetGUID().GetCounter());
+                TrialMetrics::RecordDbLatency(issuedNs);
+                sealed = result && result->Fetch()[0].Get<bool>();
+            }
+            if (sealed)
+            {
+                player->GetSession()->KickPlayer("Your fate was sealed in the Trial of Finality.");
+                sLog->outWarn("sys", "[TrialOfFinality] Player %s (GUID %u, Account %u) kicked on login due to perma-death flag in DB.",
+                             player->GetName().c_str(), player->GetGUID().GetCounter(), player->GetSession()->GetAccountId());
+                if(player->HasAura(AURA_ID_TRIAL_PERMADEATH)) player->RemoveAura(AURA_ID_TRIAL_PERMADEATH); // Cleanup aura if it exists
+                return;
             }
         }
         // Old aura-based check is now removed/obsolete.
     }
 };
 
+// Writes the problems found while parsing a config list to the server log.
+static void LogTrialParseReport(const TrialParseReport& report)
+{
+    for (TrialParseMessage const& message : report.Messages)
+    {
+        if (message.Error)
+            sLog->outError("sys", "[TrialOfFinality] %s", message.Text.c_str());
+        else
+            sLog->outWarn("sys", "[TrialOfFinality] %s", message.Text.c_str());
+    }
+}
+
 class ModServerScript : public ServerScript
 {
 public:
     ModServerScript() : ServerScript("ModTrialOfFinalityServerScript") {}
 
-    static std::map<uint32, std::vector<ObjectGuid>> s_cheeringNpcCacheByZone;
+    // Spectators get a reduced stream. With nobody spectating this is a single atomic load per packet.
+    bool CanPacketSend(WorldSession* session, WorldPacket& packet) override
+    {
+        if (!TrialSpectatorRegistry::instance()->HasSpectators())
+            return true;
+        return TrialSpectatorRegistry::instance()->FilterPacket(session, packet);
+    }
+
     void OnConfigLoad(bool reload) override
     {
         sLog->outInfo("sys", "Loading Trial of Finality module configuration...");
@@ -1181,6 +5184,13 @@ public:
         MinGroupSize = sConfigMgr->GetOption<uint8>("TrialOfFinality.MinGroupSize", 1);
         MaxGroupSize = sConfigMgr->GetOption<uint8>("TrialOfFinality.MaxGroupSize", 5);
         MaxLevelDifference = sConfigMgr->GetOption<uint8>("TrialOfFinality.MaxLevelDifference", 10);
+        ValidationCooldownMs = sConfigMgr->GetOption<uint32>("TrialOfFinality.Validation.CooldownSeconds", 5) * IN_MILLISECONDS;
+        ArrivalTimeoutMs = sConfigMgr->GetOption<uint32>("TrialOfFinality.Arrival.TimeoutSeconds", 30) * IN_MILLISECONDS;
+        ResumeGraceMs = sConfigMgr->GetOption<uint32>("TrialOfFinality.Resume.GraceSeconds", 120) * IN_MILLISECONDS;
+        SpectatorsEnable = sConfigMgr->GetOption<bool>("TrialOfFinality.Spectators.Enable", false);
+        SpectatorsMaxPerInstance = sConfigMgr->GetOption<uint32>("TrialOfFinality.Spectators.MaxPerInstance", 5);
+        SpectatorsMovementIntervalMs = sConfigMgr->GetOption<uint32>("TrialOfFinality.Spectators.MovementUpdateIntervalMs", 500);
+        SpectatorsDropCombatLog = sConfigMgr->GetOption<bool>("TrialOfFinality.Spectators.DropCombatLog", true);
         ArenaMapID = sConfigMgr->GetOption<uint16>("TrialOfFinality.Arena.MapID", 0);
         ArenaTeleportX = sConfigMgr->GetOption<float>("TrialOfFinality.Arena.TeleportX", 0.0f);
         ArenaTeleportY = sConfigMgr->GetOption<float>("TrialOfFinality.Arena.TeleportY", 0.0f);
@@ -1188,34 +5198,152 @@ public:
         ArenaTeleportO = sConfigMgr->GetOption<float>("TrialOfFinality.Arena.TeleportO", 0.0f);
         ArenaRadius = sConfigMgr->GetOption<float>("TrialOfFinality.Arena.Radius", 100.0f);
 
+        // Arena Boundary
+        ArenaBoundaryHysteresis = sConfigMgr->GetOption<float>("TrialOfFinality.Arena.Boundary.Hysteresis", 3.0f);
+        ArenaBoundaryFailDistance = sConfigMgr->GetOption<float>("TrialOfFinality.Arena.Boundary.FailDistance", 30.0f);
+        ArenaBoundaryWarningGraceMs = sConfigMgr->GetOption<uint32>("TrialOfFinality.Arena.Boundary.WarningGraceSeconds", 5) * IN_MILLISECONDS;
+        // List settings are parsed into these locals and only replace the live values once all of them
+        // have been read, so a malformed value never leaves a list half applied.
+        TrialArenaBoundary arenaBoundary;
+        std::vector<Position> spawnPositions;
+        std::vector<uint32> crowdEntries;
+        std::vector<Position> crowdLayout;
+        std::set<uint32> cityZoneIds;
+        std::vector<TrialLevelBand> levelBands;
+        std::array<int8, MAX_TRIAL_LEVEL + 1> levelToBandIndex;
+        std::vector<TrialWaveDescriptor> waveProgram;
+        {
+            TrialParseReport report;
+            std::vector<float> values;
+
+            std::string circlesStr = sConfigMgr->GetOption<std::string>("TrialOfFinality.Arena.Boundary.Circles", "");
+            ParseFloatRecords(circlesStr, 3, "Arena.Boundary.Circles", report, values);
+            for (size_t i = 0; i + 2 < values.size(); i += 3) {
+                if (values[i + 2] > 0.0f)
+                    arenaBoundary.AddCircle(values[i], values[i + 1], values[i + 2]);
+                else
+                    sLog->outError("sys", "[TrialOfFinality] Circle %lu in Arena.Boundary.Circles has a radius of %.1f. Expected X,Y,Radius with a positive radius.", i / 3 + 1, values[i + 2]);
+            }
+
+            // Polygons are separated by '|'; each is a ';' separated list of X,Y points.
+            std::string polygonsStr = sConfigMgr->GetOption<std::string>("TrialOfFinality.Arena.Boundary.Polygons", "");
+            std::string_view polygons(polygonsStr);
+            for (size_t start = 0; start < polygons.size(); ) {
+                size_t end = std::min(polygons.find('|', start), polygons.size());
+                std::string_view polygonStr = polygons.substr(start, end - start);
+                size_t errors = report.Messages.size();
+                values.clear();
+                ParseFloatRecords(polygonStr, 2, "Arena.Boundary.Polygons", report, values, start);
+                std::vector<TrialArenaBoundary::Point> points;
+                for (size_t i = 0; i + 1 < values.size(); i += 2)
+                    points.push_back({ values[i], values[i + 1] });
+                if (polygonStr.find_first_not_of(" \t") != std::string_view::npos && (report.Messages.size() != errors || !arenaBoundary.AddPolygon(points)))
+                    sLog->outError("sys", "[TrialOfFinality] Invalid polygon at column %lu in Arena.Boundary.Polygons. Expected at least three X,Y points.", start + 1);
+                start = end + 1;
+            }
+
+            if (arenaBoundary.IsEmpty())
+                arenaBoundary.AddCircle(ArenaTeleportX, ArenaTeleportY, ArenaRadius);
+
+            std::string zRangeStr = sConfigMgr->GetOption<std::string>("TrialOfFinality.Arena.Boundary.ZRange", "");
+            if (!zRangeStr.empty()) {
+                if (ParseFloatList(zRangeStr, ',', values) && values.size() == 2)
+                    arenaBoundary.SetZRange(values[0], values[1]);
+                else
+                    sLog->outError("sys", "[TrialOfFinality] Invalid Arena.Boundary.ZRange '%s'. Expected MinZ,MaxZ. Height is not checked.", zRangeStr.c_str());
+            }
+            LogTrialParseReport(report);
+
+            arenaBoundary.Compile(ArenaBoundaryHysteresis, ArenaBoundaryFailDistance,
+                sConfigMgr->GetOption<float>("TrialOfFinality.Arena.Boundary.GridCellSize", 8.0f));
+            sLog->outInfo("sys", "[TrialOfFinality] Arena boundary compiled: %u shapes, %u grid cells.",
+                uint32(arenaBoundary.GetShapeCount()), uint32(arenaBoundary.GetCellCount()));
+        }
+
         // Parse Spawn Positions
-        WAVE_SPAWN_POSITIONS.clear();
         std::string spawnPosStr = sConfigMgr->GetOption<std::string>("TrialOfFinality.Arena.SpawnPositions", "");
         if (!spawnPosStr.empty()) {
-            std::stringstream ssPos(spawnPosStr);
-            std::string segment;
-            while(std::getline(ssPos, segment, ';')) {
-                std::stringstream ssCoord(segment);
-                std::string coord;
-                std::vector<float> coords;
-                try {
-                    while(std::getline(ssCoord, coord, ',')) {
-                        coords.push_back(std::stof(coord));
-                    }
-                    if (coords.size() == 4) {
-                        WAVE_SPAWN_POSITIONS.push_back({coords[0], coords[1], coords[2], coords[3]});
-                    } else {
-                        sLog->outError("sys", "[TrialOfFinality] Invalid coordinate segment in Arena.SpawnPositions: '%s'. It must have exactly 4 comma-separated floats (X,Y,Z,O).", segment.c_str());
-                    }
-                } catch (const std::exception& e) {
-                    sLog->outError("sys", "[TrialOfFinality] Failed to parse coordinate segment in Arena.SpawnPositions: '%s'. Error: %s.", segment.c_str(), e.what());
-                }
-            }
+            TrialParseReport report;
+            for (TrialSpawnPoint const& point : ParseSpawnPositions(spawnPosStr, report))
+                spawnPositions.push_back({point.X, point.Y, point.Z, point.O});
+            LogTrialParseReport(report);
         }
-        if (WAVE_SPAWN_POSITIONS.empty()) {
+        if (spawnPositions.empty()) {
              sLog->outError("sys", "[TrialOfFinality] Configuration for Arena.SpawnPositions is empty or invalid. The trial may not function correctly. Please provide at least one valid spawn position.");
         } else {
-             sLog->outDetail("[TrialOfFinality] Loaded %lu spawn positions.", WAVE_SPAWN_POSITIONS.size());
+             sLog->outDetail("[TrialOfFinality] Loaded %lu spawn positions.", spawnPositions.size());
+        }
+
+        // Shared perma-death status
+        StatusSyncEnable = sConfigMgr->GetOption<bool>("TrialOfFinality.StatusSync.Enable", true);
+        StatusSyncPollIntervalMs = std::max<uint32>(sConfigMgr->GetOption<uint32>("TrialOfFinality.StatusSync.PollIntervalMs", 2000), 100);
+        StatusSyncRetentionHours = std::max<uint32>(sConfigMgr->GetOption<uint32>("TrialOfFinality.StatusSync.RetentionHours", 24), 1);
+        // At startup the cache is loaded by OnStartup; on a reload it follows the setting from here.
+        if (reload)
+        {
+            bool wantCache = ModuleEnabled && StatusSyncEnable;
+            if (wantCache && !TrialStatusCache::instance()->IsReady())
+                TrialStatusCache::instance()->LoadFromDB();
+            else if (!wantCache && TrialStatusCache::instance()->IsReady())
+                TrialStatusCache::instance()->Reset();
+        }
+
+        // Combat Black Box
+        BlackBoxEnable = sConfigMgr->GetOption<bool>("TrialOfFinality.BlackBox.Enable", true);
+        BlackBoxSeconds = std::max<uint32>(sConfigMgr->GetOption<uint32>("TrialOfFinality.BlackBox.Seconds", 60), 1);
+        BlackBoxMaxRecords = std::clamp<uint32>(sConfigMgr->GetOption<uint32>("TrialOfFinality.BlackBox.MaxRecords", 4096), 64, 262144);
+        BlackBoxPositionIntervalMs = std::max<uint32>(sConfigMgr->GetOption<uint32>("TrialOfFinality.BlackBox.PositionIntervalMs", 1000), 100);
+        BlackBoxDirectory = sConfigMgr->GetOption<std::string>("TrialOfFinality.BlackBox.Directory", ".");
+
+        // Run Tracer
+        TraceEnable = sConfigMgr->GetOption<bool>("TrialOfFinality.Trace.Enable", false);
+        TraceCapacity = std::clamp<uint32>(sConfigMgr->GetOption<uint32>("TrialOfFinality.Trace.Capacity", 8192), 256, 1000000);
+        TraceDirectory = sConfigMgr->GetOption<std::string>("TrialOfFinality.Trace.Directory", ".");
+
+        // Metrics
+        MetricsEnable = sConfigMgr->GetOption<bool>("TrialOfFinality.Metrics.Enable", false);
+        MetricsFile = sConfigMgr->GetOption<std::string>("TrialOfFinality.Metrics.File", "trial_of_finality.prom");
+        MetricsIntervalSeconds = std::max<uint32>(sConfigMgr->GetOption<uint32>("TrialOfFinality.Metrics.IntervalSeconds", 15), 1);
+
+        // Stress Test
+        StressEnable = sConfigMgr->GetOption<bool>("TrialOfFinality.Stress.Enable", false);
+        StressMaxInstances = std::clamp<uint32>(sConfigMgr->GetOption<uint32>("TrialOfFinality.Stress.MaxInstances", 200), 1, 5000);
+        StressSecondsPerCreature = std::max(sConfigMgr->GetOption<float>("TrialOfFinality.Stress.SecondsPerCreature", 8.0f), 1.0f);
+        StressDownChance = std::clamp(sConfigMgr->GetOption<float>("TrialOfFinality.Stress.DownChance", 0.002f), 0.0f, 1.0f);
+        StressResurrectChance = std::clamp(sConfigMgr->GetOption<float>("TrialOfFinality.Stress.ResurrectChance", 0.05f), 0.0f, 1.0f);
+
+        // Leaderboards
+        LeaderboardEnable = sConfigMgr->GetOption<bool>("TrialOfFinality.Leaderboard.Enable", true);
+        LeaderboardSize = std::clamp<uint32>(sConfigMgr->GetOption<uint32>("TrialOfFinality.Leaderboard.Size", 10), 1, 50);
+        LeaderboardSaveIntervalMs = std::max<uint32>(sConfigMgr->GetOption<uint32>("TrialOfFinality.Leaderboard.SaveIntervalSeconds", 300), 10) * IN_MILLISECONDS;
+
+        // Ambient Crowd
+        CrowdEnable = sConfigMgr->GetOption<bool>("TrialOfFinality.Crowd.Enable", false);
+        CrowdMaxPerInstance = sConfigMgr->GetOption<uint32>("TrialOfFinality.Crowd.MaxPerInstance", 40);
+        CrowdEmoteIntervalMs = std::max<uint32>(sConfigMgr->GetOption<uint32>("TrialOfFinality.Crowd.EmoteIntervalMs", 2000), 250);
+        CrowdEmotesPerTick = sConfigMgr->GetOption<uint32>("TrialOfFinality.Crowd.EmotesPerTick", 3);
+        CrowdDisableAboveDiffMs = sConfigMgr->GetOption<uint32>("TrialOfFinality.Crowd.DisableAboveUpdateMs", 150);
+        if (CrowdEnable) {
+            TrialParseReport report;
+            for (uint32 entry : ParseUIntList(sConfigMgr->GetOption<std::string>("TrialOfFinality.Crowd.EntryIDs", ""), "Crowd.EntryIDs", report)) {
+                if (sObjectMgr->GetCreatureTemplate(entry))
+                    crowdEntries.push_back(entry);
+                else
+                    sLog->outError("sys", "[TrialOfFinality] Crowd creature entry %u in Crowd.EntryIDs does not exist.", entry);
+            }
+
+            for (TrialSpawnPoint const& point : ParseSpawnPositions(sConfigMgr->GetOption<std::string>("TrialOfFinality.Crowd.Positions", ""), report, "Crowd.Positions"))
+                crowdLayout.push_back({point.X, point.Y, point.Z, point.O});
+            LogTrialParseReport(report);
+            if (crowdLayout.size() > CrowdMaxPerInstance) {
+                sLog->outWarn("sys", "[TrialOfFinality] Crowd.Positions lists %lu positions but Crowd.MaxPerInstance is %u. Only the first %u are used.",
+                    crowdLayout.size(), CrowdMaxPerInstance, CrowdMaxPerInstance);
+                crowdLayout.resize(CrowdMaxPerInstance);
+            }
+            if (crowdEntries.empty() || crowdLayout.empty())
+                sLog->outError("sys", "[TrialOfFinality] Crowd is enabled but has no valid entries or positions. No crowd will be placed.");
+            else
+                sLog->outDetail("[TrialOfFinality] Crowd layout: %lu positions, %lu creature entries.", crowdLayout.size(), crowdEntries.size());
         }
 
         ExitOverrideHearthstone = sConfigMgr->GetOption<bool>("TrialOfFinality.Exit.OverrideHearthstone", false);
@@ -1237,285 +5365,749 @@ public:
         sLog->outDetail("[TrialOfFinality] Trial Confirmation Timeout: %u seconds", ConfirmationTimeoutSeconds);
         ConfirmationRequiredMode = sConfigMgr->GetOption<std::string>("TrialOfFinality.Confirmation.RequiredMode", "all");
         std::transform(ConfirmationRequiredMode.begin(), ConfirmationRequiredMode.end(), ConfirmationRequiredMode.begin(), ::tolower); // Normalize to lowercase
-        if (ConfirmationRequiredMode != "all") {
-            sLog->outWarn("sys", "[TrialOfFinality] Confirmation.RequiredMode is set to '%s', but only 'all' is currently supported. Defaulting to 'all'.", ConfirmationRequiredMode.c_str());
+        if (ConfirmationRequiredMode == "majority") {
+            ConfirmationMode = CONFIRMATION_MODE_MAJORITY;
+        } else if (ConfirmationRequiredMode == "leader_plus_one") {
+            ConfirmationMode = CONFIRMATION_MODE_LEADER_PLUS_ONE;
+        } else {
+            if (ConfirmationRequiredMode != "all")
+                sLog->outWarn("sys", "[TrialOfFinality] Confirmation.RequiredMode is set to '%s', which is not one of 'all', 'majority' or 'leader_plus_one'. Defaulting to 'all'.", ConfirmationRequiredMode.c_str());
             ConfirmationRequiredMode = "all";
+            ConfirmationMode = CONFIRMATION_MODE_ALL;
         }
         sLog->outDetail("[TrialOfFinality] Trial Confirmation Required Mode: %s", ConfirmationRequiredMode.c_str());
 
         ForfeitEnable = sConfigMgr->GetOption<bool>("TrialOfFinality.Forfeit.Enable", true);
         sLog->outDetail("[TrialOfFinality] Forfeit System: %s", ForfeitEnable ? "Enabled" : "Disabled");
 
-        WorldAnnounceEnable = sConfigMgr->GetOption<bool>("TrialOfFinality.AnnounceWinners.World.Enable", true);
-        WorldAnnounceFormat = sConfigMgr->GetOption<std::string>("TrialOfFinality.AnnounceWinners.World.MessageFormat",
-            "Hark, heroes! The group led by {group_leader}, with valiant trialists {player_list}, has vanquished all foes and emerged victorious from the Trial of Finality! All hail the Conquerors!");
+        WorldAnnounceEnable = sConfigMgr->GetOption<bool>("TrialOfFinality.AnnounceWinners.World.Enable", true);
+        WorldAnnounceFormat = sConfigMgr->GetOption<std::string>("TrialOfFinality.AnnounceWinners.World.MessageFormat",
+            "Hark, heroes! The group led by {group_leader}, with valiant trialists {player_list}, has vanquished all foes and emerged victorious from the Trial of Finality! All hail the Conquerors!");
+        WorldAnnounceMinIntervalSeconds = sConfigMgr->GetOption<uint32>("TrialOfFinality.AnnounceWinners.World.MinIntervalSeconds", 10);
+        WorldAnnounceMaxQueued = sConfigMgr->GetOption<uint32>("TrialOfFinality.AnnounceWinners.World.MaxQueued", 3);
+        TrialWorldAnnouncer::Template announceTemplate = TrialWorldAnnouncer::Compile(WorldAnnounceFormat);
+
+        CheeringNpcsEnable = sConfigMgr->GetOption<bool>("TrialOfFinality.CheeringNpcs.Enable", true);
+        std::string zoneIDsStr = sConfigMgr->GetOption<std::string>("TrialOfFinality.CheeringNpcs.CityZoneIDs", "1519,1537,1637,1638,1657,3487,4080,4395,3557");
+        CheeringNpcsRadiusAroundPlayer = sConfigMgr->GetOption<float>("TrialOfFinality.CheeringNpcs.RadiusAroundPlayer", 40.0f);
+        CheeringNpcsMaxPerPlayerCluster = sConfigMgr->GetOption<int>("TrialOfFinality.CheeringNpcs.MaxNpcsToCheerPerPlayerCluster", 5);
+        CheeringNpcsMaxTotalWorld = sConfigMgr->GetOption<int>("TrialOfFinality.CheeringNpcs.MaxTotalNpcsToCheerWorld", 50);
+        CheeringNpcsTargetNpcFlags = sConfigMgr->GetOption<uint32>("TrialOfFinality.CheeringNpcs.TargetNpcFlags", UNIT_NPC_FLAG_NONE);
+        CheeringNpcsExcludeNpcFlags = sConfigMgr->GetOption<uint32>("TrialOfFinality.CheeringNpcs.ExcludeNpcFlags", UNIT_NPC_FLAG_VENDOR | UNIT_NPC_FLAG_TRAINER | UNIT_NPC_FLAG_FLIGHTMASTER | UNIT_NPC_FLAG_REPAIRER | UNIT_NPC_FLAG_AUCTIONEER | UNIT_NPC_FLAG_BANKER | UNIT_NPC_FLAG_TABARDDESIGNER | UNIT_NPC_FLAG_STABLEMASTER | UNIT_NPC_FLAG_GUILDMASTER | UNIT_NPC_FLAG_BATTLEMASTER | UNIT_NPC_FLAG_INNKEEPER | UNIT_NPC_FLAG_SPIRITHEALER | UNIT_NPC_FLAG_SPIRITGUIDE | UNIT_NPC_FLAG_PETITIONER);
+        CheeringNpcsCheerIntervalMs = sConfigMgr->GetOption<uint32>("TrialOfFinality.CheeringNpcs.CheerIntervalMs", 2000);
+
+        {
+            TrialParseReport report;
+            std::vector<uint32> zoneIds = ParseUIntList(zoneIDsStr, "CheeringNpcs.CityZoneIDs", report);
+            LogTrialParseReport(report);
+            cityZoneIds.insert(zoneIds.begin(), zoneIds.end());
+        }
+        sLog->outDetail("[TrialOfFinality] Loaded %lu City Zone IDs for NPC cheering.", cityZoneIds.size());
+
+        // NPC Caching Logic
+        TrialCheerManager::ZoneIndex cheerZones;
+        if (CheeringNpcsEnable && !cityZoneIds.empty())
+        {
+            sLog->outInfo("sys", "[TrialOfFinality] Caching cheering NPCs...");
+            std::string zoneIdString;
+            for (uint32 zoneId : cityZoneIds)
+            {
+                if (!zoneIdString.empty())
+                    zoneIdString += ",";
+                zoneIdString += std::to_string(zoneId);
+            }
+
+            // NPC flags live on the template, so the spawn table is joined with creature_template.
+            std::ostringstream query;
+            query << "SELECT c.guid, c.zoneId, c.map, c.position_x, c.position_y FROM creature c "
+                  << "JOIN creature_template ct ON ct.entry = c.id1 WHERE c.zoneId IN (" << zoneIdString << ")";
+
+            if (CheeringNpcsTargetNpcFlags != UNIT_NPC_FLAG_NONE)
+            {
+                query << " AND (ct.npcflag & " << CheeringNpcsTargetNpcFlags << ") != 0";
+            }
+
+            if (CheeringNpcsExcludeNpcFlags != 0)
+            {
+                query << " AND (ct.npcflag & " << CheeringNpcsExcludeNpcFlags << ") = 0";
+            }
+
+            QueryResult result = WorldDatabase.Query(query.str().c_str());
+            if (result)
+            {
+                uint32 count = 0;
+                do
+                {
+                    Field* fields = result->Fetch();
+                    CheeringNpcSpawn spawn;
+                    spawn.SpawnId = fields[0].Get<uint32>();
+                    uint32 zoneId = fields[1].Get<uint32>();
+                    spawn.MapId = fields[2].Get<uint16>();
+                    spawn.X = fields[3].Get<float>();
+                    spawn.Y = fields[4].Get<float>();
+                    cheerZones[zoneId].Add(spawn);
+                    count++;
+                } while (result->NextRow());
+
+                TrialCheerManager::BuildIndex(cheerZones, CheeringNpcsRadiusAroundPlayer);
+                sLog->outInfo("sys", "[TrialOfFinality] Cached %u cheering NPCs in %lu zones.", count, cheerZones.size());
+                for (const auto& pair : cheerZones)
+                {
+                    sLog->outDetail("[TrialOfFinality] Zone %u: Cached %lu NPCs.", pair.first, pair.second.Size());
+                }
+            }
+            else
+            {
+                sLog->outInfo("sys", "[TrialOfFinality] No cheering NPCs found to cache or database error.");
+            }
+        }
+        else if (!CheeringNpcsEnable)
+        {
+            sLog->outInfo("sys", "[TrialOfFinality] Cheering NPCs disabled, cache not populated.");
+        }
+        else if (cityZoneIds.empty())
+        {
+            sLog->outInfo("sys", "[TrialOfFinality] No City Zone IDs configured for cheering NPCs, cache not populated.");
+        }
+
+        // Helper lambda for parsing aura ID strings
+        auto parseAuraIdString = [](const std::string& auraStr, const std::string& tierName) -> std::vector<uint32> {
+            std::vector<uint32> auras;
+            if (auraStr.empty()) {
+                return auras;
+            }
+
+            TrialParseReport report;
+            for (uint32 auraId : ParseUIntList(auraStr, "Custom Scaling AurasToAdd for tier '" + tierName + "'", report)) {
+                if (!sSpellMgr->GetSpellInfo(auraId)) {
+                    sLog->outError("sys", "[TrialOfFinality] Aura ID %u in Custom Scaling for tier '%s' does not exist. Skipping.", auraId, tierName.c_str());
+                    continue;
+                }
+                auras.push_back(auraId);
+            }
+            LogTrialParseReport(report);
+            sLog->outDetail("[TrialOfFinality] Loaded %lu auras for custom scaling tier '%s'.", auras.size(), tierName.c_str());
+            return auras;
+        };
+
+        // Helper lambda for parsing NPC pool strings with encounter groups
+        auto parseNpcPoolString = [](const std::string& poolStr, const std::string& poolName) -> std::vector<std::vector<uint32>> {
+            TrialParseReport report;
+            TrialNpcPool pool = ParseNpcPoolString(poolStr, poolName,
+                [](uint32 entry) { return sObjectMgr->GetCreatureTemplate(entry) != nullptr; }, report);
+            LogTrialParseReport(report);
+            if (!poolStr.empty())
+                sLog->outDetail("[TrialOfFinality] Loaded %lu encounter groups with a total of %d valid NPC entries for pool '%s' (%d invalid entries skipped).", pool.size(), report.EntryCount, poolName.c_str(), report.InvalidCount);
+            return pool;
+        };
+
+        // Load tier-wide NPC Pools and Custom Scaling Rules. These are the defaults for every level band.
+        // Default strings here are fallbacks if .conf key is missing, actual defaults user sees are in .conf file.
+        const char* const defaultPoolStrings[MAX_TRIAL_TIERS] = { "70001,70002,70003,70004,70005", "70011,70012,70013,70014,70015", "70021,70022,70023,70024,70025" };
+        const float defaultHealthMultipliers[MAX_TRIAL_TIERS] = { 1.0f, 1.2f, 1.5f };
+        std::vector<std::vector<uint32>> tierPools[MAX_TRIAL_TIERS];
+        CustomNpcScalingTier tierScaling[MAX_TRIAL_TIERS];
+
+        sLog->outDetail("[TrialOfFinality] Loading NPC Pools and Custom NPC Scaling Rules...");
+        for (uint8 tier = 0; tier < MAX_TRIAL_TIERS; ++tier)
+        {
+            std::string tierName = TrialTierNames[tier];
+            tierPools[tier] = parseNpcPoolString(sConfigMgr->GetOption<std::string>("TrialOfFinality.NpcPools." + tierName, defaultPoolStrings[tier]), tierName);
+            tierScaling[tier].HealthMultiplier = sConfigMgr->GetOption<float>("TrialOfFinality.NpcScaling.Custom." + tierName + ".HealthMultiplier", defaultHealthMultipliers[tier]);
+            tierScaling[tier].AurasToAdd = parseAuraIdString(sConfigMgr->GetOption<std::string>("TrialOfFinality.NpcScaling.Custom." + tierName + ".AurasToAdd", ""), tierName);
+        }
+
+        // Parse Level Bands
+        levelToBandIndex.fill(-1);
+        TrialParseReport bandsReport;
+        std::vector<TrialLevelRange> bandRanges = ParseLevelBands(sConfigMgr->GetOption<std::string>("TrialOfFinality.LevelBands", "1-80"), MAX_TRIAL_LEVEL, bandsReport);
+        LogTrialParseReport(bandsReport);
+        for (TrialLevelRange const& range : bandRanges) {
+            uint32 bandNumber = levelBands.size() + 1; // Band numbers are 1-based positions in the list, used by the BandN keys.
+            TrialLevelBand band;
+            band.MinLevel = range.MinLevel;
+            band.MaxLevel = range.MaxLevel;
+            std::string bandKey = "Band" + std::to_string(bandNumber);
+            for (uint8 tier = 0; tier < MAX_TRIAL_TIERS; ++tier)
+            {
+                std::string tierName = TrialTierNames[tier];
+                std::string bandPoolStr = sConfigMgr->GetOption<std::string>("TrialOfFinality.NpcPools." + tierName + "." + bandKey, "", false);
+                band.Pools[tier] = bandPoolStr.empty() ? tierPools[tier] : parseNpcPoolString(bandPoolStr, tierName + "." + bandKey);
+
+                band.Scaling[tier].HealthMultiplier = sConfigMgr->GetOption<float>("TrialOfFinality.NpcScaling.Custom." + tierName + "." + bandKey + ".HealthMultiplier", tierScaling[tier].HealthMultiplier, false);
+                std::string bandAurasStr = sConfigMgr->GetOption<std::string>("TrialOfFinality.NpcScaling.Custom." + tierName + "." + bandKey + ".AurasToAdd", "", false);
+                band.Scaling[tier].AurasToAdd = bandAurasStr.empty() ? tierScaling[tier].AurasToAdd : parseAuraIdString(bandAurasStr, tierName + "." + bandKey);
+            }
+
+            for (uint32 level = range.MinLevel; level <= range.MaxLevel; ++level)
+                levelToBandIndex[level] = int8(levelBands.size());
+            levelBands.push_back(std::move(band));
+        }
+
+        // Parse the Wave Program
+        auto parseTierName = [](const std::string& name, TrialDifficultyTier fallback, const std::string& key) -> TrialDifficultyTier {
+            if (name.empty())
+                return fallback;
+            for (uint8 tier = 0; tier < MAX_TRIAL_TIERS; ++tier)
+                if (Acore::CaseInsensitiveCompare(name, TrialTierNames[tier]))
+                    return TrialDifficultyTier(tier);
+            sLog->outError("sys", "[TrialOfFinality] Unknown difficulty tier '%s' in %s. Using '%s'.", name.c_str(), key.c_str(), TrialTierNames[fallback]);
+            return fallback;
+        };
+
+        // Defaults reproduce the original five-wave trial.
+        const TrialDifficultyTier defaultWaveTiers[] = { TRIAL_TIER_EASY, TRIAL_TIER_EASY, TRIAL_TIER_MEDIUM, TRIAL_TIER_MEDIUM, TRIAL_TIER_HARD };
+        // Waves 1-5 default to their three localized announcer lines; later waves use the generic line.
+        const uint32 defaultAnnouncedWaves = 5;
+        const uint32 defaultLinesPerWave = 3;
+
+        uint32 waveCount = sConfigMgr->GetOption<uint32>("TrialOfFinality.WaveProgram.WaveCount", 5);
+        if (waveCount == 0 || waveCount > 50) {
+            sLog->outError("sys", "[TrialOfFinality] WaveProgram.WaveCount must be between 1 and 50 (got %u). Using 5.", waveCount);
+            waveCount = 5;
+        }
+        uint32 firstWaveDelayMs = sConfigMgr->GetOption<uint32>("TrialOfFinality.WaveProgram.FirstWaveDelayMs", 5000);
+        uint32 intermissionMs = sConfigMgr->GetOption<uint32>("TrialOfFinality.WaveProgram.IntermissionMs", 8000);
+
+        waveProgram.resize(waveCount);
+        for (uint32 i = 0; i < waveCount; ++i)
+        {
+            TrialWaveDescriptor& wave = waveProgram[i];
+            std::string prefix = "TrialOfFinality.WaveProgram.Wave" + std::to_string(i + 1) + ".";
+            TrialDifficultyTier defaultTier = i < std::size(defaultWaveTiers) ? defaultWaveTiers[i] : TRIAL_TIER_HARD;
+
+            wave.PoolTier = parseTierName(sConfigMgr->GetOption<std::string>(prefix + "Pool", "", false), defaultTier, prefix + "Pool");
+            wave.ScalingTier = parseTierName(sConfigMgr->GetOption<std::string>(prefix + "Tier", "", false), wave.PoolTier, prefix + "Tier");
+            wave.DelayMs = sConfigMgr->GetOption<uint32>(prefix + "IntermissionMs", i == 0 ? firstWaveDelayMs : intermissionMs, false);
+
+            // Spawn layout: 1-based indices into Arena.SpawnPositions. Empty means all positions.
+            std::string layoutStr = sConfigMgr->GetOption<std::string>(prefix + "SpawnLayout", "", false);
+            if (layoutStr.empty()) {
+                wave.SpawnLayout = spawnPositions;
+            } else {
+                TrialParseReport report;
+                for (uint32 index : ParseUIntList(layoutStr, prefix.substr(16) + "SpawnLayout", report)) {
+                    if (index > spawnPositions.size()) {
+                        sLog->outError("sys", "[TrialOfFinality] Spawn position index %u in %sSpawnLayout is out of range (1-%lu). Skipping.", index, prefix.c_str(), spawnPositions.size());
+                        continue;
+                    }
+                    wave.SpawnLayout.push_back(spawnPositions[index - 1]);
+                }
+                LogTrialParseReport(report);
+            }
+            if (wave.SpawnLayout.empty()) {
+                sLog->outError("sys", "[TrialOfFinality] Wave %u has no usable spawn positions. It will not be able to spawn.", i + 1);
+            }
+
+            // Announcer lines, separated by '|'.
+            std::string announceStr = sConfigMgr->GetOption<std::string>(prefix + "Announcements", "", false);
+            if (announceStr.empty()) {
+                if (i < defaultAnnouncedWaves) {
+                    for (uint32 line = 0; line < defaultLinesPerWave; ++line)
+                        wave.Announcements.push_back({ TRIAL_STRING_ANNOUNCE_WAVE_FIRST + i * defaultLinesPerWave + line, "" });
+                } else {
+                    wave.Announcements.push_back({ TRIAL_STRING_ANNOUNCE_GENERIC, "" });
+                }
+            } else {
+                // Configured lines are literal text and are sent unchanged to every locale.
+                for (std::string_view line : SplitListItems(announceStr, '|'))
+                    wave.Announcements.push_back({ 0, std::string(line) });
+            }
+
+            sLog->outDetail("[TrialOfFinality] Wave %u: pool '%s', scaling '%s', delay %u ms, %lu spawn positions, %lu announcer lines.",
+                i + 1, TrialTierNames[wave.PoolTier], TrialTierNames[wave.ScalingTier], wave.DelayMs, wave.SpawnLayout.size(), wave.Announcements.size());
+        }
+
+        // Every list has been read; the new values replace the live ones together.
+        ArenaBoundary = std::move(arenaBoundary);
+        WAVE_SPAWN_POSITIONS = std::move(spawnPositions);
+        CrowdEntries = std::move(crowdEntries);
+        CrowdLayout = std::move(crowdLayout);
+        CheeringNpcCityZoneIDs = std::move(cityZoneIds);
+        LevelBands = std::move(levelBands);
+        LevelToBandIndex = levelToBandIndex;
+        WaveProgram = std::move(waveProgram);
+        TrialWorldAnnouncer::instance()->SetTemplate(std::move(announceTemplate));
+        TrialCheerManager::instance()->SetIndex(std::move(cheerZones));
+
+        // Compile the dense [wave][level] selection table. Pointers refer into LevelBands, which is not modified again until the next load.
+        WaveSelectionTable.assign(WaveProgram.size(), {});
+        for (size_t wave = 0; wave < WaveSelectionTable.size(); ++wave)
+        {
+            uint8 poolTier = WaveProgram[wave].PoolTier;
+            uint8 scalingTier = WaveProgram[wave].ScalingTier;
+            for (uint32 level = 0; level <= MAX_TRIAL_LEVEL; ++level)
+            {
+                int8 bandIndex = LevelToBandIndex[level];
+                if (bandIndex < 0)
+                    continue;
+                WaveSelectionTable[wave][level] = { &LevelBands[bandIndex].Pools[poolTier], &LevelBands[bandIndex].Scaling[scalingTier] };
+            }
+        }
+
+        // Validation: report uncovered level ranges and band/tier combinations with no usable pool.
+        if (LevelBands.empty()) {
+            sLog->outError("sys", "[TrialOfFinality] No valid level bands configured in LevelBands. No wave can be spawned.");
+        }
+        for (uint32 level = 1; level <= MAX_TRIAL_LEVEL; ++level) {
+            if (LevelToBandIndex[level] >= 0) continue;
+            uint32 gapEnd = level;
+            while (gapEnd < MAX_TRIAL_LEVEL && LevelToBandIndex[gapEnd + 1] < 0) ++gapEnd;
+            sLog->outWarn("sys", "[TrialOfFinality] Levels %u-%u are not covered by any level band. Groups whose highest level is in this range cannot start the trial.", level, gapEnd);
+            level = gapEnd;
+        }
+        for (size_t i = 0; i < LevelBands.size(); ++i) {
+            for (uint8 tier = 0; tier < MAX_TRIAL_TIERS; ++tier) {
+                if (LevelBands[i].Pools[tier].empty()) {
+                    sLog->outError("sys", "[TrialOfFinality] Level band %lu (%u-%u) has an empty %s pool. Waves of that tier cannot spawn for these levels.",
+                        i + 1, LevelBands[i].MinLevel, LevelBands[i].MaxLevel, TrialTierNames[tier]);
+                }
+            }
+            sLog->outDetail("[TrialOfFinality] Level band %lu: levels %u-%u.", i + 1, LevelBands[i].MinLevel, LevelBands[i].MaxLevel);
+        }
+
+        if (!FateweaverArithosEntry || !TrialTokenEntry || !AnnouncerEntry || !TitleRewardID) {
+            sLog->outError("sys", "Trial of Finality: Critical EntryID (NPC, Item, Title) not configured. Disabling module functionality.");
+            ModuleEnabled = false; return;
+        }
+        sLog->outInfo("sys", "Trial of Finality: Configuration loaded. Module enabled.");
+        if (reload) {
+            TrialTextCache::instance()->Build();
+            sLog->outInfo("sys", "Trial of Finality: Configuration reloaded. Consider restarting for full effect if scripts were already registered.");
+        }
+    }
+};
+
+class ModWorldScript : public WorldScript
+{
+public:
+    ModWorldScript() : WorldScript("ModTrialOfFinalityWorldScript") {}
+
+    void OnStartup() override
+    {
+        // acore_string is loaded after the module configuration, so the text cache is built here.
+        TrialTextCache::instance()->Build();
+        if (ModuleEnabled && StatusSyncEnable)
+            TrialStatusCache::instance()->LoadFromDB();
+        if (ModuleEnabled && LeaderboardEnable)
+            TrialLeaderboards::instance()->LoadFromDB();
+    }
+
+    void OnShutdown() override
+    {
+        if (ModuleEnabled && LeaderboardEnable)
+            TrialLeaderboards::instance()->SaveToDB();
+    }
+
+    void OnUpdate(uint32 diff) override
+    {
+        if (!ModuleEnabled) return;
+        TrialManager::instance()->OnUpdate(diff);
+        TrialWorldAnnouncer::instance()->Update(diff);
+        TrialCheerManager::instance()->Update(diff);
+        if (LeaderboardEnable)
+            TrialLeaderboards::instance()->Update(diff);
+        if (TrialStatusCache::instance()->IsReady())
+            TrialStatusCache::instance()->Update(diff);
+        if (MetricsEnable)
+            TrialMetricsExporter::instance()->Update(diff);
+        TrialStressRegistry::instance()->Update(diff);
+    }
+};
+
+// Feeds the combat black box. The hooks run for every unit on the realm, so anything that is not a
+// player in a trial map returns after a flag and a map id check.
+class ModUnitScript : public UnitScript
+{
+public:
+    ModUnitScript() : UnitScript("ModTrialOfFinalityUnitScript") { }
+
+    void OnDamage(Unit* attacker, Unit* victim, uint32& damage) override
+    {
+        if (instance_trial_of_finality* instance = GetRecordingInstance(victim))
+            instance->RecordBlackBox(victim, BlackBox::RECORD_DAMAGE_TAKEN, attacker, damage);
+    }
+
+    void OnHeal(Unit* healer, Unit* receiver, uint32& gain) override
+    {
+        if (instance_trial_of_finality* instance = GetRecordingInstance(receiver))
+            instance->RecordBlackBox(receiver, BlackBox::RECORD_HEAL_RECEIVED, healer, gain);
+    }
+
+    void OnAuraApply(Unit* unit, Aura* aura) override
+    {
+        if (instance_trial_of_finality* instance = GetRecordingInstance(unit))
+            instance->RecordBlackBox(unit, BlackBox::RECORD_AURA_APPLIED, aura->GetCaster(), aura->GetId());
+    }
+
+    void OnAuraRemove(Unit* unit, AuraApplication* aurApp, AuraRemoveMode mode) override
+    {
+        if (instance_trial_of_finality* instance = GetRecordingInstance(unit))
+            instance->RecordBlackBox(unit, BlackBox::RECORD_AURA_REMOVED, aurApp->GetBase()->GetCaster(), aurApp->GetBase()->GetId(), uint32(mode));
+    }
+
+private:
+    static instance_trial_of_finality* GetRecordingInstance(Unit* unit)
+    {
+        if (!BlackBoxEnable || !ModuleEnabled || !unit || unit->GetTypeId() != TYPEID_PLAYER || unit->GetMapId() != ArenaMapID)
+            return nullptr;
+        return (instance_trial_of_finality*)unit->GetInstanceScript();
+    }
+};
+
+class ModMovementHandlerScript : public MovementHandlerScript
+{
+public:
+    ModMovementHandlerScript() : MovementHandlerScript("ModTrialOfFinalityMovementHandlerScript") { }
+
+    void OnPlayerMove(Player* player, MovementInfo /*movementInfo*/, uint32 /*opcode*/) override
+    {
+        if (!ModuleEnabled || player->GetMapId() != ArenaMapID || !player->GetMap()->IsDungeon())
+            return;
+        if (auto* instance = (instance_trial_of_finality*)player->GetInstanceScript())
+            instance->MarkPlayerMoved(player);
+    }
+};
+
+// --- GM Command Scripts ---
+class trial_commandscript : public CommandScript
+{
+public:
+    trial_commandscript() : CommandScript("trial_commandscript") { }
+
+    std::vector<ChatCommand> GetCommands() const override
+    {
+        static std::vector<ChatCommand> trialCommandTable = {
+            { "reset",     SEC_GAMEMASTER, true, &ChatCommand_trial_reset,     "" },
+            { "test",      SEC_GAMEMASTER, true, &ChatCommand_trial_test,      "" },
+            { "snapshots", SEC_GAMEMASTER, true, &ChatCommand_trial_snapshots, "" },
+            { "spectators", SEC_GAMEMASTER, true, &ChatCommand_trial_spectators, "" },
+            { "top",       SEC_PLAYER,     true, &ChatCommand_trial_top,       "" },
+            { "statussync", SEC_GAMEMASTER, true, &ChatCommand_trial_statussync, "" },
+            { "perf",      SEC_GAMEMASTER, true, &ChatCommand_trial_perf,      "" },
+            { "trace",     SEC_GAMEMASTER, true, &ChatCommand_trial_trace,     "" },
+            { "stress",    SEC_ADMINISTRATOR, false, &ChatCommand_trial_stress, "" }
+        };
+        // The parent is open to players for `.trial top`; every other subcommand keeps its own GM level.
+        static std::vector<ChatCommand> commandTable = {
+            { "trial", SEC_PLAYER, true, nullptr, "", trialCommandTable }
+        };
+        return commandTable;
+    }
+
+    static bool ChatCommand_trial_snapshots(ChatHandler* handler, const char* /*args*/)
+    {
+        uint64 writes = SnapshotStats.Writes.load();
+        uint64 bytes = SnapshotStats.Bytes.load();
+        uint32 minutes = std::max<uint32>(1, getMSTimeDiff(SnapshotStats.StartedAtMs, getMSTime()) / MINUTE / IN_MILLISECONDS);
+        handler->PSendSysMessage("Trial snapshots: %llu writes (%.1f per minute), %llu bytes total, avg %llu bytes, max %u bytes.",
+            (unsigned long long)writes, double(writes) / minutes, (unsigned long long)bytes, (unsigned long long)(writes ? bytes / writes : 0), SnapshotStats.MaxBytes.load());
+        handler->PSendSysMessage("Recovered after restart: %u, resolved without outcome: %u, unreadable: %u.",
+            SnapshotStats.Recovered.load(), SnapshotStats.Resolved.load(), SnapshotStats.Corrupt.load());
+        return true;
+    }
 
-        CheeringNpcsEnable = sConfigMgr->GetOption<bool>("TrialOfFinality.CheeringNpcs.Enable", true);
-        std::string zoneIDsStr = sConfigMgr->GetOption<std::string>("TrialOfFinality.CheeringNpcs.CityZoneIDs", "1519,1537,1637,1638,1657,3487,4080,4395,3557");
-        CheeringNpcsRadiusAroundPlayer = sConfigMgr->GetOption<float>("TrialOfFinality.CheeringNpcs.RadiusAroundPlayer", 40.0f);
-        CheeringNpcsMaxPerPlayerCluster = sConfigMgr->GetOption<int>("TrialOfFinality.CheeringNpcs.MaxNpcsToCheerPerPlayerCluster", 5);
-        CheeringNpcsMaxTotalWorld = sConfigMgr->GetOption<int>("TrialOfFinality.CheeringNpcs.MaxTotalNpcsToCheerWorld", 50);
-        CheeringNpcsTargetNpcFlags = sConfigMgr->GetOption<uint32>("TrialOfFinality.CheeringNpcs.TargetNpcFlags", UNIT_NPC_FLAG_NONE);
-        CheeringNpcsExcludeNpcFlags = sConfigMgr->GetOption<uint32>("TrialOfFinality.CheeringNpcs.ExcludeNpcFlags", UNIT_NPC_FLAG_VENDOR | UNIT_NPC_FLAG_TRAINER | UNIT_NPC_FLAG_FLIGHTMASTER | UNIT_NPC_FLAG_REPAIRER | UNIT_NPC_FLAG_AUCTIONEER | UNIT_NPC_FLAG_BANKER | UNIT_NPC_FLAG_TABARDDESIGNER | UNIT_NPC_FLAG_STABLEMASTER | UNIT_NPC_FLAG_GUILDMASTER | UNIT_NPC_FLAG_BATTLEMASTER | UNIT_NPC_FLAG_INNKEEPER | UNIT_NPC_FLAG_SPIRITHEALER | UNIT_NPC_FLAG_SPIRITGUIDE | UNIT_NPC_FLAG_PETITIONER);
-        CheeringNpcsCheerIntervalMs = sConfigMgr->GetOption<uint32>("TrialOfFinality.CheeringNpcs.CheerIntervalMs", 2000);
+#if TRIAL_OF_FINALITY_PROFILER
+    static void SendPerfProfile(ChatHandler* handler, TrialPerfProfile& profile)
+    {
+        double elapsedNs = double(std::max<uint64>(1, TrialPerfNowNs() - profile.StartedAtNs.load(std::memory_order_relaxed)));
+        handler->PSendSysMessage("Update used %.3f%% of one map thread over %.0f s.",
+            100.0 * profile.Sections[TRIAL_PERF_UPDATE].Sum() / elapsedNs, elapsedNs / 1e9);
+        for (uint8 i = 0; i < TRIAL_PERF_SECTION_COUNT; ++i)
+        {
+            TrialPerfHistogram const& histogram = profile.Sections[i];
+            if (!histogram.Count())
+                continue;
+            handler->PSendSysMessage("  %-13s calls %llu, p50 %.1f us, p99 %.1f us, max %.1f us",
+                TrialPerfSectionNames[i], (unsigned long long)histogram.Count(),
+                histogram.Percentile(50) / 1000.0, histogram.Percentile(99) / 1000.0, histogram.Max() / 1000.0);
+        }
+    }
+#endif
 
-        CheeringNpcCityZoneIDs.clear();
-        std::stringstream ss(zoneIDsStr);
-        std::string item;
-        while (getline(ss, item, ',')) {
-            if (!item.empty()) {
-                uint32 zoneId = std::stoul(item);
-                if (zoneId > 0) CheeringNpcCityZoneIDs.insert(zoneId);
-            }
+    // .trial perf [instanceId|reset]
+    static bool ChatCommand_trial_perf(ChatHandler* handler, const char* args)
+    {
+#if TRIAL_OF_FINALITY_PROFILER
+        std::string arg = args ? args : "";
+        if (arg == "reset")
+        {
+            TrialProfiler::instance()->ResetAll();
+            handler->SendSysMessage("Trial profiler counters reset.");
+            return true;
         }
-        sLog->outDetail("[TrialOfFinality] Loaded %lu City Zone IDs for NPC cheering.", CheeringNpcCityZoneIDs.size());
 
-        // NPC Caching Logic
-        s_cheeringNpcCacheByZone.clear();
-        if (CheeringNpcsEnable && !CheeringNpcCityZoneIDs.empty())
+        if (!arg.empty())
         {
-            sLog->outInfo("sys", "[TrialOfFinality] Caching cheering NPCs...");
-            std::string zoneIdString;
-            for (uint32 zoneId : CheeringNpcCityZoneIDs)
+            uint32 instanceId = uint32(strtoul(arg.c_str(), nullptr, 10));
+            std::shared_ptr<TrialPerfProfile> profile = TrialProfiler::instance()->Find(instanceId);
+            if (!profile)
             {
-                if (!zoneIdString.empty())
-                    zoneIdString += ",";
-                zoneIdString += std::to_string(zoneId);
+                handler->PSendSysMessage("No Trial of Finality instance with id %u.", instanceId);
+                return true;
             }
+            handler->PSendSysMessage("Trial profile for instance %u:", instanceId);
+            SendPerfProfile(handler, *profile);
+            return true;
+        }
 
-            std::ostringstream query;
-            query << "SELECT guid, zoneId FROM creature WHERE zoneId IN (" << zoneIdString << ") AND playercreateinfo_guid = 0";
+        std::vector<uint32> ids = TrialProfiler::instance()->GetInstanceIds();
+        std::ostringstream list;
+        for (uint32 id : ids)
+            list << ' ' << id;
+        handler->PSendSysMessage("Trial profile, all instances (%u live:%s):", uint32(ids.size()), ids.empty() ? " none" : list.str().c_str());
+        SendPerfProfile(handler, TrialProfiler::instance()->Aggregate());
+#else
+        (void)args;
+        handler->SendSysMessage("The trial profiler is not built in (TRIAL_OF_FINALITY_PROFILER=0).");
+#endif
+        return true;
+    }
 
-            if (CheeringNpcsTargetNpcFlags != UNIT_NPC_FLAG_NONE)
+    // .trial trace dump [instanceId]
+    static bool ChatCommand_trial_trace(ChatHandler* handler, const char* args)
+    {
+        std::istringstream iss(args ? args : "");
+        std::string action;
+        uint32 instanceId = 0;
+        iss >> action >> instanceId;
+        if (action != "dump")
+        {
+            std::vector<uint32> ids = TrialTraceRegistry::instance()->GetTracedInstances();
+            std::ostringstream list;
+            for (uint32 id : ids)
+                list << ' ' << id;
+            handler->PSendSysMessage("Usage: .trial trace dump [instanceId]. Traced instances:%s", ids.empty() ? " none" : list.str().c_str());
+            return true;
+        }
+
+        if (!instanceId)
+        {
+            Player* player = handler->GetSession() ? handler->GetSession()->GetPlayer() : nullptr;
+            if (!player || player->GetMapId() != ArenaMapID)
             {
-                query << " AND (npcflag & " << CheeringNpcsTargetNpcFlags << ") != 0";
+                handler->SendSysMessage("Give an instance id, or use the command inside a trial instance.");
+                return true;
             }
+            instanceId = player->GetInstanceId();
+        }
 
-            if (CheeringNpcsExcludeNpcFlags != 0)
+        if (TrialTraceRegistry::instance()->RequestDump(instanceId))
+            handler->PSendSysMessage("Trace dump requested for instance %u; it is written on the instance's next update (see the server log for the file).", instanceId);
+        else
+            handler->PSendSysMessage("Instance %u is not being traced. Tracing applies to instances created while TrialOfFinality.Trace.Enable is set.", instanceId);
+        return true;
+    }
+
+    // .trial stress <count> <groupSize> [level] | status | stop
+    static bool ChatCommand_trial_stress(ChatHandler* handler, const char* args)
+    {
+        std::istringstream iss(args ? args : "");
+        std::string action;
+        iss >> action;
+        TrialStressRegistry* registry = TrialStressRegistry::instance();
+
+        if (action == "status")
+        {
+            if (!registry->HasRun())
             {
-                query << " AND (npcflag & " << CheeringNpcsExcludeNpcFlags << ") = 0";
+                handler->SendSysMessage("No stress test has run since startup.");
+                return true;
             }
+            for (std::string const& line : registry->BuildReport())
+                handler->SendSysMessage(line);
+            return true;
+        }
 
-            QueryResult result = WorldDatabase.Query(query.str().c_str());
-            if (result)
+        if (action == "stop")
+        {
+            if (!registry->IsRunning())
             {
-                uint32 count = 0;
-                do
-                {
-                    Field* fields = result->Fetch();
-                    uint32 guidLow = fields[0].Get<uint32>();
-                    uint32 zoneId = fields[1].Get<uint32>();
-                    s_cheeringNpcCacheByZone[zoneId].push_back(ObjectGuid(HighGuid::Creature, 0, guidLow));
-                    count++;
-                } while (result->NextRow());
-                sLog->outInfo("sys", "[TrialOfFinality] Cached %u cheering NPCs in %lu zones.", count, s_cheeringNpcCacheByZone.size());
-                for (const auto& pair : s_cheeringNpcCacheByZone)
-                {
-                    sLog->outDetail("[TrialOfFinality] Zone %u: Cached %lu NPCs.", pair.first, pair.second.size());
-                }
+                handler->SendSysMessage("No stress test is running.");
+                return true;
             }
-            else
+            uint32 stopped = 0;
+            for (std::shared_ptr<TrialStressInstanceStats> const& stats : registry->GetInstances())
             {
-                sLog->outInfo("sys", "[TrialOfFinality] No cheering NPCs found to cache or database error.");
+                if (stats->Outcome.load() != STRESS_OUTCOME_RUNNING)
+                    continue;
+                Map* map = sMapMgr->FindMap(ArenaMapID, stats->InstanceId);
+                if (auto* script = map && map->ToInstanceMap() ? (instance_trial_of_finality*)map->ToInstanceMap()->GetInstanceScript() : nullptr)
+                    script->AbortStressTrial();
+                else
+                    stats->Outcome.store(STRESS_OUTCOME_STOPPED);
+                ++stopped;
             }
+            handler->PSendSysMessage("Stopped %u stress trials. Their maps unload within a few seconds; the report follows in the server log and in '.trial stress status'.", stopped);
+            return true;
         }
-        else if (!CheeringNpcsEnable)
+
+        // The new instances are created on the GM's behalf, as for `.trial test`; the GM does not enter them.
+        Player* gmPlayer = handler->GetPlayer();
+        uint32 count = uint32(strtoul(action.c_str(), nullptr, 10));
+        uint32 groupSize = 0;
+        uint32 level = 0;
+        iss >> groupSize;
+        if (!(iss >> level))
+            level = gmPlayer->getLevel();
+        if (!count || !groupSize)
         {
-            sLog->outInfo("sys", "[TrialOfFinality] Cheering NPCs disabled, cache not populated.");
+            handler->SendSysMessage("Usage: .trial stress <count> <groupSize> [level] | status | stop");
+            return false;
         }
-        else if (CheeringNpcCityZoneIDs.empty())
+        if (!ModuleEnabled || !StressEnable)
         {
-            sLog->outInfo("sys", "[TrialOfFinality] No City Zone IDs configured for cheering NPCs, cache not populated.");
+            handler->SendSysMessage("Stress tests are disabled. Set TrialOfFinality.Stress.Enable on a test realm to use them.");
+            return true;
+        }
+        if (registry->IsRunning())
+        {
+            handler->SendSysMessage("A stress test is already running. See '.trial stress status', or end it with '.trial stress stop'.");
+            return true;
+        }
+        if (count > StressMaxInstances || groupSize > 40 || !level || level > MAX_TRIAL_LEVEL)
+        {
+            handler->PSendSysMessage("Use at most %u instances (TrialOfFinality.Stress.MaxInstances), 1-40 bots per group and a level from 1 to %u.", StressMaxInstances, MAX_TRIAL_LEVEL);
+            return false;
+        }
+        if (!GetTrialBandKey(uint8(level)))
+        {
+            handler->PSendSysMessage("No level band covers level %u.", level);
+            return false;
         }
 
-        // Helper lambda for parsing aura ID strings
-        auto parseAuraIdString = [](const std::string& auraStr, const std::string& tierName) -> std::vector<uint32> {
-            std::vector<uint32> auras;
-            if (auraStr.empty()) {
-                return auras;
+        registry->Begin(groupSize, uint8(level));
+        uint64 startNs = TrialPerfNowNs();
+        uint32 started = 0;
+        for (; started < count; ++started)
+        {
+            InstanceMap* instanceMap = sMapMgr->CreateNewInstance(ArenaMapID, gmPlayer, INSTANCE_DIFFICULTY_NORMAL);
+            auto* script = instanceMap ? (instance_trial_of_finality*)instanceMap->GetInstanceScript() : nullptr;
+            if (!script)
+            {
+                sLog->outError("sys", "[TrialOfFinality] Stress test could not create instance %u of %u on map %u.", started + 1, count, ArenaMapID);
+                break;
             }
+            script->StartStressTrial(registry->Add(instanceMap->GetInstanceId()), groupSize, uint8(level));
+        }
 
-            std::stringstream ss(auraStr);
-            std::string item;
-            while (getline(ss, item, ',')) {
-                // Trim whitespace
-                size_t first = item.find_first_not_of(" \t\n\r\f\v");
-                if (std::string::npos == first) continue;
-                size_t last = item.find_last_not_of(" \t\n\r\f\v");
-                item = item.substr(first, (last - first + 1));
-
-                if (item.empty()) continue;
+        sLog->outInfo("sys", "[TrialOfFinality] %s started a stress test: %u of %u instances with %u bots at level %u.",
+            gmPlayer->GetName().c_str(), started, count, groupSize, level);
+        handler->PSendSysMessage("Started %u of %u stress trials with %u bots at level %u in %.1f ms. Follow them with '.trial stress status' and '.trial perf'.",
+            started, count, groupSize, level, (TrialPerfNowNs() - startNs) / 1e6);
+        return true;
+    }
 
-                try {
-                    unsigned long id_ul = std::stoul(item);
-                    if (id_ul == 0 || id_ul > UINT32_MAX) {
-                        sLog->outError("sys", "[TrialOfFinality] Invalid Aura ID '%s' (out of range or zero) in Custom Scaling for tier '%s'. Skipping.", item.c_str(), tierName.c_str());
-                        continue;
-                    }
-                    if (!sSpellMgr->GetSpellInfo(static_cast<uint32>(id_ul))) {
-                        sLog->outError("sys", "[TrialOfFinality] Aura ID %lu in Custom Scaling for tier '%s' does not exist. Skipping.", id_ul, tierName.c_str());
-                        continue;
-                    }
-                    auras.push_back(static_cast<uint32>(id_ul));
-                } catch (const std::exception& e) {
-                    sLog->outError("sys", "[TrialOfFinality] Invalid Aura ID '%s' in Custom Scaling for tier '%s'. Skipping. Error: %s", item.c_str(), tierName.c_str(), e.what());
-                }
-            }
-            sLog->outDetail("[TrialOfFinality] Loaded %lu auras for custom scaling tier '%s'.", auras.size(), tierName.c_str());
-            return auras;
-        };
+    static bool ChatCommand_trial_statussync(ChatHandler* handler, const char* /*args*/)
+    {
+        if (!TrialStatusCache::instance()->IsReady())
+        {
+            handler->SendSysMessage("The shared perma-death status cache is disabled; logins and trial starts query the database.");
+            return true;
+        }
+        uint64 cursor, applied;
+        uint32 sealed, gaps;
+        TrialStatusCache::instance()->GetStats(cursor, sealed, gaps, applied);
+        handler->PSendSysMessage("Perma-death status cache: %u sealed characters, change log applied up to version %llu, %u versions awaited, %llu changes applied since startup.",
+            sealed, (unsigned long long)cursor, gaps, (unsigned long long)applied);
+        return true;
+    }
 
-        // Helper lambda for parsing NPC pool strings with encounter groups
-        auto parseNpcPoolString = [](const std::string& poolStr, const std::string& poolName) -> std::vector<std::vector<uint32>> {
-            std::vector<std::vector<uint32>> pool;
-            if (poolStr.empty()) {
-                sLog->outWarn("sys", "[TrialOfFinality] NPC Pool '%s' is empty or not found in configuration.", poolName.c_str());
-                return pool;
-            }
-
-            std::string currentNumber;
-            std::vector<uint32> currentGroup;
-            bool inGroup = false;
-            int entryCount = 0;
-            int invalidCount = 0;
-
-            auto processNumber = [&](bool isEndOfGroup) {
-                if (currentNumber.empty()) {
-                    if (isEndOfGroup) { // e.g. (1,)
-                        sLog->outError("sys", "[TrialOfFinality] Malformed group in NPC Pool '%s' (e.g., empty entry or trailing comma).", poolName.c_str());
-                        invalidCount++;
-                    }
-                    return;
-                }
+    // .trial top [fastest|waves] [<class>|<level>] - reads the in-memory boards only.
+    static bool ChatCommand_trial_top(ChatHandler* handler, const char* args)
+    {
+        if (!ModuleEnabled || !LeaderboardEnable)
+        {
+            handler->SendSysMessage(TRIAL_STRING_LEADERBOARD_DISABLED);
+            return true;
+        }
 
-                try {
-                    uint32 id = std::stoul(currentNumber);
-                    if (id == 0) {
-                         sLog->outError("sys", "[TrialOfFinality] Creature ID 0 is invalid in NPC Pool '%s'.", poolName.c_str());
-                         invalidCount++;
-                         currentNumber.clear();
-                         return;
-                    }
-                    if (!sObjectMgr->GetCreatureTemplate(id)) {
-                        sLog->outError("sys", "[TrialOfFinality] Creature ID %u in NPC Pool '%s' does not exist. Skipping.", id, poolName.c_str());
-                        invalidCount++;
-                        currentNumber.clear();
-                        return;
-                    }
+        static const std::pair<const char*, uint8> classNames[] = {
+            { "warrior", CLASS_WARRIOR }, { "paladin", CLASS_PALADIN }, { "hunter", CLASS_HUNTER }, { "rogue", CLASS_ROGUE },
+            { "priest", CLASS_PRIEST }, { "deathknight", CLASS_DEATH_KNIGHT }, { "shaman", CLASS_SHAMAN }, { "mage", CLASS_MAGE },
+            { "warlock", CLASS_WARLOCK }, { "druid", CLASS_DRUID }
+        };
 
-                    if (inGroup) {
-                        currentGroup.push_back(id);
-                    } else {
-                        pool.push_back({id});
-                    }
-                    entryCount++;
-                } catch (const std::exception& e) {
-                    sLog->outError("sys", "[TrialOfFinality] Invalid Creature ID format '%s' in NPC Pool '%s'. Error: %s", currentNumber.c_str(), poolName.c_str(), e.what());
-                    invalidCount++;
-                }
-                currentNumber.clear();
-            };
-
-            for (char c : poolStr) {
-                if (std::isspace(c)) continue;
-
-                if (std::isdigit(c)) {
-                    currentNumber += c;
-                } else if (c == '(') {
-                    if (inGroup) {
-                        sLog->outError("sys", "[TrialOfFinality] Nested parentheses are not allowed in NPC Pool '%s'. Aborting parse.", poolName.c_str());
-                        return {};
-                    }
-                    processNumber(false); // Process any pending single number before the group
-                    inGroup = true;
-                    currentGroup.clear();
-                } else if (c == ')') {
-                    if (!inGroup) {
-                        sLog->outError("sys", "[TrialOfFinality] Mismatched closing parenthesis in NPC Pool '%s'. Aborting parse.", poolName.c_str());
-                        return {};
-                    }
-                    processNumber(true); // Process the last number inside the parenthesis
-                    if (!currentGroup.empty()) {
-                        pool.push_back(currentGroup);
-                    } else if (invalidCount > 0) {
-                        sLog->outWarn("sys", "[TrialOfFinality] An encounter group in NPC Pool '%s' was invalid and has been skipped.", poolName.c_str());
-                    }
-                    inGroup = false;
-                } else if (c == ',') {
-                    processNumber(inGroup); // Process the number before the comma
-                } else {
-                    sLog->outError("sys", "[TrialOfFinality] Invalid character '%c' in NPC Pool '%s'. Aborting parse.", c, poolName.c_str());
-                    return {};
-                }
+        TrialLeaderboardMetric metric = LEADERBOARD_FASTEST_CLEAR;
+        TrialLeaderboardScope scope = LEADERBOARD_SCOPE_OVERALL;
+        uint32 key = 0;
+        std::string scopeName = "overall";
+        std::stringstream ss(args ? args : "");
+        std::string token;
+        while (ss >> token)
+        {
+            std::transform(token.begin(), token.end(), token.begin(), ::tolower);
+            if (token == "fastest")
+            {
+                metric = LEADERBOARD_FASTEST_CLEAR;
+                continue;
             }
-
-            if (inGroup) {
-                sLog->outError("sys", "[TrialOfFinality] Unclosed parenthesis at end of NPC Pool '%s'. Aborting parse.", poolName.c_str());
-                return {};
+            if (token == "waves")
+            {
+                metric = LEADERBOARD_MOST_WAVES;
+                continue;
             }
-            processNumber(false); // Process any trailing number
-
-            sLog->outDetail("[TrialOfFinality] Loaded %lu encounter groups with a total of %d valid NPC entries for pool '%s' (%d invalid entries skipped).", pool.size(), entryCount, poolName.c_str(), invalidCount);
-            if (pool.empty() && !poolStr.empty()) {
-                 sLog->outWarn("sys", "[TrialOfFinality] NPC Pool '%s' was configured as '%s' but resulted in an empty pool after parsing. Check formatting.", poolName.c_str(), poolStr.c_str());
+            auto classItr = std::find_if(std::begin(classNames), std::end(classNames), [&token](auto const& c) { return token == c.first; });
+            if (classItr != std::end(classNames))
+            {
+                scope = LEADERBOARD_SCOPE_CLASS;
+                key = classItr->second;
+                scopeName = classItr->first;
+                continue;
             }
-            return pool;
-        };
-
-        // Load NPC Pools from configuration
-        NpcPoolEasy.clear();
-        NpcPoolMedium.clear();
-        NpcPoolHard.clear();
-
-        // Default strings here are fallbacks if .conf key is missing, actual defaults user sees are in .conf file.
-        std::string easyPoolStr = sConfigMgr->GetOption<std::string>("TrialOfFinality.NpcPools.Easy", "70001,70002,70003,70004,70005");
-        std::string mediumPoolStr = sConfigMgr->GetOption<std::string>("TrialOfFinality.NpcPools.Medium", "70011,70012,70013,70014,70015");
-        std::string hardPoolStr = sConfigMgr->GetOption<std::string>("TrialOfFinality.NpcPools.Hard", "70021,70022,70023,70024,70025");
-
-        NpcPoolEasy = parseNpcPoolString(easyPoolStr, "Easy");
-        NpcPoolMedium = parseNpcPoolString(mediumPoolStr, "Medium");
-        NpcPoolHard = parseNpcPoolString(hardPoolStr, "Hard");
-
-        // Load Custom Scaling Rules
-        sLog->outDetail("[TrialOfFinality] Loading Custom NPC Scaling Rules...");
-        CustomScalingEasy.HealthMultiplier = sConfigMgr->GetOption<float>("TrialOfFinality.NpcScaling.Custom.Easy.HealthMultiplier", 1.0f);
-        CustomScalingEasy.AurasToAdd = parseAuraIdString(sConfigMgr->GetOption<std::string>("TrialOfFinality.NpcScaling.Custom.Easy.AurasToAdd", ""), "Easy");
-
-        CustomScalingMedium.HealthMultiplier = sConfigMgr->GetOption<float>("TrialOfFinality.NpcScaling.Custom.Medium.HealthMultiplier", 1.2f);
-        CustomScalingMedium.AurasToAdd = parseAuraIdString(sConfigMgr->GetOption<std::string>("TrialOfFinality.NpcScaling.Custom.Medium.AurasToAdd", ""), "Medium");
-
-        CustomScalingHard.HealthMultiplier = sConfigMgr->GetOption<float>("TrialOfFinality.NpcScaling.Custom.Hard.HealthMultiplier", 1.5f);
-        CustomScalingHard.AurasToAdd = parseAuraIdString(sConfigMgr->GetOption<std::string>("TrialOfFinality.NpcScaling.Custom.Hard.AurasToAdd", ""), "Hard");
-
-        if (!FateweaverArithosEntry || !TrialTokenEntry || !AnnouncerEntry || !TitleRewardID) {
-            sLog->outError("sys", "Trial of Finality: Critical EntryID (NPC, Item, Title) not configured. Disabling module functionality.");
-            ModuleEnabled = false; return;
+            if (!token.empty() && token.size() <= 3 && std::all_of(token.begin(), token.end(), ::isdigit))
+            {
+                uint32 level = std::stoul(token);
+                key = GetTrialBandKey(uint8(std::min<uint32>(level, MAX_TRIAL_LEVEL)));
+                if (!key)
+                {
+                    handler->PSendSysMessage("No level band covers level %u.", level);
+                    return false;
+                }
+                scope = LEADERBOARD_SCOPE_BAND;
+                scopeName = "level band from " + std::to_string(key);
+                continue;
+            }
+            handler->SendSysMessage(TRIAL_STRING_LEADERBOARD_USAGE);
+            return false;
         }
-        sLog->outInfo("sys", "Trial of Finality: Configuration loaded. Module enabled.");
-        if (reload) { sLog->outInfo("sys", "Trial of Finality: Configuration reloaded. Consider restarting for full effect if scripts were already registered."); }
-    }
-};
 
-namespace ModTrialOfFinality {
-    std::map<uint32, std::vector<ObjectGuid>> ModServerScript::s_cheeringNpcCacheByZone;
-} // end namespace ModTrialOfFinality
-
-// --- GM Command Scripts ---
-class trial_commandscript : public CommandScript
-{
-public:
-    trial_commandscript() : CommandScript("trial_commandscript") { }
+        std::vector<TrialLeaderboardEntry> board = TrialLeaderboards::instance()->GetBoard(metric, scope, key);
+        handler->PSendSysMessage("Trial of Finality - %s (%s):", TrialLeaderboardMetricNames[metric], scopeName.c_str());
+        if (board.empty())
+            handler->SendSysMessage(TRIAL_STRING_LEADERBOARD_EMPTY);
+        for (uint32 i = 0; i < board.size(); ++i)
+            handler->SendSysMessage(FormatLeaderboardLine(metric, i + 1, board[i]));
+        return true;
+    }
 
-    std::vector<ChatCommand> GetCommands() const override
+    // Per-instance spectator traffic. `reset` starts a new measurement, e.g. before adding one more spectator.
+    static bool ChatCommand_trial_spectators(ChatHandler* handler, const char* args)
     {
-        static std::vector<ChatCommand> trialCommandTable = {
-            { "reset", SEC_GAMEMASTER, true, &ChatCommand_trial_reset, "" },
-            { "test",  SEC_GAMEMASTER, true, &ChatCommand_trial_test,  "" }
-        };
-        static std::vector<ChatCommand> commandTable = {
-            { "trial", SEC_GAMEMASTER, true, nullptr, "", trialCommandTable }
-        };
-        return commandTable;
+        if (args && std::string(args) == "reset")
+        {
+            TrialSpectatorRegistry::instance()->ResetStats();
+            handler->SendSysMessage("Spectator packet counters reset.");
+            return true;
+        }
+
+        auto instances = TrialSpectatorRegistry::instance()->GetInstanceStats();
+        if (instances.empty())
+        {
+            handler->SendSysMessage("No trial has been spectated since the last reset.");
+            return true;
+        }
+        for (auto const& [instanceId, stats] : instances)
+        {
+            double seconds = std::max(1u, getMSTimeDiff(stats.MeasureStartMs, getMSTime())) / double(IN_MILLISECONDS);
+            double packetRate = stats.PacketsSent / seconds;
+            handler->PSendSysMessage("Instance %u: %u spectators (peak %u). Forwarded %llu packets / %llu bytes in %.0f s: %.1f packets/s, %.1f per spectator, %.0f bytes/s.",
+                instanceId, stats.Spectators, stats.PeakSpectators, (unsigned long long)stats.PacketsSent, (unsigned long long)stats.BytesSent,
+                seconds, packetRate, packetRate / std::max(1u, stats.PeakSpectators), stats.BytesSent / seconds);
+            handler->PSendSysMessage("  Dropped %llu movement and %llu combat log packets (%llu bytes).",
+                (unsigned long long)stats.MovementDropped, (unsigned long long)stats.CombatLogDropped, (unsigned long long)stats.BytesDropped);
+        }
+        return true;
     }
 
     static bool ChatCommand_trial_test(ChatHandler* handler, const char* /*args*/)
@@ -1547,7 +6139,7 @@ public:
 
         sLog->outInfo("sys", "[TrialOfFinality] GM %s starting a solo test trial in temporary group %u.", gmPlayer->GetName().c_str(), tempGroup->GetId());
 
-        TrialManager::instance()->PrepareForInstance(tempGroup, gmPlayer->getLevel(), true);
+        TrialManager::instance()->PrepareForInstance(tempGroup, gmPlayer->getLevel(), true, { gmPlayer->GetGUID() });
 
         InstanceMap* instanceMap = sMapMgr->CreateNewInstance(ArenaMapID, gmPlayer, INSTANCE_DIFFICULTY_NORMAL);
         if (!instanceMap)
@@ -1591,7 +6183,7 @@ public:
         }
 
         // 1. Clear Perma-death DB flag
-        CharacterDatabase.ExecuteFmt("UPDATE character_trial_finality_status SET is_perma_failed = 0, last_failed_timestamp = NULL WHERE guid = %u", playerGuid.GetCounter());
+        WriteTrialPermaDeathStatus(playerGuid.GetCounter(), false);
         handler->PSendSysMessage("Cleared Trial of Finality perma-death DB flag for character %s (GUID %u).", charName.c_str(), playerGuid.GetCounter());
 
         std::string log_detail = "GM cleared perma-death DB flag for " + charName;
@@ -1603,14 +6195,14 @@ public:
         sLog->outInfo("sys", "[TrialOfFinality] GM %s cleared perma-death DB flag for %s (GUID %u).",
                      (handler->GetPlayer() ? handler->GetPlayer()->GetName().c_str() : "UnknownGM"), charName.c_str(), playerGuid.GetCounter());
         if (targetPlayer && targetPlayer->GetSession()) {
-             ChatHandler(targetPlayer->GetSession()).SendSysMessage("Your Trial of Finality perma-death status (DB) has been reset by a GM.");
+             TrialTextCache::instance()->SendSysMessage(targetPlayer, TRIAL_STRING_GM_RESET_STATUS);
         }
 
         // 2. Remove Trial Token if player has it (only if online)
         if (targetPlayer) {
             if (targetPlayer->HasItemCount(TrialTokenEntry, 1, true)) {
                 targetPlayer->DestroyItemCount(TrialTokenEntry, 1, true, false);
-                if (targetPlayer->GetSession()) ChatHandler(targetPlayer->GetSession()).SendSysMessage("Your Trial Token has been removed by a GM.");
+                TrialTextCache::instance()->SendSysMessage(targetPlayer, TRIAL_STRING_GM_RESET_TOKEN);
                 handler->PSendSysMessage("Removed Trial Token from %s.", charName.c_str());
             }
         } else {
@@ -1621,7 +6213,7 @@ public:
         if (targetPlayer) {
             if (targetPlayer->HasAura(AURA_ID_TRIAL_PERMADEATH)) {
                 targetPlayer->RemoveAura(AURA_ID_TRIAL_PERMADEATH);
-                if (targetPlayer->GetSession()) ChatHandler(targetPlayer->GetSession()).SendSysMessage("Your Trial of Finality perma-death aura (if present) has been removed by a GM.");
+                TrialTextCache::instance()->SendSysMessage(targetPlayer, TRIAL_STRING_GM_RESET_AURA);
                 handler->PSendSysMessage("Removed Trial of Finality perma-death aura from %s as a cleanup.", charName.c_str());
             }
         } else {
@@ -1642,14 +6234,123 @@ public:
     std::vector<ChatCommand> GetCommands() const override
     {
         static std::vector<ChatCommand> commandTable;
-        if (commandTable.empty() && ForfeitEnable)
+        if (commandTable.empty())
         {
-            commandTable.push_back({ "trialforfeit", SEC_PLAYER, true, &HandleTrialForfeitCommand, "Votes to forfeit the current Trial of Finality." });
-            commandTable.push_back({ "tf",           SEC_PLAYER, true, &HandleTrialForfeitCommand, "Alias for /trialforfeit." });
+            if (ForfeitEnable)
+            {
+                commandTable.push_back({ "trialforfeit", SEC_PLAYER, true, &HandleTrialForfeitCommand, "Votes to forfeit the current Trial of Finality." });
+                commandTable.push_back({ "tf",           SEC_PLAYER, true, &HandleTrialForfeitCommand, "Alias for /trialforfeit." });
+            }
+            if (ConfirmationEnable)
+            {
+                commandTable.push_back({ "trialconfirm", SEC_PLAYER, false, &HandleTrialConfirmCommand, "Accepts (yes) or declines (no) your group's Trial of Finality proposal." });
+                commandTable.push_back({ "tc",           SEC_PLAYER, false, &HandleTrialConfirmCommand, "Alias for /trialconfirm." });
+            }
+            if (SpectatorsEnable)
+                commandTable.push_back({ "trialspectate", SEC_PLAYER, false, &HandleTrialSpectateCommand, "Watches a participant's Trial of Finality, or 'leave' to stop watching." });
         }
         return commandTable;
     }
 
+    static bool HandleTrialConfirmCommand(ChatHandler* handler, const char* args)
+    {
+        Player* player = handler->GetPlayer();
+        if (!player)
+        {
+            handler->SendSysMessage("This command can only be used by a player.");
+            return false;
+        }
+
+        if (!ModuleEnabled)
+        {
+            TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_MODULE_DISABLED);
+            return false;
+        }
+
+        std::string answer = args ? args : "";
+        std::transform(answer.begin(), answer.end(), answer.begin(), ::tolower);
+        if (answer == "yes" || answer == "y" || answer == "accept")
+            TrialManager::instance()->HandleTrialConfirmation(player, true);
+        else if (answer == "no" || answer == "n" || answer == "decline")
+            TrialManager::instance()->HandleTrialConfirmation(player, false);
+        else
+        {
+            TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_CONFIRM_USAGE);
+            return false;
+        }
+        return true;
+    }
+
+    static bool HandleTrialSpectateCommand(ChatHandler* handler, const char* args)
+    {
+        Player* player = handler->GetPlayer();
+        if (!player)
+        {
+            handler->SendSysMessage("This command can only be used by a player.");
+            return false;
+        }
+
+        if (!ModuleEnabled)
+        {
+            TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_MODULE_DISABLED);
+            return false;
+        }
+
+        std::string target = args ? args : "";
+        if (target.empty())
+        {
+            TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_SPECTATE_USAGE);
+            return false;
+        }
+
+        bool spectating = TrialSpectatorRegistry::instance()->GetSpectatedInstance(player->GetGUID()) != 0;
+        if (target == "leave")
+        {
+            if (!spectating || !StopSpectating(player))
+                TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_SPECTATE_NOT_SPECTATING);
+            return true;
+        }
+
+        if (spectating)
+        {
+            TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_SPECTATE_ALREADY);
+            return false;
+        }
+
+        if (player->IsInCombat() || player->GetMap()->Instanceable() || player->HasItemCount(TrialTokenEntry, 1, true))
+        {
+            TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_SPECTATE_NOT_NOW);
+            return false;
+        }
+
+        // Only someone holding a trial token inside the arena is taking part in a running trial.
+        Player* participant = ObjectAccessor::FindPlayerByName(target);
+        if (!participant || participant->GetMapId() != ArenaMapID || !participant->GetMap()->IsDungeon() ||
+            !participant->HasItemCount(TrialTokenEntry, 1, true))
+        {
+            TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_SPECTATE_NO_TRIAL);
+            return false;
+        }
+
+        uint32 instanceId = participant->GetInstanceId();
+        if (!TrialSpectatorRegistry::instance()->Add(player->GetSession(), player, instanceId))
+        {
+            TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_SPECTATE_FULL);
+            return false;
+        }
+
+        if (!player->TeleportTo(ArenaMapID, ArenaTeleportX, ArenaTeleportY, ArenaTeleportZ, ArenaTeleportO, 0, instanceId))
+        {
+            WorldLocation unused;
+            TrialSpectatorRegistry::instance()->Remove(player->GetSession(), unused);
+            TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_SPECTATE_NO_TRIAL);
+            return false;
+        }
+
+        sLog->outDetail("[TrialOfFinality] Player %s is joining instance %u as a spectator of %s.", player->GetName().c_str(), instanceId, participant->GetName().c_str());
+        return true;
+    }
+
     static bool HandleTrialForfeitCommand(ChatHandler* handler, const char* /*args*/)
     {
         Player* player = handler->GetPlayer();
@@ -1661,7 +6362,7 @@ public:
 
         if (!ModuleEnabled)
         {
-            ChatHandler(player->GetSession()).SendSysMessage("The Trial of Finality module is currently disabled.");
+            TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_MODULE_DISABLED);
             return false;
         }
 
@@ -1672,7 +6373,7 @@ public:
         }
         else
         {
-            ChatHandler(player->GetSession()).SendSysMessage("You can only use this command inside the Trial of Finality.");
+            TrialTextCache::instance()->SendSysMessage(player, TRIAL_STRING_FORFEIT_OUTSIDE_TRIAL);
         }
 
         return true;
@@ -1687,6 +6388,9 @@ void Addmod_trial_of_finality_Scripts() {
     new ModTrialOfFinality::npc_fateweaver_arithos();
     new ModTrialOfFinality::ModPlayerScript();
     new ModTrialOfFinality::ModServerScript();
+    new ModTrialOfFinality::ModWorldScript();
+    new ModTrialOfFinality::ModMovementHandlerScript();
+    new ModTrialOfFinality::ModUnitScript();
     new ModTrialOfFinality::trial_commandscript(); // GM commands
     new ModTrialOfFinality::trial_player_commandscript(); // Player commands
 }
@@ -0,0 +1,161 @@
+/*
+ * Trial of Finality combat black box: on-disk format.
+ *
+ * Shared by the worldserver module (writer) and tools/trial_blackbox_decode (reader), so it depends on
+ * the C++ standard library only. All integers are little endian regardless of the host.
+ *
+ * File layout:
+ *   Header (HEADER_SIZE bytes, uncompressed)
+ *   zlib stream (compress2) of RecordCount records of RECORD_SIZE bytes each, oldest first
+ */
+
+#ifndef TRIAL_BLACKBOX_FORMAT_H
+#define TRIAL_BLACKBOX_FORMAT_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace ModTrialOfFinality
+{
+namespace BlackBox
+{
+
+static constexpr uint32_t MAGIC = 0x42424654;   // "TFBB"
+static constexpr uint16_t VERSION = 1;
+static constexpr uint32_t HEADER_SIZE = 48;
+static constexpr uint32_t RECORD_SIZE = 24;
+
+enum RecordType : uint8_t
+{
+    RECORD_DAMAGE_TAKEN = 1,    // Source, Value = amount, Aux = health after
+    RECORD_HEAL_RECEIVED,       // Source, Value = amount, Aux = health after
+    RECORD_AURA_APPLIED,        // Source = caster, Value = spell id
+    RECORD_AURA_REMOVED,        // Source = caster, Value = spell id, Aux = AuraRemoveMode
+    RECORD_POSITION,            // Value, Aux, Aux2 = x, y, z as float bits
+    RECORD_DOWNED               // The participant was downed; Aux = wave
+};
+
+enum RecordFlags : uint8_t
+{
+    FLAG_SOURCE_CREATURE = 0x01,    // Source is a creature entry, otherwise a character guid
+    FLAG_SOURCE_SELF = 0x02         // Source is the participant
+};
+
+struct Record
+{
+    uint32_t TimeMs = 0;        // Since the recorder started
+    uint8_t Type = 0;
+    uint8_t Flags = 0;
+    uint16_t HealthPct = 0;     // Participant health after the event, in hundredths of a percent
+    uint32_t Source = 0;
+    uint32_t Value = 0;
+    uint32_t Aux = 0;
+    uint32_t Aux2 = 0;
+};
+
+struct Header
+{
+    uint32_t Magic = MAGIC;
+    uint16_t Version = VERSION;
+    uint16_t RecordSize = RECORD_SIZE;
+    uint32_t CharacterGuid = 0;
+    uint32_t InstanceId = 0;
+    uint32_t GroupId = 0;
+    uint32_t Wave = 0;              // Wave in which the participant was downed
+    uint64_t StartedUnix = 0;       // Wall clock time of TimeMs 0
+    uint64_t FlushedUnix = 0;
+    uint32_t RecordCount = 0;
+    uint32_t CompressedSize = 0;    // Bytes of zlib data after the header
+};
+
+inline void PutU16(uint8_t* out, uint16_t value) { out[0] = uint8_t(value); out[1] = uint8_t(value >> 8); }
+inline void PutU32(uint8_t* out, uint32_t value) { for (int i = 0; i < 4; ++i) out[i] = uint8_t(value >> (8 * i)); }
+inline void PutU64(uint8_t* out, uint64_t value) { for (int i = 0; i < 8; ++i) out[i] = uint8_t(value >> (8 * i)); }
+inline uint16_t GetU16(const uint8_t* in) { return uint16_t(in[0] | (in[1] << 8)); }
+inline uint32_t GetU32(const uint8_t* in) { uint32_t value = 0; for (int i = 3; i >= 0; --i) value = (value << 8) | in[i]; return value; }
+inline uint64_t GetU64(const uint8_t* in) { uint64_t value = 0; for (int i = 7; i >= 0; --i) value = (value << 8) | in[i]; return value; }
+
+inline uint32_t FloatBits(float value) { uint32_t bits; std::memcpy(&bits, &value, sizeof(bits)); return bits; }
+inline float BitsFloat(uint32_t bits) { float value; std::memcpy(&value, &bits, sizeof(value)); return value; }
+
+inline void EncodeRecord(const Record& record, uint8_t* out)
+{
+    PutU32(out, record.TimeMs);
+    out[4] = record.Type;
+    out[5] = record.Flags;
+    PutU16(out + 6, record.HealthPct);
+    PutU32(out + 8, record.Source);
+    PutU32(out + 12, record.Value);
+    PutU32(out + 16, record.Aux);
+    PutU32(out + 20, record.Aux2);
+}
+
+inline Record DecodeRecord(const uint8_t* in)
+{
+    Record record;
+    record.TimeMs = GetU32(in);
+    record.Type = in[4];
+    record.Flags = in[5];
+    record.HealthPct = GetU16(in + 6);
+    record.Source = GetU32(in + 8);
+    record.Value = GetU32(in + 12);
+    record.Aux = GetU32(in + 16);
+    record.Aux2 = GetU32(in + 20);
+    return record;
+}
+
+inline void EncodeHeader(const Header& header, uint8_t* out)
+{
+    std::memset(out, 0, HEADER_SIZE);
+    PutU32(out, header.Magic);
+    PutU16(out + 4, header.Version);
+    PutU16(out + 6, header.RecordSize);
+    PutU32(out + 8, header.CharacterGuid);
+    PutU32(out + 12, header.InstanceId);
+    PutU32(out + 16, header.GroupId);
+    PutU32(out + 20, header.Wave);
+    PutU64(out + 24, header.StartedUnix);
+    PutU64(out + 32, header.FlushedUnix);
+    PutU32(out + 40, header.RecordCount);
+    PutU32(out + 44, header.CompressedSize);
+}
+
+// Returns false if the buffer is not a black box header this version can read.
+inline bool DecodeHeader(const uint8_t* in, Header& header)
+{
+    header.Magic = GetU32(in);
+    header.Version = GetU16(in + 4);
+    header.RecordSize = GetU16(in + 6);
+    if (header.Magic != MAGIC || header.Version != VERSION || header.RecordSize != RECORD_SIZE)
+        return false;
+    header.CharacterGuid = GetU32(in + 8);
+    header.InstanceId = GetU32(in + 12);
+    header.GroupId = GetU32(in + 16);
+    header.Wave = GetU32(in + 20);
+    header.StartedUnix = GetU64(in + 24);
+    header.FlushedUnix = GetU64(in + 32);
+    header.RecordCount = GetU32(in + 40);
+    header.CompressedSize = GetU32(in + 44);
+    return true;
+}
+
+inline const char* RecordTypeName(uint8_t type)
+{
+    switch (type)
+    {
+        case RECORD_DAMAGE_TAKEN: return "damage";
+        case RECORD_HEAL_RECEIVED: return "heal";
+        case RECORD_AURA_APPLIED: return "aura+";
+        case RECORD_AURA_REMOVED: return "aura-";
+        case RECORD_POSITION: return "position";
+        case RECORD_DOWNED: return "downed";
+        default: return "unknown";
+    }
+}
+
+} // namespace BlackBox
+} // namespace ModTrialOfFinality
+
+#endif // TRIAL_BLACKBOX_FORMAT_H
@@ -0,0 +1,26 @@
+-- Exports per-level health and damage of the trial's creatures for tools/trial_estimator.
+--
+-- Trial creatures are set to the group's highest level, so one row is written for every level the
+-- class stats table covers. Paste the NpcPools values of your config into @entries; group parentheses
+-- and spaces are ignored.
+--
+--   mysql -B acore_world < tools/export_creature_stats.sql > creature_stats.tsv
+--
+-- Health is the expansion base health times HealthModifier. Damage per second is the average swing
+-- (base damage over the variance range plus attack power) times DamageModifier, divided by the attack
+-- time; spells and auras are not counted.
+
+SET @entries = '70001,70002,70003,70004,70005,70006,70007,70008,70009,70010,'
+    '70011,70012,70013,70014,70015,70016,70017,70018,70019,70020,'
+    '70021,70022,70023,70024,70025,70026,70027,70028,70029,70030';
+
+SELECT
+    ct.`entry`,
+    cls.`level`,
+    ROUND(CASE ct.`exp` WHEN 0 THEN cls.`basehp0` WHEN 1 THEN cls.`basehp1` ELSE cls.`basehp2` END * ct.`HealthModifier`) AS `health`,
+    ROUND((CASE ct.`exp` WHEN 0 THEN cls.`damage_base` WHEN 1 THEN cls.`damage_exp1` ELSE cls.`damage_exp2` END * (1 + ct.`BaseVariance`) / 2
+        + cls.`attackpower` / 14 * ct.`BaseAttackTime` / 1000) * ct.`DamageModifier` / (ct.`BaseAttackTime` / 1000), 1) AS `dps`
+FROM `creature_template` ct
+JOIN `creature_classlevelstats` cls ON cls.`class` = ct.`unit_class`
+WHERE FIND_IN_SET(ct.`entry`, REPLACE(REPLACE(REPLACE(@entries, '(', ''), ')', ''), ' ', '')) > 0
+ORDER BY ct.`entry`, cls.`level`;
@@ -0,0 +1,383 @@
+/*
+ * Microbenchmarks for the Trial of Finality code that runs under load, built on the core library.
+ *
+ * Usage: trial_benchmarks [Google Benchmark flags]
+ *
+ * Results are written as JSON to trial_benchmarks.json in the working directory unless
+ * --benchmark_out is given, so two builds can be compared with Google Benchmark's tools/compare.py.
+ * Inputs are synthetic but sized like real configurations: the shipped pools have 10 entries per tier,
+ * large servers run a few hundred, and groups range from 5 players to a 40-player raid.
+ */
+
+#include "trial_arena_boundary.h"
+#include "trial_config_parsing.h"
+#include "trial_event_log.h"
+#include "trial_rules.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ModTrialOfFinality;
+
+// Every fourth slot is an encounter group of two or three creatures.
+static std::string MakePoolString(int slots)
+{
+    std::string pool;
+    uint32 entry = 70001;
+    for (int i = 0; i < slots; ++i)
+    {
+        if (i)
+            pool += ", ";
+        if (i % 4 == 3)
+        {
+            uint32 first = entry++, second = entry++;
+            pool += "(" + std::to_string(first) + "," + std::to_string(second);
+            if (i % 8 == 7)
+                pool += "," + std::to_string(entry++);
+            pool += ")";
+        }
+        else
+            pool += std::to_string(entry++);
+    }
+    return pool;
+}
+
+static TrialNpcPool MakePool(int slots)
+{
+    TrialParseReport report;
+    return ParseNpcPoolString(MakePoolString(slots), "Bench", nullptr, report);
+}
+
+static std::string MakeSpawnPositions(int count)
+{
+    std::string text;
+    for (int i = 0; i < count; ++i)
+    {
+        if (i)
+            text += ";";
+        text += std::to_string(-13230.0 + i * 2.5) + "," + std::to_string(180.0 + i * 1.25) + ",30.5," + std::to_string((i % 4) * 1.57);
+    }
+    return text;
+}
+
+// --- Config Parsing ---
+static void BM_ParseNpcPoolString(benchmark::State& state)
+{
+    std::string pool = MakePoolString(int(state.range(0)));
+    for (auto _ : state)
+    {
+        TrialParseReport report;
+        benchmark::DoNotOptimize(ParseNpcPoolString(pool, "Bench", nullptr, report));
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(pool.size()));
+}
+BENCHMARK(BM_ParseNpcPoolString)->Arg(10)->Arg(64)->Arg(256);
+
+static void BM_ParseSpawnPositions(benchmark::State& state)
+{
+    std::string text = MakeSpawnPositions(int(state.range(0)));
+    for (auto _ : state)
+    {
+        TrialParseReport report;
+        benchmark::DoNotOptimize(ParseSpawnPositions(text, report));
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(text.size()));
+}
+BENCHMARK(BM_ParseSpawnPositions)->Arg(5)->Arg(20)->Arg(64);
+
+// The getline/stof parse ParseSpawnPositions replaced: a stringstream per segment and a string per
+// number. Kept as the reference point for the tokenizer.
+static void BM_ParseSpawnPositionsStringStream(benchmark::State& state)
+{
+    std::string text = MakeSpawnPositions(int(state.range(0)));
+    for (auto _ : state)
+    {
+        std::vector<TrialSpawnPoint> points;
+        std::stringstream ssPos(text);
+        std::string segment;
+        while (std::getline(ssPos, segment, ';'))
+        {
+            std::stringstream ssCoord(segment);
+            std::string coord;
+            std::vector<float> coords;
+            while (std::getline(ssCoord, coord, ','))
+                coords.push_back(std::stof(coord));
+            if (coords.size() == 4)
+                points.push_back({ coords[0], coords[1], coords[2], coords[3] });
+        }
+        benchmark::DoNotOptimize(points.data());
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(text.size()));
+}
+BENCHMARK(BM_ParseSpawnPositionsStringStream)->Arg(5)->Arg(20)->Arg(64);
+
+static std::string MakeIdList(int count)
+{
+    std::string text;
+    for (int i = 0; i < count; ++i)
+        text += (i ? ", " : "") + std::to_string(1519 + i * 17);
+    return text;
+}
+
+static void BM_ParseUIntList(benchmark::State& state)
+{
+    std::string text = MakeIdList(int(state.range(0)));
+    for (auto _ : state)
+    {
+        TrialParseReport report;
+        benchmark::DoNotOptimize(ParseUIntList(text, "Bench", report));
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(text.size()));
+}
+BENCHMARK(BM_ParseUIntList)->Arg(9)->Arg(64);
+
+// The getline/stoul loop the ID lists (CityZoneIDs, AurasToAdd, SpawnLayout) used before ParseUIntList.
+static void BM_ParseUIntListStringStream(benchmark::State& state)
+{
+    std::string text = MakeIdList(int(state.range(0)));
+    for (auto _ : state)
+    {
+        std::vector<uint32> values;
+        std::stringstream ss(text);
+        std::string item;
+        while (std::getline(ss, item, ','))
+            if (!item.empty())
+                values.push_back(uint32(std::stoul(item)));
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(text.size()));
+}
+BENCHMARK(BM_ParseUIntListStringStream)->Arg(9)->Arg(64);
+
+static void BM_ParseFloatList(benchmark::State& state)
+{
+    std::string text = "-13224.0,195.0,100.0";
+    std::vector<float> values;
+    for (auto _ : state)
+        benchmark::DoNotOptimize(ParseFloatList(text, ',', values));
+}
+BENCHMARK(BM_ParseFloatList);
+
+// --- Wave Selection ---
+static void BM_SelectEncounterGroups(benchmark::State& state)
+{
+    TrialNpcPool pool = MakePool(int(state.range(0)));
+    std::mt19937 rng(42);
+    std::vector<uint32> entries;
+    for (auto _ : state)
+    {
+        entries.clear();
+        SelectEncounterGroups(pool, EncounterGroupCount(5, 5), 5, rng, entries);
+        benchmark::DoNotOptimize(entries.data());
+    }
+}
+BENCHMARK(BM_SelectEncounterGroups)->Arg(10)->Arg(64)->Arg(256);
+
+// The selection SpawnActualWave used before SelectEncounterGroups: seed a generator from
+// random_device, copy the whole pool and shuffle all of it. Kept as the reference point.
+static void BM_SelectEncounterGroupsCopyShuffle(benchmark::State& state)
+{
+    TrialNpcPool pool = MakePool(int(state.range(0)));
+    for (auto _ : state)
+    {
+        TrialNpcPool selectedGroups = pool;
+        std::random_device rd;
+        std::mt19937 g(rd());
+        std::shuffle(selectedGroups.begin(), selectedGroups.end(), g);
+        benchmark::DoNotOptimize(selectedGroups.data());
+    }
+}
+BENCHMARK(BM_SelectEncounterGroupsCopyShuffle)->Arg(10)->Arg(64)->Arg(256);
+
+// --- Event Log ---
+static TrialEventRecord MakeEventRecord()
+{
+    TrialEventRecord record;
+    record.Type = TRIAL_EVENT_PLAYER_DEATH_TOKEN;
+    record.GroupId = 1042;
+    record.PlayerGuid = 123456;
+    record.AccountId = 7788;
+    record.HighestLevel = 80;
+    record.Wave = 3;
+    record.PlayerName = "Arithmancer";
+    record.Details = "Player downed, awaiting resurrection or wave end.";
+    return record;
+}
+
+static void BM_FormatTrialEventSlog(benchmark::State& state)
+{
+    TrialEventRecord record = MakeEventRecord();
+    std::string out;
+    for (auto _ : state)
+    {
+        out.clear();
+        FormatTrialEventSlog(record, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+}
+BENCHMARK(BM_FormatTrialEventSlog);
+
+static void BM_FormatTrialEventInsert(benchmark::State& state)
+{
+    TrialEventRecord record = MakeEventRecord();
+    std::string out;
+    for (auto _ : state)
+    {
+        out.clear();
+        FormatTrialEventInsert(record, out);
+        benchmark::DoNotOptimize(out.data());
+    }
+}
+BENCHMARK(BM_FormatTrialEventInsert);
+
+// --- Roster ---
+// Mirrors CheckForWipe: each participant's status is built from the downed map, as the instance does.
+static void BM_CountStandingMembers(benchmark::State& state)
+{
+    uint32 groupSize = uint32(state.range(0));
+    std::vector<uint64> participants;
+    std::map<uint64, int64> downed;
+    std::vector<bool> alive;
+    for (uint32 i = 0; i < groupSize; ++i)
+    {
+        participants.push_back(0x0000000000100000ULL + i);
+        alive.push_back(i % 3 != 0);
+        if (i % 3 == 0)
+            downed[participants.back()] = 1700000000;
+    }
+    for (auto _ : state)
+    {
+        uint32 standing = 0;
+        for (uint32 i = 0; i < groupSize; ++i)
+        {
+            TrialMemberStatus status;
+            status.Alive = alive[i];
+            status.Downed = downed.count(participants[i]) > 0;
+            if (IsMemberStanding(status))
+                ++standing;
+        }
+        benchmark::DoNotOptimize(standing);
+    }
+}
+BENCHMARK(BM_CountStandingMembers)->Arg(5)->Arg(10)->Arg(40);
+
+// --- Arena Boundary ---
+static TrialArenaBoundary MakeArena()
+{
+    TrialArenaBoundary boundary;
+    boundary.AddCircle(-13224.0f, 195.0f, 100.0f);
+    boundary.AddCircle(-13100.0f, 195.0f, 40.0f);
+    boundary.AddPolygon({ { -13180.0f, 170.0f }, { -13120.0f, 170.0f }, { -13120.0f, 220.0f }, { -13180.0f, 220.0f } });
+    boundary.Compile(3.0f, 30.0f, 8.0f);
+    return boundary;
+}
+
+static std::vector<std::array<float, 3>> MakePositions(size_t count)
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> x(-13360.0f, -13030.0f), y(60.0f, 330.0f), z(20.0f, 40.0f);
+    std::vector<std::array<float, 3>> positions(count);
+    for (auto& position : positions)
+        position = { x(rng), y(rng), z(rng) };
+    return positions;
+}
+
+static void BM_BoundaryClassify(benchmark::State& state)
+{
+    TrialArenaBoundary boundary = MakeArena();
+    std::vector<std::array<float, 3>> positions = MakePositions(4096);
+    size_t i = 0;
+    for (auto _ : state)
+    {
+        const auto& p = positions[i++ & 4095];
+        benchmark::DoNotOptimize(boundary.Classify(p[0], p[1], p[2]));
+    }
+}
+BENCHMARK(BM_BoundaryClassify);
+
+// One coalesced check of a whole group, as CheckPlayerLocationsAndEnforceBoundaries runs it.
+static void BM_BoundaryEnforceGroup(benchmark::State& state)
+{
+    uint32 groupSize = uint32(state.range(0));
+    TrialArenaBoundary boundary = MakeArena();
+    std::vector<std::array<float, 3>> positions = MakePositions(4096);
+    std::vector<TrialBoundaryState> states(groupSize);
+    std::vector<bool> warned(groupSize, false);
+    size_t i = 0;
+    uint32 clockMs = 0;
+    for (auto _ : state)
+    {
+        clockMs += 250;
+        for (uint32 member = 0; member < groupSize; ++member)
+        {
+            const auto& p = positions[i++ & 4095];
+            TrialBoundaryAction action = DecideBoundaryAction(states[member], boundary.Classify(p[0], p[1], p[2]), warned[member], clockMs, 5000);
+            if (action == BOUNDARY_ACTION_WARN)
+                warned[member] = true;
+            benchmark::DoNotOptimize(action);
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * groupSize);
+}
+BENCHMARK(BM_BoundaryEnforceGroup)->Arg(5)->Arg(40);
+
+// --- Forfeit Vote ---
+// Mirrors HandleTrialForfeit: every member votes in turn, and each vote recounts the voters.
+static void BM_ForfeitVoteTally(benchmark::State& state)
+{
+    uint32 groupSize = uint32(state.range(0));
+    std::vector<uint64> participants;
+    std::set<uint64> permanentlyFailed;
+    for (uint32 i = 0; i < groupSize; ++i)
+        participants.push_back(0x0000000000100000ULL + i);
+    for (auto _ : state)
+    {
+        std::set<uint64> votes;
+        bool passed = false;
+        for (uint64 voter : participants)
+        {
+            votes.insert(voter);
+            uint32 voters = 0;
+            for (uint64 member : participants)
+            {
+                TrialMemberStatus status;
+                status.PermaFailed = permanentlyFailed.count(member) > 0;
+                if (IsForfeitVoter(status))
+                    ++voters;
+            }
+            passed = IsForfeitVotePassed(votes.size(), voters);
+        }
+        benchmark::DoNotOptimize(passed);
+    }
+}
+BENCHMARK(BM_ForfeitVoteTally)->Arg(5)->Arg(40);
+
+int main(int argc, char** argv)
+{
+    std::vector<char*> args(argv, argv + argc);
+    bool hasOut = std::any_of(args.begin(), args.end(), [](const char* arg) { return std::strncmp(arg, "--benchmark_out=", 16) == 0; });
+    std::string out = "--benchmark_out=trial_benchmarks.json";
+    std::string outFormat = "--benchmark_out_format=json";
+    if (!hasOut)
+    {
+        args.push_back(&out[0]);
+        args.push_back(&outFormat[0]);
+    }
+
+    int count = int(args.size());
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data()))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
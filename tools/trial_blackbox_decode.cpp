@@ -0,0 +1,118 @@
+/*
+ * Decodes a Trial of Finality combat black box (.tfbb) into a readable timeline.
+ *
+ * Usage: trial_blackbox_decode <file.tfbb> [--no-positions]
+ *
+ * Times are shown from the start of the recording and, as T-, before the last record (normally the
+ * moment the character was downed). Damage and heal sources are creature entries or character guids.
+ */
+
+#include "trial_blackbox_format.h"
+
+#include <zlib.h>
+
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace ModTrialOfFinality;
+
+static std::string FormatUnix(uint64_t unixTime)
+{
+    time_t t = time_t(unixTime);
+    char buffer[32];
+    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S UTC", std::gmtime(&t));
+    return buffer;
+}
+
+static std::string FormatSource(const BlackBox::Record& record)
+{
+    if (record.Flags & BlackBox::FLAG_SOURCE_SELF)
+        return "self";
+    if (record.Flags & BlackBox::FLAG_SOURCE_CREATURE)
+        return "creature " + std::to_string(record.Source);
+    if (record.Source)
+        return "character " + std::to_string(record.Source);
+    return "unknown";
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::fprintf(stderr, "Usage: %s <file.tfbb> [--no-positions]\n", argv[0]);
+        return 2;
+    }
+    bool positions = !(argc > 2 && std::string(argv[2]) == "--no-positions");
+
+    std::ifstream in(argv[1], std::ios::binary);
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    BlackBox::Header header;
+    if (data.size() < BlackBox::HEADER_SIZE || !BlackBox::DecodeHeader(data.data(), header))
+    {
+        std::fprintf(stderr, "%s: not a version %u black box file\n", argv[1], unsigned(BlackBox::VERSION));
+        return 1;
+    }
+    if (data.size() < BlackBox::HEADER_SIZE + uint64_t(header.CompressedSize))
+    {
+        std::fprintf(stderr, "%s: truncated (%zu of %u compressed bytes)\n", argv[1], data.size() - BlackBox::HEADER_SIZE, header.CompressedSize);
+        return 1;
+    }
+
+    uLongf rawSize = uLongf(header.RecordCount) * BlackBox::RECORD_SIZE;
+    std::vector<uint8_t> raw(rawSize ? rawSize : 1);
+    if (uncompress(raw.data(), &rawSize, data.data() + BlackBox::HEADER_SIZE, header.CompressedSize) != Z_OK ||
+        rawSize != uLongf(header.RecordCount) * BlackBox::RECORD_SIZE)
+    {
+        std::fprintf(stderr, "%s: corrupt record data\n", argv[1]);
+        return 1;
+    }
+
+    std::printf("Character %u, instance %u, group %u, downed in wave %u\n", header.CharacterGuid, header.InstanceId, header.GroupId, header.Wave);
+    std::printf("Recording started %s, written %s, %u records (%u bytes compressed)\n\n",
+        FormatUnix(header.StartedUnix).c_str(), FormatUnix(header.FlushedUnix).c_str(), header.RecordCount, header.CompressedSize);
+
+    uint32_t lastMs = header.RecordCount ? BlackBox::DecodeRecord(raw.data() + (header.RecordCount - 1) * BlackBox::RECORD_SIZE).TimeMs : 0;
+    uint64_t damage = 0, healing = 0;
+    for (uint32_t i = 0; i < header.RecordCount; ++i)
+    {
+        BlackBox::Record record = BlackBox::DecodeRecord(raw.data() + i * BlackBox::RECORD_SIZE);
+        if (record.Type == BlackBox::RECORD_POSITION && !positions)
+            continue;
+
+        std::printf("%9.3fs  T-%7.3fs  %6.2f%%  %-8s ", record.TimeMs / 1000.0, (lastMs - record.TimeMs) / 1000.0,
+            record.HealthPct / 100.0, BlackBox::RecordTypeName(record.Type));
+        switch (record.Type)
+        {
+            case BlackBox::RECORD_DAMAGE_TAKEN:
+                damage += record.Value;
+                std::printf("%u from %s, health %u\n", record.Value, FormatSource(record).c_str(), record.Aux);
+                break;
+            case BlackBox::RECORD_HEAL_RECEIVED:
+                healing += record.Value;
+                std::printf("%u from %s, health %u\n", record.Value, FormatSource(record).c_str(), record.Aux);
+                break;
+            case BlackBox::RECORD_AURA_APPLIED:
+                std::printf("spell %u from %s\n", record.Value, FormatSource(record).c_str());
+                break;
+            case BlackBox::RECORD_AURA_REMOVED:
+                std::printf("spell %u from %s, remove mode %u\n", record.Value, FormatSource(record).c_str(), record.Aux);
+                break;
+            case BlackBox::RECORD_POSITION:
+                std::printf("%.2f %.2f %.2f\n", BlackBox::BitsFloat(record.Value), BlackBox::BitsFloat(record.Aux), BlackBox::BitsFloat(record.Aux2));
+                break;
+            case BlackBox::RECORD_DOWNED:
+                std::printf("in wave %u\n", record.Aux);
+                break;
+            default:
+                std::printf("type %u\n", unsigned(record.Type));
+                break;
+        }
+    }
+
+    std::printf("\nTotal damage taken %llu, healing received %llu\n", (unsigned long long)damage, (unsigned long long)healing);
+    return 0;
+}
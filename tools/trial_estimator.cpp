@@ -0,0 +1,677 @@
+/*
+ * Estimates how hard and how long Trial of Finality runs are for a config, before it is deployed.
+ *
+ * Usage: trial_estimator --config mod_trial_of_finality.conf --stats creature_stats.tsv
+ *                        [--group tank,healer,dps,dps,dps] [--levels 70,80] [--trials N] [--threads N]
+ *                        [--seed N] [--player-health-scale F] [--player-dps-scale F]
+ *                        [--rez-cooldown SECONDS] [--max-wave-seconds SECONDS]
+ *
+ * The wave program, level bands, NPC pools, health multipliers and spawn layouts are read from the
+ * config exactly as the module compiles them, and each wave draws its encounter groups with the
+ * module's SelectEncounterGroups. Creature health and damage per level come from the stats file written
+ * by tools/export_creature_stats.sql. Downed, wipe and outcome rules are the core's TrialRunState.
+ *
+ * Combat is a one-second step model: the group focuses creatures in spawn order, each creature hits the
+ * tank (or anyone, once the tank is down), and healers heal the most injured member. Player stats are
+ * rough level 80 role baselines, scaled down by a factor of four every 20 levels; use the scale options
+ * to match the gear on your realm. Members who died but survived the wave are raised in the intermission.
+ */
+
+#include "trial_config_parsing.h"
+#include "trial_rules.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace ModTrialOfFinality;
+
+enum EstimatorTier : uint8 { TIER_EASY, TIER_MEDIUM, TIER_HARD, TIER_COUNT };
+static const char* const TierNames[TIER_COUNT] = { "Easy", "Medium", "Hard" };
+
+enum EstimatorRole : uint8 { ROLE_TANK, ROLE_HEALER, ROLE_DPS };
+
+struct RoleBaseline
+{
+    float Health;
+    float Dps;
+    float Hps;
+};
+
+// Level 80 baselines in blue to early epic gear.
+static const RoleBaseline RoleBaselines[] =
+{
+    { 45000.0f, 2500.0f, 0.0f },    // Tank
+    { 25000.0f, 600.0f, 5000.0f },  // Healer
+    { 25000.0f, 5500.0f, 0.0f }     // Damage
+};
+
+static constexpr uint32 MAX_LEVEL = 80;
+static constexpr float TANK_THREAT_SHARE = 0.85f;
+static constexpr float COMBAT_NOISE = 0.15f;
+
+// --- Config ---
+// Reads "Key = Value" lines the way the worldserver config loader does: '#' starts a comment outside
+// quotes and surrounding quotes are dropped.
+class EstimatorConfig
+{
+public:
+    bool Load(const std::string& path)
+    {
+        std::ifstream in(path);
+        if (!in)
+            return false;
+        std::string line;
+        while (std::getline(in, line))
+        {
+            bool quoted = false;
+            for (size_t i = 0; i < line.size(); ++i)
+            {
+                if (line[i] == '"')
+                    quoted = !quoted;
+                else if (line[i] == '#' && !quoted)
+                {
+                    line.resize(i);
+                    break;
+                }
+            }
+            size_t equals = line.find('=');
+            if (equals == std::string::npos)
+                continue;
+            std::string key = Trim(line.substr(0, equals));
+            std::string value = Trim(line.substr(equals + 1));
+            if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+                value = value.substr(1, value.size() - 2);
+            if (!key.empty())
+                _values[key] = value;
+        }
+        return true;
+    }
+
+    // Module keys are "TrialOfFinality.<key>". Some shipped settings are written without the prefix; those
+    // are used too, with a note, because the module itself will not see them.
+    std::string Get(const std::string& key, const std::string& fallback)
+    {
+        auto itr = _values.find("TrialOfFinality." + key);
+        if (itr != _values.end())
+            return itr->second;
+        itr = _values.find(key);
+        if (itr != _values.end())
+        {
+            if (_unprefixedNoted.insert(key).second)
+                std::fprintf(stderr, "note: '%s' is set without the TrialOfFinality. prefix; the module reads TrialOfFinality.%s\n", key.c_str(), key.c_str());
+            return itr->second;
+        }
+        return fallback;
+    }
+
+    uint32 GetUInt(const std::string& key, uint32 fallback)
+    {
+        std::string value = Get(key, "");
+        return value.empty() ? fallback : uint32(std::strtoul(value.c_str(), nullptr, 10));
+    }
+
+    float GetFloat(const std::string& key, float fallback)
+    {
+        std::string value = Get(key, "");
+        return value.empty() ? fallback : std::strtof(value.c_str(), nullptr);
+    }
+
+    static std::string Trim(const std::string& text)
+    {
+        size_t begin = text.find_first_not_of(" \t\r\n");
+        if (begin == std::string::npos)
+            return "";
+        return text.substr(begin, text.find_last_not_of(" \t\r\n") - begin + 1);
+    }
+
+private:
+    std::map<std::string, std::string> _values;
+    std::set<std::string> _unprefixedNoted;
+};
+
+struct EstimatorWave
+{
+    uint8 PoolTier = TIER_EASY;
+    uint8 ScalingTier = TIER_EASY;
+    uint32 DelayMs = 0;
+    size_t SpawnPositions = 0;
+};
+
+struct EstimatorBand
+{
+    uint32 MinLevel = 1;
+    uint32 MaxLevel = MAX_LEVEL;
+    TrialNpcPool Pools[TIER_COUNT];
+    float HealthMultiplier[TIER_COUNT] = { 1.0f, 1.0f, 1.0f };
+};
+
+struct EstimatorProgram
+{
+    std::vector<EstimatorWave> Waves;
+    std::vector<EstimatorBand> Bands;
+    bool CustomScaling = false;
+
+    const EstimatorBand* FindBand(uint32 level) const
+    {
+        for (const EstimatorBand& band : Bands)
+            if (level >= band.MinLevel && level <= band.MaxLevel)
+                return &band;
+        return nullptr;
+    }
+};
+
+static void PrintReport(const TrialParseReport& report)
+{
+    for (const TrialParseMessage& message : report.Messages)
+        std::fprintf(stderr, "%s: %s\n", message.Error ? "error" : "warning", message.Text.c_str());
+}
+
+static TrialNpcPool ParsePool(const std::string& text, const std::string& name)
+{
+    TrialParseReport report;
+    TrialNpcPool pool = ParseNpcPoolString(text, name, nullptr, report);
+    PrintReport(report);
+    return pool;
+}
+
+static int ParseTier(const std::string& name, int fallback)
+{
+    for (int tier = 0; tier < TIER_COUNT; ++tier)
+    {
+        std::string lower = name, tierLower = TierNames[tier];
+        std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+        std::transform(tierLower.begin(), tierLower.end(), tierLower.begin(), ::tolower);
+        if (lower == tierLower)
+            return tier;
+    }
+    if (!name.empty())
+        std::fprintf(stderr, "warning: unknown difficulty tier '%s', using %s\n", name.c_str(), TierNames[fallback]);
+    return fallback;
+}
+
+// Mirrors the wave program, level band and pool loading in ModServerScript::OnConfigLoad.
+static EstimatorProgram LoadProgram(EstimatorConfig& config)
+{
+    EstimatorProgram program;
+    program.CustomScaling = config.Get("NpcScaling.Mode", "match_highest_level") == "custom_scaling_rules";
+
+    const char* const defaultPools[TIER_COUNT] = { "70001,70002,70003,70004,70005", "70011,70012,70013,70014,70015", "70021,70022,70023,70024,70025" };
+    const float defaultHealth[TIER_COUNT] = { 1.0f, 1.2f, 1.5f };
+    TrialNpcPool tierPools[TIER_COUNT];
+    float tierHealth[TIER_COUNT];
+    for (int tier = 0; tier < TIER_COUNT; ++tier)
+    {
+        tierPools[tier] = ParsePool(config.Get(std::string("NpcPools.") + TierNames[tier], defaultPools[tier]), TierNames[tier]);
+        tierHealth[tier] = config.GetFloat(std::string("NpcScaling.Custom.") + TierNames[tier] + ".HealthMultiplier", defaultHealth[tier]);
+    }
+
+    TrialParseReport bandsReport;
+    std::vector<TrialLevelRange> ranges = ParseLevelBands(config.Get("LevelBands", "1-80"), MAX_LEVEL, bandsReport);
+    PrintReport(bandsReport);
+    for (const TrialLevelRange& range : ranges)
+    {
+        EstimatorBand band;
+        band.MinLevel = range.MinLevel;
+        band.MaxLevel = range.MaxLevel;
+        std::string bandKey = "Band" + std::to_string(program.Bands.size() + 1);
+        for (int tier = 0; tier < TIER_COUNT; ++tier)
+        {
+            std::string poolKey = std::string("NpcPools.") + TierNames[tier] + "." + bandKey;
+            std::string bandPool = config.Get(poolKey, "");
+            band.Pools[tier] = bandPool.empty() ? tierPools[tier] : ParsePool(bandPool, std::string(TierNames[tier]) + "." + bandKey);
+            band.HealthMultiplier[tier] = config.GetFloat(std::string("NpcScaling.Custom.") + TierNames[tier] + "." + bandKey + ".HealthMultiplier", tierHealth[tier]);
+        }
+        program.Bands.push_back(std::move(band));
+    }
+
+    TrialParseReport report;
+    size_t spawnPositions = ParseSpawnPositions(config.Get("Arena.SpawnPositions", ""), report).size();
+    PrintReport(report);
+
+    const int defaultTiers[] = { TIER_EASY, TIER_EASY, TIER_MEDIUM, TIER_MEDIUM, TIER_HARD };
+    uint32 waveCount = config.GetUInt("WaveProgram.WaveCount", 5);
+    if (waveCount == 0 || waveCount > 50)
+        waveCount = 5;
+    uint32 firstDelay = config.GetUInt("WaveProgram.FirstWaveDelayMs", 5000);
+    uint32 intermission = config.GetUInt("WaveProgram.IntermissionMs", 8000);
+    for (uint32 i = 0; i < waveCount; ++i)
+    {
+        std::string prefix = "WaveProgram.Wave" + std::to_string(i + 1) + ".";
+        EstimatorWave wave;
+        wave.PoolTier = uint8(ParseTier(config.Get(prefix + "Pool", ""), i < 5 ? defaultTiers[i] : TIER_HARD));
+        wave.ScalingTier = uint8(ParseTier(config.Get(prefix + "Tier", ""), wave.PoolTier));
+        wave.DelayMs = config.GetUInt(prefix + "IntermissionMs", i == 0 ? firstDelay : intermission);
+        std::string layout = config.Get(prefix + "SpawnLayout", "");
+        if (layout.empty())
+            wave.SpawnPositions = spawnPositions;
+        else
+        {
+            TrialParseReport layoutReport;
+            for (uint32 index : ParseUIntList(layout, prefix + "SpawnLayout", layoutReport))
+                if (index <= spawnPositions)
+                    ++wave.SpawnPositions;
+            PrintReport(layoutReport);
+        }
+        program.Waves.push_back(wave);
+    }
+    return program;
+}
+
+// --- Creature Stats ---
+struct CreatureStats
+{
+    float Health = 0.0f;
+    float Dps = 0.0f;
+};
+
+typedef std::unordered_map<uint64, CreatureStats> CreatureStatsTable;
+
+static uint64 StatsKey(uint32 entry, uint32 level) { return (uint64(entry) << 8) | level; }
+
+// Rows of "entry level health dps", separated by tabs, commas or spaces. Rows that do not start with a
+// number (the header mysql -B prints) are skipped.
+static bool LoadCreatureStats(const std::string& path, CreatureStatsTable& table)
+{
+    std::ifstream in(path);
+    if (!in)
+        return false;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::replace(line.begin(), line.end(), '\t', ' ');
+        std::istringstream row(line);
+        uint32 entry, level;
+        CreatureStats stats;
+        if (row >> entry >> level >> stats.Health >> stats.Dps)
+            table[StatsKey(entry, level)] = stats;
+    }
+    return true;
+}
+
+// --- Simulation ---
+struct EstimatorOptions
+{
+    std::string ConfigPath;
+    std::string StatsPath;
+    std::vector<EstimatorRole> Group = { ROLE_TANK, ROLE_HEALER, ROLE_DPS, ROLE_DPS, ROLE_DPS };
+    std::vector<uint32> Levels = { 80 };
+    uint64 Trials = 10000;
+    uint32 Threads = 0;
+    uint64 Seed = 1;
+    float PlayerHealthScale = 1.0f;
+    float PlayerDpsScale = 1.0f;
+    uint32 RezCooldownSeconds = 0;
+    uint32 MaxWaveSeconds = 600;
+};
+
+struct LevelStats
+{
+    uint64 Trials = 0;
+    uint64 Cleared = 0;
+    uint64 Wiped = 0;
+    uint64 Stalled = 0;
+    uint64 PermaDeaths = 0;
+    std::vector<uint64> WaveReached;
+    std::vector<uint64> WaveCleared;
+    std::vector<std::vector<float>> WaveSeconds;    // Time to kill of every cleared wave
+    std::vector<float> OccupancySeconds;
+
+    explicit LevelStats(size_t waves) : WaveReached(waves), WaveCleared(waves), WaveSeconds(waves) { }
+
+    void Merge(LevelStats& other)
+    {
+        Trials += other.Trials;
+        Cleared += other.Cleared;
+        Wiped += other.Wiped;
+        Stalled += other.Stalled;
+        PermaDeaths += other.PermaDeaths;
+        for (size_t i = 0; i < WaveReached.size(); ++i)
+        {
+            WaveReached[i] += other.WaveReached[i];
+            WaveCleared[i] += other.WaveCleared[i];
+            WaveSeconds[i].insert(WaveSeconds[i].end(), other.WaveSeconds[i].begin(), other.WaveSeconds[i].end());
+        }
+        OccupancySeconds.insert(OccupancySeconds.end(), other.OccupancySeconds.begin(), other.OccupancySeconds.end());
+    }
+};
+
+struct Fighter
+{
+    EstimatorRole Role;
+    float MaxHealth;
+    float Health;
+    float Dps;
+    float Hps;
+};
+
+static void RunTrial(const EstimatorOptions& options, const EstimatorProgram& program, const CreatureStatsTable& stats,
+    uint32 level, std::mt19937& rng, LevelStats& result)
+{
+    std::normal_distribution<float> noise(1.0f, COMBAT_NOISE);
+    std::uniform_real_distribution<float> roll(0.0f, 1.0f);
+    float levelScale = std::pow(4.0f, (float(level) - 80.0f) / 20.0f);
+
+    std::vector<Fighter> group;
+    TrialRunState run(uint32(program.Waves.size()), 5000);
+    for (EstimatorRole role : options.Group)
+    {
+        const RoleBaseline& baseline = RoleBaselines[role];
+        float health = baseline.Health * levelScale * options.PlayerHealthScale;
+        group.push_back({ role, health, health, baseline.Dps * levelScale * options.PlayerDpsScale, baseline.Hps * levelScale * options.PlayerDpsScale });
+        run.AddParticipant(uint32(group.size()));
+    }
+    run.Start();
+
+    const EstimatorBand* band = program.FindBand(level);
+    float occupancy = 0.0f;
+    bool stalled = false;
+    std::vector<uint32> entries;
+    std::vector<CreatureStats> creatures;
+
+    while (!run.IsOver())
+    {
+        size_t waveIndex = run.GetCurrentWave() - 1;
+        const EstimatorWave& wave = program.Waves[waveIndex];
+        ++result.WaveReached[waveIndex];
+        occupancy += wave.DelayMs / 1000.0f;
+
+        uint32 activePlayers = run.GetStandingCount();
+        const TrialNpcPool& pool = band->Pools[wave.PoolTier];
+        entries.clear();
+        SelectEncounterGroups(pool, std::min<uint32>(EncounterGroupCount(wave.SpawnPositions, activePlayers), uint32(pool.size())),
+            wave.SpawnPositions, rng, entries);
+        float healthMultiplier = program.CustomScaling ? band->HealthMultiplier[wave.ScalingTier] : 1.0f;
+        creatures.clear();
+        for (uint32 entry : entries)
+        {
+            CreatureStats creature = stats.at(StatsKey(entry, level));
+            creature.Health *= healthMultiplier;
+            creatures.push_back(creature);
+        }
+
+        size_t target = 0;
+        uint32 seconds = 0;
+        uint32 lastRez = 0;
+        while (target < creatures.size() && !run.IsOver())
+        {
+            if (++seconds > options.MaxWaveSeconds)
+            {
+                stalled = true;
+                break;
+            }
+
+            float damage = 0.0f;
+            for (size_t i = 0; i < group.size(); ++i)
+                if (IsMemberStanding(*run.GetMember(uint32(i + 1))))
+                    damage += group[i].Dps * std::max(0.0f, noise(rng));
+            while (target < creatures.size() && damage > 0.0f)
+            {
+                float dealt = std::min(damage, creatures[target].Health);
+                creatures[target].Health -= dealt;
+                damage -= dealt;
+                if (creatures[target].Health <= 0.0f)
+                    ++target;
+            }
+
+            std::vector<uint32> standing;
+            uint32 tank = 0;
+            for (size_t i = 0; i < group.size(); ++i)
+            {
+                if (!IsMemberStanding(*run.GetMember(uint32(i + 1))))
+                    continue;
+                standing.push_back(uint32(i));
+                if (group[i].Role == ROLE_TANK && !tank)
+                    tank = uint32(i + 1);
+            }
+            for (size_t c = target; c < creatures.size() && !standing.empty(); ++c)
+            {
+                uint32 victim = tank && roll(rng) < TANK_THREAT_SHARE ? tank - 1 : standing[size_t(roll(rng) * standing.size()) % standing.size()];
+                group[victim].Health -= creatures[c].Dps * std::max(0.0f, noise(rng));
+            }
+
+            for (uint32 healer : standing)
+            {
+                if (group[healer].Hps <= 0.0f || group[healer].Health <= 0.0f)
+                    continue;
+                uint32 patient = standing.front();
+                for (uint32 i : standing)
+                    if (group[i].Health / group[i].MaxHealth < group[patient].Health / group[patient].MaxHealth)
+                        patient = i;
+                group[patient].Health = std::min(group[patient].MaxHealth, group[patient].Health + group[healer].Hps * std::max(0.0f, noise(rng)));
+            }
+
+            for (uint32 i : standing)
+                if (group[i].Health <= 0.0f && run.OnDowned(i + 1))
+                    break;
+
+            // One combat resurrection per cooldown, by any standing healer.
+            if (options.RezCooldownSeconds && !run.IsOver() && seconds - lastRez >= options.RezCooldownSeconds)
+            {
+                bool healerStanding = false;
+                for (uint32 i : standing)
+                    healerStanding = healerStanding || (group[i].Role == ROLE_HEALER && group[i].Health > 0.0f);
+                for (size_t i = 0; healerStanding && i < group.size(); ++i)
+                {
+                    if (run.GetMember(uint32(i + 1))->Downed)
+                    {
+                        run.OnResurrected(uint32(i + 1));
+                        group[i].Health = group[i].MaxHealth / 2.0f;
+                        lastRez = seconds;
+                        break;
+                    }
+                }
+            }
+        }
+
+        occupancy += float(seconds);
+        if (stalled || run.IsOver())
+            break;
+
+        result.WaveSeconds[waveIndex].push_back(float(seconds));
+        ++result.WaveCleared[waveIndex];
+        if (run.OnWaveCleared())
+            break;
+
+        // The intermission is long enough to raise the fallen and top everyone up.
+        for (size_t i = 0; i < group.size(); ++i)
+        {
+            run.OnResurrected(uint32(i + 1));
+            group[i].Health = group[i].MaxHealth;
+        }
+    }
+
+    ++result.Trials;
+    if (stalled)
+        ++result.Stalled;
+    else if (run.GetPhase() == TRIAL_RUN_SUCCEEDED)
+        ++result.Cleared;
+    else
+        ++result.Wiped;
+    result.PermaDeaths += run.GetOutcome().PermaFailed.size();
+    result.OccupancySeconds.push_back(occupancy);
+}
+
+static float Percentile(std::vector<float>& values, double percentile)
+{
+    if (values.empty())
+        return 0.0f;
+    size_t index = std::min(values.size() - 1, size_t(percentile * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+// --- Options ---
+static bool ParseOptions(int argc, char** argv, EstimatorOptions& options)
+{
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string arg = argv[i];
+        std::string value = argv[i + 1];
+        if (arg == "--config") options.ConfigPath = value;
+        else if (arg == "--stats") options.StatsPath = value;
+        else if (arg == "--trials") options.Trials = std::strtoull(value.c_str(), nullptr, 10);
+        else if (arg == "--threads") options.Threads = uint32(std::strtoul(value.c_str(), nullptr, 10));
+        else if (arg == "--seed") options.Seed = std::strtoull(value.c_str(), nullptr, 10);
+        else if (arg == "--player-health-scale") options.PlayerHealthScale = std::strtof(value.c_str(), nullptr);
+        else if (arg == "--player-dps-scale") options.PlayerDpsScale = std::strtof(value.c_str(), nullptr);
+        else if (arg == "--rez-cooldown") options.RezCooldownSeconds = uint32(std::strtoul(value.c_str(), nullptr, 10));
+        else if (arg == "--max-wave-seconds") options.MaxWaveSeconds = uint32(std::strtoul(value.c_str(), nullptr, 10));
+        else if (arg == "--group")
+        {
+            options.Group.clear();
+            std::stringstream roles(value);
+            std::string role;
+            while (std::getline(roles, role, ','))
+            {
+                if (role == "tank") options.Group.push_back(ROLE_TANK);
+                else if (role == "healer") options.Group.push_back(ROLE_HEALER);
+                else if (role == "dps") options.Group.push_back(ROLE_DPS);
+                else return false;
+            }
+        }
+        else if (arg == "--levels")
+        {
+            options.Levels.clear();
+            std::stringstream levels(value);
+            std::string level;
+            while (std::getline(levels, level, ','))
+            {
+                uint32 parsed = uint32(std::strtoul(level.c_str(), nullptr, 10));
+                if (parsed == 0 || parsed > MAX_LEVEL)
+                    return false;
+                options.Levels.push_back(parsed);
+            }
+        }
+        else
+            return false;
+    }
+    return argc % 2 == 1 && !options.ConfigPath.empty() && !options.StatsPath.empty() && !options.Group.empty() && !options.Levels.empty();
+}
+
+int main(int argc, char** argv)
+{
+    EstimatorOptions options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        std::fprintf(stderr, "Usage: %s --config <mod_trial_of_finality.conf> --stats <creature_stats.tsv>\n"
+            "       [--group tank,healer,dps,dps,dps] [--levels 70,80] [--trials N] [--threads N] [--seed N]\n"
+            "       [--player-health-scale F] [--player-dps-scale F] [--rez-cooldown SECONDS] [--max-wave-seconds SECONDS]\n", argv[0]);
+        return 2;
+    }
+
+    EstimatorConfig config;
+    if (!config.Load(options.ConfigPath))
+    {
+        std::fprintf(stderr, "%s: cannot read config\n", options.ConfigPath.c_str());
+        return 1;
+    }
+    CreatureStatsTable stats;
+    if (!LoadCreatureStats(options.StatsPath, stats))
+    {
+        std::fprintf(stderr, "%s: cannot read creature stats\n", options.StatsPath.c_str());
+        return 1;
+    }
+    EstimatorProgram program = LoadProgram(config);
+
+    // Every creature a requested level can meet needs stats at that level.
+    bool missing = false;
+    std::set<uint64> reported;
+    for (uint32 level : options.Levels)
+    {
+        const EstimatorBand* band = program.FindBand(level);
+        if (!band)
+        {
+            std::fprintf(stderr, "error: level %u is not covered by LevelBands\n", level);
+            missing = true;
+            continue;
+        }
+        for (const EstimatorWave& wave : program.Waves)
+        {
+            if (band->Pools[wave.PoolTier].empty() || !wave.SpawnPositions)
+            {
+                std::fprintf(stderr, "error: the %s pool or the spawn layout is empty, so a wave cannot spawn at level %u\n", TierNames[wave.PoolTier], level);
+                missing = true;
+            }
+            for (const std::vector<uint32>& groupEntries : band->Pools[wave.PoolTier])
+                for (uint32 entry : groupEntries)
+                    if (!stats.count(StatsKey(entry, level)) && reported.insert(StatsKey(entry, level)).second)
+                    {
+                        std::fprintf(stderr, "error: no stats for creature %u at level %u\n", entry, level);
+                        missing = true;
+                    }
+        }
+    }
+    if (missing)
+        return 1;
+
+    if (!options.Threads)
+        options.Threads = std::max(1u, std::thread::hardware_concurrency());
+    options.Threads = uint32(std::min<uint64>(options.Threads, std::max<uint64>(1, options.Trials)));
+
+    std::string groupText;
+    for (EstimatorRole role : options.Group)
+        groupText += std::string(groupText.empty() ? "" : ",") + (role == ROLE_TANK ? "tank" : role == ROLE_HEALER ? "healer" : "dps");
+
+    auto started = std::chrono::steady_clock::now();
+    for (uint32 level : options.Levels)
+    {
+        std::vector<LevelStats> threadStats(options.Threads, LevelStats(program.Waves.size()));
+        std::vector<std::thread> threads;
+        for (uint32 t = 0; t < options.Threads; ++t)
+        {
+            uint64 count = options.Trials / options.Threads + (t < options.Trials % options.Threads ? 1 : 0);
+            threads.emplace_back([&, t, count]()
+            {
+                std::mt19937 rng(uint32(options.Seed * 2654435761u + level * 40503u + t));
+                for (uint64 i = 0; i < count; ++i)
+                    RunTrial(options, program, stats, level, rng, threadStats[t]);
+            });
+        }
+        for (std::thread& thread : threads)
+            thread.join();
+
+        LevelStats total(program.Waves.size());
+        for (LevelStats& partial : threadStats)
+            total.Merge(partial);
+        double trials = double(std::max<uint64>(1, total.Trials));
+
+        std::printf("Level %u, group %s, %llu trials\n", level, groupText.c_str(), (unsigned long long)total.Trials);
+        std::printf("  Clear rate %.1f%%, wiped %.1f%%, stalled %.1f%%, %.2f perma-deaths per trial\n",
+            100.0 * total.Cleared / trials, 100.0 * total.Wiped / trials, 100.0 * total.Stalled / trials, total.PermaDeaths / trials);
+        std::printf("  %-5s %-7s %9s %9s %10s %10s\n", "Wave", "Pool", "Reached", "Cleared", "TTK p50", "TTK p90");
+        for (size_t i = 0; i < program.Waves.size(); ++i)
+        {
+            double reached = double(std::max<uint64>(1, total.WaveReached[i]));
+            char p50[16] = "-", p90[16] = "-";
+            if (!total.WaveSeconds[i].empty())
+            {
+                std::snprintf(p50, sizeof(p50), "%.0f s", Percentile(total.WaveSeconds[i], 0.5));
+                std::snprintf(p90, sizeof(p90), "%.0f s", Percentile(total.WaveSeconds[i], 0.9));
+            }
+            std::printf("  %-5zu %-7s %8.1f%% %8.1f%% %10s %10s\n", i + 1, TierNames[program.Waves[i].PoolTier],
+                100.0 * total.WaveReached[i] / trials, 100.0 * total.WaveCleared[i] / reached, p50, p90);
+        }
+        double occupancySum = 0.0;
+        for (float seconds : total.OccupancySeconds)
+            occupancySum += seconds;
+        std::printf("  Instance occupancy: mean %.1f min, p90 %.1f min; 100 trials hold %.1f instance-hours\n\n",
+            occupancySum / trials / 60.0, Percentile(total.OccupancySeconds, 0.9) / 60.0, occupancySum / trials * 100.0 / 3600.0);
+    }
+    std::printf("%llu trials per level on %u threads in %.2f s\n", (unsigned long long)options.Trials, options.Threads,
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count());
+    return 0;
+}
@@ -0,0 +1,1215 @@
+/*
+ * Offline analytics for exported Trial of Finality event logs (the `trial_of_finality_log` table).
+ *
+ * Usage: trial_log_analytics [--format ndjson|csv|sql] [--threads N] [--bands 1-59,60-69,70-79,80] <file>...
+ *
+ * Accepted inputs, detected from the extension or the first line unless --format is given:
+ *   ndjson  one flat object per line, keyed by the table's column names
+ *   csv     comma or tab separated with a header row; mysql -B output is read as is
+ *   sql     a mysqldump of the table; INSERT lines for other tables are skipped
+ *
+ * The production database is never touched. Files are memory-mapped and cut into chunks at line
+ * boundaries; every core parses chunks into compact events and shards them by group, then each shard
+ * rebuilds its groups' trials and aggregates them. It prints the start-to-clear funnel, failures and
+ * downs per wave, death-to-resurrect latency, forfeit and boundary-fail rates, and a level band
+ * breakdown.
+ *
+ * A trial is a group's events from TRIAL_START to TRIAL_SUCCESS, TRIAL_FAILURE or FORFEIT_VOTE_SUCCESS,
+ * in log_id order (file order without one). Events without a group (stress tests, GM commands, stray
+ * tokens) are counted and skipped. Records must be one per line; mysql -B and mysqldump escape the
+ * newlines inside values, so their exports always are.
+ */
+
+#include "trial_config_parsing.h"
+#include "trial_event_log.h"
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TRIAL_LOG_MMAP 1
+#endif
+
+using namespace ModTrialOfFinality;
+
+// --- Input Files ---
+// A whole input file, memory-mapped where the platform allows and read into memory otherwise.
+class MappedFile
+{
+public:
+    MappedFile() { }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile()
+    {
+#ifdef TRIAL_LOG_MMAP
+        if (_mapped)
+            munmap(const_cast<char*>(_data), _size);
+#endif
+    }
+
+    bool Open(const std::string& path)
+    {
+#ifdef TRIAL_LOG_MMAP
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+        {
+            close(fd);
+            return false;
+        }
+        _size = size_t(st.st_size);
+        if (_size)
+        {
+            void* data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED)
+            {
+                close(fd);
+                return false;
+            }
+            // Every byte is read once, front to back within each chunk.
+            madvise(data, _size, MADV_SEQUENTIAL);
+            _data = static_cast<const char*>(data);
+            _mapped = true;
+        }
+        close(fd);
+        return true;
+#else
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            return false;
+        _buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        _data = _buffer.data();
+        _size = _buffer.size();
+        return true;
+#endif
+    }
+
+    std::string_view View() const { return std::string_view(_data, _size); }
+
+private:
+    const char* _data = nullptr;
+    size_t _size = 0;
+    bool _mapped = false;
+    std::string _buffer;
+};
+
+// --- Columns ---
+enum LogColumn : uint8
+{
+    COL_LOG_ID = 0,
+    COL_TIME,
+    COL_TYPE,
+    COL_GROUP,
+    COL_PLAYER,
+    COL_NAME,
+    COL_ACCOUNT,
+    COL_LEVEL,
+    COL_WAVE,
+    COL_DETAILS,
+    COL_COUNT,
+    COL_IGNORED = COL_COUNT
+};
+
+typedef std::vector<LogColumn> ColumnLayout;
+
+// The table's column order (data/sql/..._tof_log_table.sql), for dumps and CSV files that name none.
+static const ColumnLayout TableLayout =
+{
+    COL_LOG_ID, COL_TIME, COL_TYPE, COL_GROUP, COL_PLAYER, COL_NAME, COL_ACCOUNT, COL_LEVEL, COL_WAVE, COL_DETAILS
+};
+
+static std::string_view Unquote(std::string_view name)
+{
+    while (!name.empty() && (name.front() == '`' || name.front() == '"' || name.front() == ' '))
+        name.remove_prefix(1);
+    while (!name.empty() && (name.back() == '`' || name.back() == '"' || name.back() == ' ' || name.back() == '\r'))
+        name.remove_suffix(1);
+    return name;
+}
+
+// event_id and event_time are accepted as well, the names older documentation used.
+static LogColumn ColumnByName(std::string_view name)
+{
+    static const struct { const char* Name; LogColumn Column; } names[] =
+    {
+        { "log_id", COL_LOG_ID }, { "event_id", COL_LOG_ID }, { "event_timestamp", COL_TIME }, { "event_time", COL_TIME },
+        { "event_type", COL_TYPE }, { "group_id", COL_GROUP }, { "player_guid", COL_PLAYER }, { "player_name", COL_NAME },
+        { "player_account_id", COL_ACCOUNT }, { "highest_level_in_group", COL_LEVEL }, { "wave_number", COL_WAVE },
+        { "details", COL_DETAILS }
+    };
+    name = Unquote(name);
+    for (const auto& entry : names)
+        if (name == entry.Name)
+            return entry.Column;
+    return COL_IGNORED;
+}
+
+// The raw text of one record's columns. Absent and NULL columns are not Present.
+struct RawRow
+{
+    std::string_view Value[COL_COUNT];
+    bool Present[COL_COUNT] = {};
+
+    void Clear() { std::fill(std::begin(Present), std::end(Present), false); }
+    void Set(LogColumn column, std::string_view value)
+    {
+        if (column < COL_COUNT)
+        {
+            Value[column] = value;
+            Present[column] = true;
+        }
+    }
+};
+
+// --- Events ---
+enum EventDetail : uint8
+{
+    DETAIL_NONE = 0,
+    DETAIL_RECOVERED,       // TRIAL_START written when a trial resumes after a restart
+    DETAIL_WIPE             // TRIAL_FAILURE because every member was downed
+};
+
+// One log row, reduced to what the aggregation needs; 24 bytes, so tens of millions fit in memory.
+struct LogEvent
+{
+    uint64 Seq;             // log_id, or the row's position in the input
+    uint32 Time;            // Unix seconds, 0 if unknown
+    uint32 Group;
+    uint32 Player;
+    uint8 Type;
+    uint8 Level;
+    uint8 Wave;
+    uint8 Detail;
+};
+
+struct ParseStats
+{
+    uint64 Rows = 0;
+    uint64 Malformed = 0;
+    uint64 UnknownType = 0;
+    uint64 NoGroup = 0;
+
+    void Merge(const ParseStats& other)
+    {
+        Rows += other.Rows;
+        Malformed += other.Malformed;
+        UnknownType += other.UnknownType;
+        NoGroup += other.NoGroup;
+    }
+};
+
+static int EventTypeByName(std::string_view name)
+{
+    static std::vector<std::string_view> names = []
+    {
+        std::vector<std::string_view> list;
+        for (int type = 0; type < TRIAL_EVENT_TYPE_COUNT; ++type)
+            list.push_back(TrialEventTypeName(TrialEventType(type)));
+        return list;
+    }();
+    name = Unquote(name);
+    for (size_t type = 0; type < names.size(); ++type)
+        if (name == names[type])
+            return int(type);
+    return -1;
+}
+
+template<typename T>
+static bool ReadNumber(std::string_view text, T& value)
+{
+    const char* last = text.data() + text.size();
+    std::from_chars_result result = std::from_chars(text.data(), last, value);
+    return result.ec == std::errc() && result.ptr == last;
+}
+
+// "YYYY-MM-DD HH:MM:SS" (or with a 'T', fractions and zone ignored) read as UTC, or plain Unix seconds.
+// Only differences between timestamps are used, so the server's time zone does not matter.
+static bool ParseTimestamp(std::string_view text, uint32& out)
+{
+    if (ReadNumber(text, out))
+        return true;
+    if (text.size() < 19)
+        return false;
+
+    auto digits = [&text](size_t at, size_t count, int& value)
+    {
+        value = 0;
+        for (size_t i = at; i < at + count; ++i)
+        {
+            if (text[i] < '0' || text[i] > '9')
+                return false;
+            value = value * 10 + (text[i] - '0');
+        }
+        return true;
+    };
+    int year, month, day, hour, minute, second;
+    if (!digits(0, 4, year) || text[4] != '-' || !digits(5, 2, month) || text[7] != '-' || !digits(8, 2, day) ||
+        (text[10] != ' ' && text[10] != 'T') || !digits(11, 2, hour) || text[13] != ':' || !digits(14, 2, minute) ||
+        text[16] != ':' || !digits(17, 2, second) || month < 1 || month > 12)
+        return false;
+
+    // Days since 1970-01-01 of a proleptic Gregorian date.
+    year -= month <= 2;
+    int64 era = (year >= 0 ? year : year - 399) / 400;
+    int64 yearOfEra = year - era * 400;
+    int64 dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int64 dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    int64 seconds = (era * 146097 + dayOfEra - 719468) * 86400 + hour * 3600 + minute * 60 + second;
+    if (seconds < 0 || seconds > int64(UINT32_MAX))
+        return false;
+    out = uint32(seconds);
+    return true;
+}
+
+static bool StartsWith(std::string_view text, std::string_view prefix)
+{
+    return text.substr(0, prefix.size()) == prefix;
+}
+
+// The details texts the module writes (FinalizeTrialOutcome, StartTrial) that change how a row counts.
+static uint8 ClassifyDetail(uint8 type, std::string_view details)
+{
+    details = Unquote(details);
+    if (type == TRIAL_EVENT_START && StartsWith(details, "Trial recovered after a restart"))
+        return DETAIL_RECOVERED;
+    if (type == TRIAL_EVENT_TRIAL_FAILURE && StartsWith(details, "All players were defeated"))
+        return DETAIL_WIPE;
+    return DETAIL_NONE;
+}
+
+static void AddRow(const RawRow& row, uint64 fallbackSeq, ParseStats& stats, std::vector<LogEvent>& events)
+{
+    ++stats.Rows;
+    if (!row.Present[COL_TYPE])
+    {
+        ++stats.Malformed;
+        return;
+    }
+    int type = EventTypeByName(row.Value[COL_TYPE]);
+    if (type < 0)
+    {
+        ++stats.UnknownType;
+        return;
+    }
+
+    LogEvent event = {};
+    event.Type = uint8(type);
+    if (row.Present[COL_GROUP] && !ReadNumber(Unquote(row.Value[COL_GROUP]), event.Group))
+    {
+        ++stats.Malformed;
+        return;
+    }
+    if (!event.Group)
+    {
+        ++stats.NoGroup;
+        return;
+    }
+
+    uint64 logId = 0;
+    event.Seq = row.Present[COL_LOG_ID] && ReadNumber(Unquote(row.Value[COL_LOG_ID]), logId) ? logId : fallbackSeq;
+    if (row.Present[COL_TIME])
+        ParseTimestamp(Unquote(row.Value[COL_TIME]), event.Time);
+    if (row.Present[COL_PLAYER])
+        ReadNumber(Unquote(row.Value[COL_PLAYER]), event.Player);
+    uint32 value = 0;
+    if (row.Present[COL_LEVEL] && ReadNumber(Unquote(row.Value[COL_LEVEL]), value))
+        event.Level = uint8(std::min<uint32>(value, 255));
+    value = 0;
+    if (row.Present[COL_WAVE] && ReadNumber(Unquote(row.Value[COL_WAVE]), value))
+        event.Wave = uint8(std::min<uint32>(value, 255));
+    if (row.Present[COL_DETAILS])
+        event.Detail = ClassifyDetail(event.Type, row.Value[COL_DETAILS]);
+    events.push_back(event);
+}
+
+// --- NDJSON ---
+// Skips a string at i, leaving i after its closing quote; escapes are stepped over, not decoded.
+static bool ReadJsonString(std::string_view text, size_t& i, std::string_view& out)
+{
+    if (i >= text.size() || text[i] != '"')
+        return false;
+    size_t start = ++i;
+    while (i < text.size() && text[i] != '"')
+        i += text[i] == '\\' ? 2 : 1;
+    if (i >= text.size())
+        return false;
+    out = text.substr(start, i - start);
+    ++i;
+    return true;
+}
+
+// Lines of one export list their keys in the same order, so each key is compared with the one seen at
+// the same place on the previous line before it is looked up.
+class JsonKeyCache
+{
+public:
+    LogColumn Lookup(size_t index, std::string_view key)
+    {
+        if (index < _keys.size() && _keys[index].first == key)
+            return _keys[index].second;
+        LogColumn column = ColumnByName(key);
+        if (index >= _keys.size())
+            _keys.resize(index + 1);
+        _keys[index] = { std::string(key), column };
+        return column;
+    }
+
+private:
+    std::vector<std::pair<std::string, LogColumn>> _keys;
+};
+
+static bool ParseJsonLine(std::string_view line, JsonKeyCache& keys, RawRow& row)
+{
+    size_t i = 0;
+    auto skipSpace = [&]() { while (i < line.size() && (line[i] == ' ' || line[i] == '\t')) ++i; };
+
+    skipSpace();
+    if (i >= line.size() || line[i] != '{')
+        return false;
+    ++i;
+    skipSpace();
+    if (i < line.size() && line[i] == '}')
+        return true;
+
+    for (size_t index = 0; ; ++index)
+    {
+        std::string_view key, value;
+        skipSpace();
+        if (!ReadJsonString(line, i, key))
+            return false;
+        skipSpace();
+        if (i >= line.size() || line[i] != ':')
+            return false;
+        ++i;
+        skipSpace();
+
+        bool isNull = false;
+        if (i < line.size() && line[i] == '"')
+        {
+            if (!ReadJsonString(line, i, value))
+                return false;
+        }
+        else
+        {
+            size_t start = i;
+            while (i < line.size() && line[i] != ',' && line[i] != '}' && line[i] != ' ' && line[i] != '\t')
+                ++i;
+            value = line.substr(start, i - start);
+            if (value.empty() || value.front() == '{' || value.front() == '[')
+                return false; // Nested values are not part of the export
+            isNull = value == "null";
+        }
+        if (!isNull)
+            row.Set(keys.Lookup(index, key), value);
+
+        skipSpace();
+        if (i >= line.size())
+            return false;
+        if (line[i] == '}')
+            return true;
+        if (line[i] != ',')
+            return false;
+        ++i;
+    }
+}
+
+// --- CSV ---
+struct CsvDialect
+{
+    char Delimiter = ',';
+    bool BackslashEscapes = false;  // mysql -B: tab separated, special characters escaped with '\'
+};
+
+static void SplitCsvLine(std::string_view line, const CsvDialect& dialect, std::vector<std::string_view>& fields)
+{
+    fields.clear();
+    size_t i = 0;
+    for (;;)
+    {
+        if (i < line.size() && line[i] == '"')
+        {
+            // Quoted field; a doubled quote is a literal one and stays in the raw value.
+            size_t start = ++i;
+            while (i < line.size() && !(line[i] == '"' && (i + 1 >= line.size() || line[i + 1] != '"')))
+                i += line[i] == '"' ? 2 : 1;
+            fields.push_back(line.substr(start, std::min(i, line.size()) - start));
+            while (i < line.size() && line[i] != dialect.Delimiter)
+                ++i;
+        }
+        else
+        {
+            size_t start = i;
+            while (i < line.size() && line[i] != dialect.Delimiter)
+                i += dialect.BackslashEscapes && line[i] == '\\' ? 2 : 1;
+            i = std::min(i, line.size());
+            fields.push_back(line.substr(start, i - start));
+        }
+        if (i >= line.size())
+            return;
+        ++i;
+    }
+}
+
+static bool IsCsvNull(std::string_view value)
+{
+    return value.empty() || value == "NULL" || value == "\\N";
+}
+
+// --- mysqldump ---
+static const std::string_view LogTableName = "trial_of_finality_log";
+
+// Reads one SQL value at i: NULL, a number, or a quoted string (with '\' escapes and doubled quotes).
+static bool ReadSqlValue(std::string_view line, size_t& i, std::string_view& value, bool& isNull)
+{
+    isNull = false;
+    if (i < line.size() && line[i] == '\'')
+    {
+        size_t start = ++i;
+        while (i < line.size())
+        {
+            if (line[i] == '\\')
+                i += 2;
+            else if (line[i] == '\'' && i + 1 < line.size() && line[i + 1] == '\'')
+                i += 2;
+            else if (line[i] == '\'')
+                break;
+            else
+                ++i;
+        }
+        if (i >= line.size())
+            return false;
+        value = line.substr(start, i - start);
+        ++i;
+        return true;
+    }
+    size_t start = i;
+    while (i < line.size() && line[i] != ',' && line[i] != ')')
+        ++i;
+    value = line.substr(start, i - start);
+    isNull = value == "NULL";
+    return !value.empty();
+}
+
+// One INSERT line of a dump: INSERT INTO `trial_of_finality_log` [(`col`, ...)] VALUES (...),(...);
+// Returns false for lines that are not inserts into the log table.
+template<typename RowCallback>
+static bool ParseSqlInsertLine(std::string_view line, ParseStats& stats, RawRow& row, const RowCallback& onRow)
+{
+    if (!StartsWith(line, "INSERT INTO "))
+        return false;
+    size_t i = 12;
+    size_t nameEnd = line.find_first_of(" (", i);
+    if (nameEnd == std::string_view::npos || Unquote(line.substr(i, nameEnd - i)) != LogTableName)
+        return false;
+    i = nameEnd;
+
+    ColumnLayout layout = TableLayout;
+    size_t values = line.find("VALUES", i);
+    if (values == std::string_view::npos)
+        return false;
+    size_t columnsStart = line.find('(', i);
+    if (columnsStart < values)
+    {
+        // --complete-insert dumps name their columns.
+        layout.clear();
+        std::string_view columns = line.substr(columnsStart + 1, line.find(')', columnsStart) - columnsStart - 1);
+        for (size_t start = 0; start <= columns.size(); )
+        {
+            size_t end = std::min(columns.find(',', start), columns.size());
+            layout.push_back(ColumnByName(columns.substr(start, end - start)));
+            start = end + 1;
+        }
+    }
+    i = values + 6;
+
+    for (;;)
+    {
+        while (i < line.size() && (line[i] == ' ' || line[i] == ','))
+            ++i;
+        if (i >= line.size() || line[i] != '(')
+            return true; // ';' or the end of the line
+        ++i;
+
+        row.Clear();
+        bool valid = true;
+        for (size_t column = 0; ; ++column)
+        {
+            std::string_view value;
+            bool isNull = false;
+            if (!ReadSqlValue(line, i, value, isNull))
+            {
+                valid = false;
+                break;
+            }
+            if (!isNull && column < layout.size())
+                row.Set(layout[column], value);
+            if (i < line.size() && line[i] == ',')
+            {
+                ++i;
+                continue;
+            }
+            break;
+        }
+        if (!valid || i >= line.size() || line[i] != ')')
+        {
+            // The rest of the statement cannot be trusted once a tuple is broken.
+            ++stats.Rows;
+            ++stats.Malformed;
+            return true;
+        }
+        ++i;
+        onRow(row);
+    }
+}
+
+// --- Parsing ---
+enum LogFormat : uint8
+{
+    FORMAT_AUTO = 0,
+    FORMAT_NDJSON,
+    FORMAT_CSV,
+    FORMAT_SQL
+};
+
+static const char* const LogFormatNames[] = { "auto", "ndjson", "csv", "sql" };
+
+struct InputFile
+{
+    std::string Path;
+    MappedFile File;
+    LogFormat Format = FORMAT_AUTO;
+    size_t DataStart = 0;           // After the CSV header
+    ColumnLayout Layout;            // CSV
+    CsvDialect Dialect;             // CSV
+};
+
+static bool EndsWith(const std::string& text, const char* suffix)
+{
+    size_t length = std::strlen(suffix);
+    return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+static std::string_view FirstLine(std::string_view data)
+{
+    return data.substr(0, std::min(data.find('\n'), data.size()));
+}
+
+// Picks the format and, for CSV, reads the header on the main thread before any chunk is parsed.
+static void PrepareInput(InputFile& input, LogFormat forced)
+{
+    std::string_view data = input.File.View();
+    std::string_view first = FirstLine(data);
+    size_t firstChar = first.find_first_not_of(" \t\r");
+
+    input.Format = forced;
+    if (input.Format == FORMAT_AUTO)
+    {
+        if (EndsWith(input.Path, ".ndjson") || EndsWith(input.Path, ".jsonl") || EndsWith(input.Path, ".json"))
+            input.Format = FORMAT_NDJSON;
+        else if (EndsWith(input.Path, ".csv") || EndsWith(input.Path, ".tsv"))
+            input.Format = FORMAT_CSV;
+        else if (EndsWith(input.Path, ".sql"))
+            input.Format = FORMAT_SQL;
+        else if (firstChar != std::string_view::npos && first[firstChar] == '{')
+            input.Format = FORMAT_NDJSON;
+        else if (StartsWith(first, "--") || StartsWith(first, "/*") || StartsWith(first, "INSERT") || StartsWith(first, "CREATE"))
+            input.Format = FORMAT_SQL;
+        else
+            input.Format = FORMAT_CSV;
+    }
+    if (input.Format != FORMAT_CSV)
+        return;
+
+    input.Dialect.Delimiter = first.find('\t') != std::string_view::npos ? '\t' : ',';
+    input.Dialect.BackslashEscapes = input.Dialect.Delimiter == '\t';
+    std::vector<std::string_view> fields;
+    SplitCsvLine(first, input.Dialect, fields);
+    uint64 number = 0;
+    if (!fields.empty() && ReadNumber(Unquote(fields[0]), number))
+    {
+        input.Layout = TableLayout; // No header: SELECT * INTO OUTFILE order
+        return;
+    }
+    for (std::string_view field : fields)
+        input.Layout.push_back(ColumnByName(field));
+    input.DataStart = std::min(first.size() + 1, data.size());
+}
+
+static uint32 ShardOf(uint32 group, uint32 shards)
+{
+    return uint32((uint64(group) * 2654435761u) >> 7) % shards;
+}
+
+struct Chunk
+{
+    uint32 FileIndex = 0;
+    size_t Begin = 0;
+    size_t End = 0;
+    ParseStats Stats;
+    std::vector<std::vector<LogEvent>> Shards;
+};
+
+static void ParseChunk(const InputFile& input, Chunk& chunk, uint32 shards)
+{
+    std::string_view data = input.File.View();
+    std::vector<LogEvent> events;
+    events.reserve((chunk.End - chunk.Begin) / 96);
+    RawRow row;
+    JsonKeyCache keys;
+    std::vector<std::string_view> fields;
+
+    for (size_t pos = chunk.Begin; pos < chunk.End; )
+    {
+        size_t eol = std::min(data.find('\n', pos), data.size());
+        std::string_view line = data.substr(pos, eol - pos);
+        // Rows without a log_id are ordered by where they are in the input.
+        uint64 fallbackSeq = (uint64(chunk.FileIndex) << 44) | pos;
+        pos = eol + 1;
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        if (line.find_first_not_of(" \t") == std::string_view::npos)
+            continue;
+
+        switch (input.Format)
+        {
+            case FORMAT_NDJSON:
+                row.Clear();
+                if (ParseJsonLine(line, keys, row))
+                    AddRow(row, fallbackSeq, chunk.Stats, events);
+                else
+                {
+                    ++chunk.Stats.Rows;
+                    ++chunk.Stats.Malformed;
+                }
+                break;
+            case FORMAT_CSV:
+                row.Clear();
+                SplitCsvLine(line, input.Dialect, fields);
+                for (size_t i = 0; i < fields.size() && i < input.Layout.size(); ++i)
+                    if (!IsCsvNull(fields[i]))
+                        row.Set(input.Layout[i], fields[i]);
+                AddRow(row, fallbackSeq, chunk.Stats, events);
+                break;
+            default:
+            {
+                uint64 tuple = 0;
+                ParseSqlInsertLine(line, chunk.Stats, row, [&](const RawRow& parsed)
+                {
+                    AddRow(parsed, fallbackSeq + tuple++, chunk.Stats, events);
+                });
+                break;
+            }
+        }
+    }
+
+    chunk.Shards.assign(shards, {});
+    for (const LogEvent& event : events)
+        chunk.Shards[ShardOf(event.Group, shards)].push_back(event);
+}
+
+// --- Aggregation ---
+// Whole seconds from 0 to six hours; anything longer lands in the last bucket.
+class SecondsHistogram
+{
+public:
+    static constexpr uint32 MAX_SECONDS = 6 * 3600;
+
+    SecondsHistogram() : _buckets(MAX_SECONDS + 1, 0) { }
+
+    void Record(uint32 seconds)
+    {
+        ++_buckets[std::min(seconds, MAX_SECONDS)];
+        ++_count;
+    }
+
+    void Merge(const SecondsHistogram& other)
+    {
+        for (size_t i = 0; i < _buckets.size(); ++i)
+            _buckets[i] += other._buckets[i];
+        _count += other._count;
+    }
+
+    uint64 Count() const { return _count; }
+
+    uint32 Percentile(double percent) const
+    {
+        if (!_count)
+            return 0;
+        uint64 rank = std::max<uint64>(1, uint64(percent / 100.0 * double(_count) + 0.5));
+        uint64 seen = 0;
+        for (size_t i = 0; i < _buckets.size(); ++i)
+        {
+            seen += _buckets[i];
+            if (seen >= rank)
+                return uint32(i);
+        }
+        return MAX_SECONDS;
+    }
+
+private:
+    std::vector<uint64> _buckets;
+    uint64 _count = 0;
+};
+
+enum TrialEnd : uint8
+{
+    END_CLEARED = 0,
+    END_WIPED,
+    END_BOUNDARY,
+    END_FORFEITED,
+    END_OTHER_FAILURE,
+    END_UNFINISHED,
+    END_COUNT
+};
+
+struct WaveStats
+{
+    uint64 Reached = 0;
+    uint64 Ends[END_COUNT] = {};    // Trials that ended during this wave, by how
+    uint64 Downs = 0;
+    uint64 Resurrects = 0;
+    SecondsHistogram RezLatency;
+};
+
+struct BandStats
+{
+    uint64 Trials = 0;
+    uint64 Ends[END_COUNT] = {};
+    uint64 WavesReached = 0;
+    uint64 PermaDeaths = 0;
+};
+
+struct TrialStats
+{
+    uint64 Trials = 0;
+    uint64 Recovered = 0;
+    uint64 Ends[END_COUNT] = {};
+    uint64 PermaDeaths = 0;
+    uint64 OrphanEvents = 0;        // Player events of a group with no open trial
+    std::vector<WaveStats> Waves;
+    std::vector<BandStats> Bands;   // Configured bands, then one for levels outside them
+    SecondsHistogram ClearDuration;
+    SecondsHistogram FailDuration;
+
+    WaveStats& Wave(uint32 wave)
+    {
+        wave = std::max<uint32>(wave, 1);
+        if (Waves.size() < wave)
+            Waves.resize(wave);
+        return Waves[wave - 1];
+    }
+
+    void Merge(const TrialStats& other)
+    {
+        Trials += other.Trials;
+        Recovered += other.Recovered;
+        PermaDeaths += other.PermaDeaths;
+        OrphanEvents += other.OrphanEvents;
+        for (int end = 0; end < END_COUNT; ++end)
+            Ends[end] += other.Ends[end];
+        for (size_t i = 0; i < other.Waves.size(); ++i)
+        {
+            WaveStats& wave = Wave(uint32(i + 1));
+            wave.Reached += other.Waves[i].Reached;
+            wave.Downs += other.Waves[i].Downs;
+            wave.Resurrects += other.Waves[i].Resurrects;
+            for (int end = 0; end < END_COUNT; ++end)
+                wave.Ends[end] += other.Waves[i].Ends[end];
+            wave.RezLatency.Merge(other.Waves[i].RezLatency);
+        }
+        for (size_t i = 0; i < other.Bands.size(); ++i)
+        {
+            Bands[i].Trials += other.Bands[i].Trials;
+            Bands[i].WavesReached += other.Bands[i].WavesReached;
+            Bands[i].PermaDeaths += other.Bands[i].PermaDeaths;
+            for (int end = 0; end < END_COUNT; ++end)
+                Bands[i].Ends[end] += other.Bands[i].Ends[end];
+        }
+        ClearDuration.Merge(other.ClearDuration);
+        FailDuration.Merge(other.FailDuration);
+    }
+};
+
+// Rebuilds the trials of one shard. Events arrive sorted by group, then by log order.
+class TrialReplay
+{
+public:
+    TrialReplay(TrialStats& stats, const std::vector<int>& levelToBand) : _stats(stats), _levelToBand(levelToBand) { }
+
+    void Run(const std::vector<LogEvent>& events)
+    {
+        uint32 group = 0;
+        for (const LogEvent& event : events)
+        {
+            if (event.Group != group)
+            {
+                Close(END_UNFINISHED, 0, 0);
+                group = event.Group;
+            }
+            Apply(event);
+        }
+        Close(END_UNFINISHED, 0, 0);
+    }
+
+private:
+    struct DownedMember
+    {
+        uint32 Player;
+        uint32 Time;
+        uint8 Wave;
+    };
+
+    void Apply(const LogEvent& event)
+    {
+        switch (event.Type)
+        {
+            case TRIAL_EVENT_START:
+                if (_open && event.Detail == DETAIL_RECOVERED)
+                {
+                    ++_stats.Recovered;
+                    return;
+                }
+                Close(END_UNFINISHED, 0, 0);
+                _open = true;
+                _startTime = event.Time;
+                _level = event.Level;
+                _maxWave = event.Wave; // A recovered trial starts at the wave before the one it resumes
+                _boundaryFail = false;
+                _permaDeaths = 0;
+                _downed.clear();
+                if (event.Detail == DETAIL_RECOVERED)
+                    ++_stats.Recovered;
+                return;
+            case TRIAL_EVENT_TRIAL_SUCCESS:
+                Close(END_CLEARED, event.Wave, event.Time);
+                return;
+            case TRIAL_EVENT_TRIAL_FAILURE:
+                Close(_boundaryFail ? END_BOUNDARY : event.Detail == DETAIL_WIPE ? END_WIPED : END_OTHER_FAILURE, event.Wave, event.Time);
+                return;
+            case TRIAL_EVENT_FORFEIT_VOTE_SUCCESS:
+                Close(END_FORFEITED, event.Wave, event.Time);
+                return;
+            default:
+                break;
+        }
+
+        if (!_open)
+        {
+            if (event.Type == TRIAL_EVENT_PLAYER_DEATH_TOKEN || event.Type == TRIAL_EVENT_PLAYER_RESURRECTED)
+                ++_stats.OrphanEvents;
+            return;
+        }
+
+        switch (event.Type)
+        {
+            case TRIAL_EVENT_WAVE_START:
+                _maxWave = std::max(_maxWave, event.Wave);
+                _downed.clear(); // Members still downed when a wave is cleared are raised for the next one
+                break;
+            case TRIAL_EVENT_PLAYER_DEATH_TOKEN:
+            {
+                ++_stats.Wave(event.Wave).Downs;
+                auto itr = std::find_if(_downed.begin(), _downed.end(), [&event](const DownedMember& member) { return member.Player == event.Player; });
+                if (itr == _downed.end())
+                    _downed.push_back({ event.Player, event.Time, event.Wave });
+                else
+                    *itr = { event.Player, event.Time, event.Wave };
+                break;
+            }
+            case TRIAL_EVENT_PLAYER_RESURRECTED:
+            {
+                auto itr = std::find_if(_downed.begin(), _downed.end(), [&event](const DownedMember& member) { return member.Player == event.Player; });
+                if (itr == _downed.end())
+                    break;
+                WaveStats& wave = _stats.Wave(itr->Wave);
+                ++wave.Resurrects;
+                if (itr->Time && event.Time >= itr->Time)
+                    wave.RezLatency.Record(event.Time - itr->Time);
+                _downed.erase(itr);
+                break;
+            }
+            case TRIAL_EVENT_PERMADEATH_APPLIED:
+                ++_permaDeaths;
+                break;
+            case TRIAL_EVENT_PLAYER_FORFEIT_ARENA:
+                _boundaryFail = true;
+                break;
+            default:
+                break;
+        }
+    }
+
+    void Close(TrialEnd end, uint8 wave, uint32 time)
+    {
+        if (!_open)
+            return;
+        _open = false;
+
+        uint32 lastWave = std::max<uint32>(_maxWave, wave);
+        ++_stats.Trials;
+        ++_stats.Ends[end];
+        _stats.PermaDeaths += _permaDeaths;
+        for (uint32 w = 1; w <= lastWave; ++w)
+            ++_stats.Wave(w).Reached;
+        if (end != END_CLEARED && end != END_UNFINISHED)
+            ++_stats.Wave(lastWave).Ends[end];
+
+        if (end != END_UNFINISHED && _startTime && time >= _startTime)
+            (end == END_CLEARED ? _stats.ClearDuration : _stats.FailDuration).Record(time - _startTime);
+
+        BandStats& band = _stats.Bands[_levelToBand[_level]];
+        ++band.Trials;
+        ++band.Ends[end];
+        band.WavesReached += lastWave;
+        band.PermaDeaths += _permaDeaths;
+    }
+
+    TrialStats& _stats;
+    const std::vector<int>& _levelToBand;
+    bool _open = false;
+    uint32 _startTime = 0;
+    uint8 _level = 0;
+    uint8 _maxWave = 0;
+    bool _boundaryFail = false;
+    uint32 _permaDeaths = 0;
+    std::vector<DownedMember> _downed;
+};
+
+// --- Report ---
+static double Percent(uint64 part, uint64 whole)
+{
+    return whole ? 100.0 * double(part) / double(whole) : 0.0;
+}
+
+static std::string FormatSeconds(uint32 seconds)
+{
+    char buffer[32];
+    if (seconds < 60)
+        std::snprintf(buffer, sizeof(buffer), "%us", seconds);
+    else if (seconds < 3600)
+        std::snprintf(buffer, sizeof(buffer), "%um%02us", seconds / 60, seconds % 60);
+    else
+        std::snprintf(buffer, sizeof(buffer), "%uh%02um", seconds / 3600, seconds / 60 % 60);
+    return buffer;
+}
+
+static std::string FormatLatency(const SecondsHistogram& histogram, double percent)
+{
+    return histogram.Count() ? FormatSeconds(histogram.Percentile(percent)) : "-";
+}
+
+static void PrintReport(const TrialStats& stats, const std::vector<TrialLevelRange>& bands)
+{
+    uint64 finished = stats.Trials - stats.Ends[END_UNFINISHED];
+    std::printf("\nTrials: %llu started (%llu resumed after a restart), %llu finished, %llu unfinished\n",
+        (unsigned long long)stats.Trials, (unsigned long long)stats.Recovered, (unsigned long long)finished,
+        (unsigned long long)stats.Ends[END_UNFINISHED]);
+    static const char* const endNames[END_UNFINISHED] = { "Cleared", "Wiped", "Boundary fail", "Forfeited", "Other failure" };
+    for (int end = 0; end < END_UNFINISHED; ++end)
+        std::printf("  %-14s %10llu  %5.1f%% of started  %5.1f%% of finished\n", endNames[end],
+            (unsigned long long)stats.Ends[end], Percent(stats.Ends[end], stats.Trials), Percent(stats.Ends[end], finished));
+    std::printf("  Perma-deaths   %10llu  %.2f per finished trial\n", (unsigned long long)stats.PermaDeaths,
+        finished ? double(stats.PermaDeaths) / double(finished) : 0.0);
+    std::printf("  Duration: cleared p50 %s, p90 %s; failed p50 %s, p90 %s\n",
+        FormatLatency(stats.ClearDuration, 50).c_str(), FormatLatency(stats.ClearDuration, 90).c_str(),
+        FormatLatency(stats.FailDuration, 50).c_str(), FormatLatency(stats.FailDuration, 90).c_str());
+    if (stats.OrphanEvents)
+        std::printf("  %llu downs or resurrections outside any trial (the export starts mid-trial?)\n", (unsigned long long)stats.OrphanEvents);
+
+    std::printf("\nFunnel and failures per wave (fail rate: trials that ended in the wave / trials that reached it)\n");
+    std::printf("  Wave     Reached  of start   Wiped  Boundary  Forfeit  Other  Fail rate     Downs  Rezzed  Rez p50  Rez p90  Rez p99\n");
+    for (size_t i = 0; i < stats.Waves.size(); ++i)
+    {
+        const WaveStats& wave = stats.Waves[i];
+        uint64 failed = wave.Ends[END_WIPED] + wave.Ends[END_BOUNDARY] + wave.Ends[END_FORFEITED] + wave.Ends[END_OTHER_FAILURE];
+        std::printf("  %-4zu %11llu  %7.1f%% %7llu %9llu %8llu %6llu  %8.1f%% %9llu  %5.1f%% %8s %8s %8s\n", i + 1,
+            (unsigned long long)wave.Reached, Percent(wave.Reached, stats.Trials),
+            (unsigned long long)wave.Ends[END_WIPED], (unsigned long long)wave.Ends[END_BOUNDARY],
+            (unsigned long long)wave.Ends[END_FORFEITED], (unsigned long long)wave.Ends[END_OTHER_FAILURE],
+            Percent(failed, wave.Reached), (unsigned long long)wave.Downs, Percent(wave.Resurrects, wave.Downs),
+            FormatLatency(wave.RezLatency, 50).c_str(), FormatLatency(wave.RezLatency, 90).c_str(), FormatLatency(wave.RezLatency, 99).c_str());
+    }
+
+    std::printf("\nLevel bands\n");
+    std::printf("  Band        Trials  Cleared    Wiped  Boundary  Forfeit  Mean waves  Perma-deaths\n");
+    for (size_t i = 0; i < stats.Bands.size(); ++i)
+    {
+        const BandStats& band = stats.Bands[i];
+        if (!band.Trials)
+            continue;
+        char name[16];
+        if (i < bands.size() && bands[i].MinLevel == bands[i].MaxLevel)
+            std::snprintf(name, sizeof(name), "%u", bands[i].MinLevel);
+        else if (i < bands.size())
+            std::snprintf(name, sizeof(name), "%u-%u", bands[i].MinLevel, bands[i].MaxLevel);
+        else
+            std::snprintf(name, sizeof(name), "other");
+        std::printf("  %-8s %9llu  %6.1f%%  %6.1f%%   %6.1f%%  %6.1f%%  %10.2f  %12llu\n", name, (unsigned long long)band.Trials,
+            Percent(band.Ends[END_CLEARED], band.Trials), Percent(band.Ends[END_WIPED], band.Trials),
+            Percent(band.Ends[END_BOUNDARY], band.Trials), Percent(band.Ends[END_FORFEITED], band.Trials),
+            double(band.WavesReached) / double(band.Trials), (unsigned long long)band.PermaDeaths);
+    }
+}
+
+// --- Main ---
+template<typename Work>
+static void RunOnThreads(uint32 threads, const Work& work)
+{
+    std::vector<std::thread> pool;
+    for (uint32 t = 0; t < threads; ++t)
+        pool.emplace_back([&work, t]() { work(t); });
+    for (std::thread& thread : pool)
+        thread.join();
+}
+
+int main(int argc, char** argv)
+{
+    LogFormat forced = FORMAT_AUTO;
+    uint32 threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string bandsText = "1-59,60-69,70-79,80";
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--format" && hasValue)
+        {
+            std::string name = argv[++i];
+            forced = name == "ndjson" ? FORMAT_NDJSON : name == "csv" ? FORMAT_CSV : name == "sql" ? FORMAT_SQL : FORMAT_AUTO;
+            if (forced == FORMAT_AUTO)
+            {
+                std::fprintf(stderr, "error: unknown format '%s'\n", name.c_str());
+                return 2;
+            }
+        }
+        else if (arg == "--threads" && hasValue)
+            threads = std::max(1u, uint32(std::strtoul(argv[++i], nullptr, 10)));
+        else if (arg == "--bands" && hasValue)
+            bandsText = argv[++i];
+        else if (!arg.empty() && arg[0] != '-')
+            paths.push_back(arg);
+        else
+            paths.clear(), i = argc;
+    }
+    if (paths.empty())
+    {
+        std::fprintf(stderr, "Usage: %s [--format ndjson|csv|sql] [--threads N] [--bands 1-59,60-69,70-79,80] <file>...\n", argv[0]);
+        return 2;
+    }
+
+    TrialParseReport bandsReport;
+    std::vector<TrialLevelRange> bands = ParseLevelBands(bandsText, 255, bandsReport);
+    for (const TrialParseMessage& message : bandsReport.Messages)
+        std::fprintf(stderr, "%s: %s\n", message.Error ? "error" : "warning", message.Text.c_str());
+    std::vector<int> levelToBand(256, int(bands.size()));
+    for (size_t i = 0; i < bands.size(); ++i)
+        for (uint32 level = bands[i].MinLevel; level <= bands[i].MaxLevel; ++level)
+            levelToBand[level] = int(i);
+
+    auto startedAt = std::chrono::steady_clock::now();
+    std::vector<std::unique_ptr<InputFile>> inputs;
+    uint64 totalBytes = 0;
+    for (const std::string& path : paths)
+    {
+        std::unique_ptr<InputFile> input = std::make_unique<InputFile>();
+        input->Path = path;
+        if (!input->File.Open(path))
+        {
+            std::fprintf(stderr, "error: cannot read %s\n", path.c_str());
+            return 1;
+        }
+        PrepareInput(*input, forced);
+        totalBytes += input->File.View().size();
+        inputs.push_back(std::move(input));
+    }
+
+    // Several chunks per thread even out lines of uneven length; each chunk starts on a line.
+    std::vector<Chunk> chunks;
+    for (uint32 f = 0; f < inputs.size(); ++f)
+    {
+        std::string_view data = inputs[f]->File.View();
+        size_t begin = inputs[f]->DataStart;
+        size_t pieces = std::max<size_t>(1, std::min<size_t>(threads * 4, (data.size() - begin) / (1 << 20) + 1));
+        for (size_t piece = 0; piece < pieces && begin < data.size(); ++piece)
+        {
+            size_t end = piece + 1 == pieces ? data.size() : begin + (data.size() - begin) / (pieces - piece);
+            end = std::min(data.find('\n', end), data.size());
+            end = end < data.size() ? end + 1 : end;
+            Chunk chunk;
+            chunk.FileIndex = f;
+            chunk.Begin = begin;
+            chunk.End = end;
+            chunks.push_back(std::move(chunk));
+            begin = end;
+        }
+    }
+
+    std::atomic<size_t> nextChunk{ 0 };
+    RunOnThreads(threads, [&](uint32)
+    {
+        for (size_t i = nextChunk++; i < chunks.size(); i = nextChunk++)
+            ParseChunk(*inputs[chunks[i].FileIndex], chunks[i], threads);
+    });
+    auto parsedAt = std::chrono::steady_clock::now();
+
+    std::vector<TrialStats> shardStats(threads);
+    RunOnThreads(threads, [&](uint32 shard)
+    {
+        std::vector<LogEvent> events;
+        size_t count = 0;
+        for (const Chunk& chunk : chunks)
+            count += chunk.Shards[shard].size();
+        events.reserve(count);
+        for (Chunk& chunk : chunks)
+        {
+            events.insert(events.end(), chunk.Shards[shard].begin(), chunk.Shards[shard].end());
+            std::vector<LogEvent>().swap(chunk.Shards[shard]);
+        }
+        std::sort(events.begin(), events.end(), [](const LogEvent& a, const LogEvent& b)
+        {
+            return a.Group != b.Group ? a.Group < b.Group : a.Seq < b.Seq;
+        });
+        shardStats[shard].Bands.resize(bands.size() + 1);
+        TrialReplay(shardStats[shard], levelToBand).Run(events);
+    });
+
+    TrialStats stats;
+    stats.Bands.resize(bands.size() + 1);
+    ParseStats parseStats;
+    for (const TrialStats& shard : shardStats)
+        stats.Merge(shard);
+    for (const Chunk& chunk : chunks)
+        parseStats.Merge(chunk.Stats);
+    auto doneAt = std::chrono::steady_clock::now();
+
+    double parseSeconds = std::chrono::duration<double>(parsedAt - startedAt).count();
+    double totalSeconds = std::chrono::duration<double>(doneAt - startedAt).count();
+    std::printf("%llu rows in %zu file(s) (%.1f MB, %s) parsed in %.2f s on %u threads (%.0f MB/s); %.2f s in total\n",
+        (unsigned long long)parseStats.Rows, inputs.size(), double(totalBytes) / (1024.0 * 1024.0),
+        inputs.size() == 1 ? LogFormatNames[inputs[0]->Format] : "mixed", parseSeconds, threads,
+        parseSeconds > 0.0 ? double(totalBytes) / (1024.0 * 1024.0) / parseSeconds : 0.0, totalSeconds);
+    std::printf("  %llu malformed, %llu of unknown event types, %llu without a group (stress tests, GM commands)\n",
+        (unsigned long long)parseStats.Malformed, (unsigned long long)parseStats.UnknownType, (unsigned long long)parseStats.NoGroup);
+
+    PrintReport(stats, bands);
+    return parseStats.Rows && parseStats.Malformed == parseStats.Rows ? 1 : 0;
+}
@@ -0,0 +1,246 @@
+/*
+ * Runs scripted Trial of Finality runs through the core library, without a worldserver.
+ *
+ * Usage: trial_simulator [--trials N] [--group-size N] [--waves N] [--seed N] [--threads N]
+ *                        [--down-chance P] [--resurrect-chance P] [--wander-chance P] [--forfeit-chance P]
+ *
+ * Each trial is a group walking around a circular arena, one step per simulated second, while members
+ * are downed, resurrected, disconnect, stray past the boundary and call forfeit votes at the given
+ * per-step chances. The outcome of every trial is decided by the same rules the module uses. Results
+ * depend only on the seed and the thread count.
+ */
+
+#include "trial_arena_boundary.h"
+#include "trial_rules.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ModTrialOfFinality;
+
+struct SimulatorOptions
+{
+    uint64 Trials = 100000;
+    uint32 GroupSize = 5;
+    uint32 Waves = 5;
+    uint64 Seed = 1;
+    uint32 Threads = 0;
+    double DownChance = 0.01;
+    double ResurrectChance = 0.03;
+    double DisconnectChance = 0.0005;
+    double ReconnectChance = 0.1;
+    double WanderChance = 0.0005;
+    double ForfeitChance = 0.00005;
+};
+
+struct SimulatorStats
+{
+    uint64 Trials = 0;
+    uint64 Steps = 0;
+    uint64 WavesReached = 0;
+    uint64 PermaFailed = 0;
+    uint64 Warnings = 0;
+    std::array<uint64, TRIAL_END_REASON_COUNT> Reasons = {};
+
+    void Merge(const SimulatorStats& other)
+    {
+        Trials += other.Trials;
+        Steps += other.Steps;
+        WavesReached += other.WavesReached;
+        PermaFailed += other.PermaFailed;
+        Warnings += other.Warnings;
+        for (size_t i = 0; i < Reasons.size(); ++i)
+            Reasons[i] += other.Reasons[i];
+    }
+};
+
+// Matches the module defaults: Arena.Radius 100, Boundary.Hysteresis 3, FailDistance 30, GridCellSize 8.
+static constexpr float ARENA_RADIUS = 100.0f;
+static constexpr uint32 WARNING_GRACE_MS = 5000;
+static constexpr uint32 RESUME_GRACE_STEPS = 60;
+static constexpr uint32 MIN_WAVE_STEPS = 20;
+static constexpr uint32 MAX_WAVE_STEPS = 60;
+
+struct SimMember
+{
+    float X = 0.0f;
+    float Y = 0.0f;
+    uint32 DisconnectedSteps = 0;
+};
+
+static void RunTrial(const SimulatorOptions& options, const TrialArenaBoundary& boundary, std::mt19937_64& rng, SimulatorStats& stats)
+{
+    std::uniform_real_distribution<double> roll(0.0, 1.0);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::uniform_int_distribution<uint32> waveSteps(MIN_WAVE_STEPS, MAX_WAVE_STEPS);
+
+    TrialRunState run(options.Waves, WARNING_GRACE_MS);
+    std::vector<SimMember> members(options.GroupSize);
+    for (uint32 i = 0; i < options.GroupSize; ++i)
+    {
+        run.AddParticipant(i + 1);
+        members[i].X = unit(rng) * ARENA_RADIUS * 0.5f;
+        members[i].Y = unit(rng) * ARENA_RADIUS * 0.5f;
+    }
+    run.Start();
+
+    int64 now = 0;
+    while (!run.IsOver())
+    {
+        uint32 steps = waveSteps(rng);
+        for (uint32 step = 0; step < steps && !run.IsOver(); ++step, ++now)
+        {
+            ++stats.Steps;
+            run.Update(now);
+            for (uint32 i = 0; i < options.GroupSize && !run.IsOver(); ++i)
+            {
+                uint32 id = i + 1;
+                SimMember& sim = members[i];
+                const TrialMemberStatus* status = run.GetMember(id);
+
+                if (status->Disconnected)
+                {
+                    if (roll(rng) < options.ReconnectChance)
+                        run.OnReconnected(id);
+                    else if (++sim.DisconnectedSteps >= RESUME_GRACE_STEPS)
+                        run.OnResumeExpired(id);
+                    continue;
+                }
+                if (!status->Alive)
+                {
+                    if (!status->PermaFailed && roll(rng) < options.ResurrectChance)
+                        run.OnResurrected(id);
+                    continue;
+                }
+                if (roll(rng) < options.DownChance)
+                {
+                    run.OnDowned(id);
+                    continue;
+                }
+                if (roll(rng) < options.DisconnectChance)
+                {
+                    sim.DisconnectedSteps = 0;
+                    run.OnDisconnected(id);
+                    continue;
+                }
+
+                // Random walk pulled towards the middle, with the occasional run for the exit.
+                if (roll(rng) < options.WanderChance)
+                {
+                    float angle = unit(rng) * 3.14159265f;
+                    float distance = ARENA_RADIUS * (1.05f + 0.4f * (unit(rng) + 1.0f) / 2.0f);
+                    sim.X = std::cos(angle) * distance;
+                    sim.Y = std::sin(angle) * distance;
+                }
+                else
+                {
+                    sim.X += unit(rng) * 6.0f - sim.X * 0.05f;
+                    sim.Y += unit(rng) * 6.0f - sim.Y * 0.05f;
+                }
+                TrialBoundaryAction action = run.OnBoundary(id, boundary.Classify(sim.X, sim.Y, 0.0f), uint32(now * 1000));
+                if (action == BOUNDARY_ACTION_WARN)
+                {
+                    ++stats.Warnings;
+                    sim.X *= 0.5f;  // A warned player heads back in
+                    sim.Y *= 0.5f;
+                }
+                if (run.IsOver())
+                    break;
+
+                if (roll(rng) < options.ForfeitChance)
+                {
+                    // Everyone who is able agrees with probability one half.
+                    run.OnForfeitVote(id, now);
+                    for (uint32 j = 1; j <= options.GroupSize && !run.IsOver(); ++j)
+                        if (j != id && roll(rng) < 0.5)
+                            run.OnForfeitVote(j, now);
+                }
+            }
+        }
+        if (!run.IsOver())
+            run.OnWaveCleared();
+    }
+
+    ++stats.Trials;
+    ++stats.Reasons[run.GetEndReason()];
+    stats.WavesReached += run.GetCurrentWave();
+    stats.PermaFailed += run.GetOutcome().PermaFailed.size();
+}
+
+static bool ParseOptions(int argc, char** argv, SimulatorOptions& options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (i + 1 >= argc)
+            return false;
+        const char* value = argv[++i];
+        if (arg == "--trials") options.Trials = std::strtoull(value, nullptr, 10);
+        else if (arg == "--group-size") options.GroupSize = uint32(std::strtoul(value, nullptr, 10));
+        else if (arg == "--waves") options.Waves = uint32(std::strtoul(value, nullptr, 10));
+        else if (arg == "--seed") options.Seed = std::strtoull(value, nullptr, 10);
+        else if (arg == "--threads") options.Threads = uint32(std::strtoul(value, nullptr, 10));
+        else if (arg == "--down-chance") options.DownChance = std::strtod(value, nullptr);
+        else if (arg == "--resurrect-chance") options.ResurrectChance = std::strtod(value, nullptr);
+        else if (arg == "--wander-chance") options.WanderChance = std::strtod(value, nullptr);
+        else if (arg == "--forfeit-chance") options.ForfeitChance = std::strtod(value, nullptr);
+        else return false;
+    }
+    return options.GroupSize > 0 && options.Waves > 0;
+}
+
+int main(int argc, char** argv)
+{
+    SimulatorOptions options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        std::fprintf(stderr, "Usage: %s [--trials N] [--group-size N] [--waves N] [--seed N] [--threads N]\n"
+            "       [--down-chance P] [--resurrect-chance P] [--wander-chance P] [--forfeit-chance P]\n", argv[0]);
+        return 2;
+    }
+    if (!options.Threads)
+        options.Threads = std::max(1u, std::thread::hardware_concurrency());
+    options.Threads = uint32(std::min<uint64>(options.Threads, std::max<uint64>(1, options.Trials)));
+
+    TrialArenaBoundary boundary;
+    boundary.AddCircle(0.0f, 0.0f, ARENA_RADIUS);
+    boundary.Compile(3.0f, 30.0f, 8.0f);
+
+    std::vector<SimulatorStats> threadStats(options.Threads);
+    std::vector<std::thread> threads;
+    auto started = std::chrono::steady_clock::now();
+    for (uint32 t = 0; t < options.Threads; ++t)
+    {
+        uint64 count = options.Trials / options.Threads + (t < options.Trials % options.Threads ? 1 : 0);
+        threads.emplace_back([&, t, count]()
+        {
+            std::mt19937_64 rng(options.Seed * 0x9E3779B97F4A7C15ULL + t);
+            for (uint64 i = 0; i < count; ++i)
+                RunTrial(options, boundary, rng, threadStats[t]);
+        });
+    }
+    for (std::thread& thread : threads)
+        thread.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+    SimulatorStats total;
+    for (const SimulatorStats& stats : threadStats)
+        total.Merge(stats);
+
+    double trials = double(std::max<uint64>(1, total.Trials));
+    std::printf("%llu trials of %u players and %u waves on %u threads in %.3f s (%.0f trials/s)\n",
+        (unsigned long long)total.Trials, options.GroupSize, options.Waves, options.Threads, seconds, total.Trials / std::max(seconds, 1e-9));
+    for (uint32 reason = TRIAL_END_ALL_WAVES_CLEARED; reason < TRIAL_END_REASON_COUNT; ++reason)
+        std::printf("  %-18s %10llu  %6.2f%%\n", TrialEndReasonNames[reason], (unsigned long long)total.Reasons[reason], 100.0 * total.Reasons[reason] / trials);
+    std::printf("Average wave reached %.2f, simulated %.1f min per trial, %.3f perma-deaths and %.3f boundary warnings per trial\n",
+        total.WavesReached / trials, total.Steps / trials / 60.0, total.PermaFailed / trials, total.Warnings / trials);
+    return 0;
+}